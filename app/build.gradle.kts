@@ -1,6 +1,9 @@
 import java.io.FileInputStream
 import java.io.FileOutputStream
+import java.util.jar.JarFile
+import java.util.zip.CRC32
 import java.util.zip.ZipEntry
+import java.util.zip.ZipFile
 import java.util.zip.ZipOutputStream
 
 plugins {
@@ -18,6 +21,56 @@ fun findCacioProjects(): List<File> {
     }?.toList() ?: emptyList()
 }
 
+/** 合并jar中所有条目的修改时间，与Gradle可重现归档使用的1980-02-01相同 */
+val STORED_JAR_ENTRY_TIME = java.util.GregorianCalendar(1980, java.util.Calendar.FEBRUARY, 1).timeInMillis
+
+/**
+ * 把多个jar合并为一个条目全部不压缩存储的jar
+ *
+ * 放在-Xbootclasspath/a上的jar每加载一个类都要inflate一次，且引导类加载器会按顺序在每个jar里查找；
+ * 合并并改为存储后只需一次查找，类文件直接从映射的数据中读取。重复的条目以先出现的为准，
+ * manifest取第一个jar的。
+ *
+ * 条目顺序不影响查找：JDK按中央目录建立哈希表定位条目。这里按路径排序并固定时间戳，
+ * 使内容不变时输出逐字节相同，运行库清单中的CRC不变，增量更新不会重新解压该jar；
+ * 同一个包的类也因此相邻，按包加载时读取的页更集中。没有按类加载顺序排列，因为顺序随应用而变
+ */
+fun writeStoredJar(jars: List<File>, target: File) {
+    val entries = sortedMapOf<String, ByteArray>()
+    var manifest: ByteArray? = null
+    for (jar in jars) {
+        ZipFile(jar).use { zip ->
+            for (entry in zip.entries()) {
+                if (entry.isDirectory) continue
+                val data = zip.getInputStream(entry).use { it.readBytes() }
+                if (entry.name == JarFile.MANIFEST_NAME) {
+                    if (manifest == null) manifest = data
+                } else {
+                    entries.putIfAbsent(entry.name, data)
+                }
+            }
+        }
+    }
+
+    ZipOutputStream(FileOutputStream(target).buffered()).use { out ->
+        fun putStored(name: String, data: ByteArray) {
+            val entry = ZipEntry(name).apply {
+                time = STORED_JAR_ENTRY_TIME
+                method = ZipEntry.STORED
+                size = data.size.toLong()
+                compressedSize = data.size.toLong()
+                crc = CRC32().also { it.update(data) }.value
+            }
+            out.putNextEntry(entry)
+            out.write(data)
+            out.closeEntry()
+        }
+        // JarInputStream等工具要求manifest是第一个条目
+        manifest?.let { putStored(JarFile.MANIFEST_NAME, it) }
+        entries.forEach { (name, data) -> putStored(name, data) }
+    }
+}
+
 tasks.register("buildRuntime") {
     doLast {
         val cacioZip = rootDir.resolve("app/src/main/assets/runtime_libs/cacio.zip")
@@ -41,8 +94,18 @@ tasks.register("buildRuntime") {
             }
         }
 
+        // argent作为javaagent单独保留，其余jar合并成一个引导jar
+        val (agentJars, bootJars) = allJarFiles.partition { it.name.contains("argent") }
+        val packedJars = agentJars.map { jar ->
+            File(temporaryDir, jar.name).also { writeStoredJar(listOf(jar), it) }
+        }.toMutableList()
+        if (bootJars.isNotEmpty()) {
+            packedJars += File(temporaryDir, "cacio-boot.jar").also { writeStoredJar(bootJars, it) }
+            println("cacio-boot.jar: merged ${bootJars.joinToString { it.name }}")
+        }
+
         ZipOutputStream(FileOutputStream(cacioZip)).use { out ->
-            for (jarFile in allJarFiles)
+            for (jarFile in packedJars)
                 FileInputStream(jarFile).use { fi ->
                     val entry = ZipEntry("cacio/${jarFile.name}")
                     out.putNextEntry(entry)
@@ -53,13 +116,15 @@ tasks.register("buildRuntime") {
     }
 }
 
+tasks.named("buildRuntime") {
+    dependsOn(":cacio-argent:jar", ":cacio-shared:jar", ":cacio-tta:jar")
+}
+
 afterEvaluate {
-    tasks.named("mergeDebugAssets") {
-        dependsOn(
-            ":cacio-argent:jar", ":cacio-shared:jar", ":cacio-tta:jar", ":app:buildRuntime"
-        )
+    // 每个变体（debug、release等）打包资源前都重新生成cacio.zip，确保包含cacio-boot.jar
+    tasks.matching { it.name.startsWith("merge") && it.name.endsWith("Assets") }.configureEach {
+        dependsOn(":app:buildRuntime")
     }
-
 }
 
 android {
@@ -141,6 +206,7 @@ dependencies {
     implementation(libs.androidx.activity)
     implementation(libs.androidx.material3)
     implementation(libs.androidx.lifecycle.viewmodel.ktx)
+    implementation(project(":awt-codec"))
     ksp(libs.hilt.android.compiler)
 
     testImplementation(libs.junit)
@@ -7,9 +7,14 @@
 
 #include <android/log.h>
 #include <string>
-#include <format>
+#include <string_view>
 #include <sstream>
 
+#if __has_include(<format>)
+#include <format>
+#define MY_AWT_HAVE_STD_FORMAT 1
+#endif
+
 constexpr auto LOG_TAG = "NativeJavaLauncher";
 
 enum class LogType : uint8_t {
@@ -45,6 +50,28 @@ constexpr const char* getLogTypeName(LogType type) {
     }
 }
 
+#ifndef MY_AWT_HAVE_STD_FORMAT
+// 没有<format>的标准库（如GCC 12）上的替代实现：依次把参数写入每个"{}"，只支持日志中用到的无格式说明的占位符
+namespace android_log_detail {
+
+inline void format_to(std::ostringstream &out, std::string_view fmt) {
+    out << fmt;
+}
+
+template<typename T, typename... Rest>
+void format_to(std::ostringstream &out, std::string_view fmt, const T &value, const Rest &... rest) {
+    size_t pos = fmt.find("{}");
+    if (pos == std::string_view::npos) {
+        out << fmt;
+        return;
+    }
+    out << fmt.substr(0, pos) << value;
+    format_to(out, fmt.substr(pos + 2), rest...);
+}
+
+} // namespace android_log_detail
+#endif
+
 class AndroidLogger {
 private:
     static void log_output(LogType type, const std::string& message) {
@@ -69,7 +96,13 @@ public:
         if constexpr (sizeof...(args) == 0) {
             log_output(type, fmt);
         } else {
+#ifdef MY_AWT_HAVE_STD_FORMAT
             std::string formatted = std::vformat(fmt, std::make_format_args(args...));
+#else
+            std::ostringstream out;
+            android_log_detail::format_to(out, fmt, args...);
+            std::string formatted = out.str();
+#endif
             log_output(type, formatted);
         }
     }
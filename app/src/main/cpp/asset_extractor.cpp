@@ -0,0 +1,251 @@
+//
+// Created by qz919 on 2025/10/3.
+//
+
+#include <jni.h>
+#include <android/asset_manager.h>
+#include <android/asset_manager_jni.h>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "android_log.hpp"
+#include "runtime_verifier.hpp"
+#include "zip_extractor.hpp"
+
+namespace {
+
+// 解压期间向Java汇报进度的间隔
+constexpr auto kProgressInterval = std::chrono::milliseconds(50);
+
+// linux/ioprio.h中的定义，NDK的头文件没有导出
+constexpr int kIoprioWhoProcess = 1;
+constexpr int kIoprioClassShift = 13;
+
+struct AssetCloser {
+    void operator()(AAsset *asset) const { AAsset_close(asset); }
+};
+
+using AssetPtr = std::unique_ptr<AAsset, AssetCloser>;
+
+std::string to_string(JNIEnv *env, jstring jstr) {
+    const char *chars = env->GetStringUTFChars(jstr, nullptr);
+    std::string result(chars);
+    env->ReleaseStringUTFChars(jstr, chars);
+    return result;
+}
+
+void throw_io_exception(JNIEnv *env, const std::string &message) {
+    jclass cls = env->FindClass("java/io/IOException");
+    if (cls != nullptr) {
+        env->ThrowNew(cls, message.c_str());
+    }
+}
+
+} // namespace
+
+/**
+ * 并行解压assets中的多个ZIP归档到同一目录
+ *
+ * 未压缩存储在APK中的资源由AAsset_getBuffer直接映射，不经过Java流和中间缓冲。
+ * includes不为空时，第i项列出第i个归档需要解压的条目（为null表示全部解压），用于增量更新。
+ * 解压在后台线程进行，调用线程每隔kProgressInterval通过listener.onProgress(index, done, total)
+ * 汇报各归档的进度，因此回调总是在调用方线程上执行
+ */
+extern "C" JNIEXPORT void JNICALL
+Java_io_github_eurya_awt_utils_NativeZipExtractor_nativeExtract(JNIEnv *env, jclass thiz,
+                                                                jobject jassetManager,
+                                                                jobjectArray jassetPaths,
+                                                                jobjectArray jincludes,
+                                                                jstring jtargetDir, jint workers,
+                                                                jobject listener) {
+    AAssetManager *manager = AAssetManager_fromJava(env, jassetManager);
+    if (manager == nullptr) {
+        throw_io_exception(env, "AssetManager unavailable");
+        return;
+    }
+
+    jmethodID onProgress = nullptr;
+    if (listener != nullptr) {
+        jclass listenerClass = env->GetObjectClass(listener);
+        onProgress = env->GetMethodID(listenerClass, "onProgress", "(IJJ)V");
+        env->DeleteLocalRef(listenerClass);
+        if (onProgress == nullptr) return;
+    }
+
+    std::string target_dir = to_string(env, jtargetDir);
+    ZipExtractor extractor(target_dir, static_cast<unsigned>(workers));
+    std::vector<AssetPtr> assets;
+    std::string error;
+
+    jsize count = env->GetArrayLength(jassetPaths);
+    for (jsize i = 0; i < count; i++) {
+        auto jpath = reinterpret_cast<jstring>(env->GetObjectArrayElement(jassetPaths, i));
+        std::string path = to_string(env, jpath);
+        env->DeleteLocalRef(jpath);
+
+        AssetPtr asset(AAsset_open(manager, path.c_str(), AASSET_MODE_BUFFER));
+        if (!asset) {
+            throw_io_exception(env, "cannot open asset: " + path);
+            return;
+        }
+        // 未压缩的资源直接映射APK中的数据区间，压缩资源会被完整解压到内存
+        auto data = static_cast<const uint8_t *>(AAsset_getBuffer(asset.get()));
+        auto length = static_cast<size_t>(AAsset_getLength64(asset.get()));
+        if (AAsset_isAllocated(asset.get())) {
+            android_println(LogType::WARNING, "Asset {} is compressed in the APK", path);
+        }
+        std::unique_ptr<std::unordered_set<std::string>> include;
+        auto jinclude = jincludes != nullptr
+                        ? reinterpret_cast<jobjectArray>(env->GetObjectArrayElement(jincludes, i))
+                        : nullptr;
+        if (jinclude != nullptr) {
+            include = std::make_unique<std::unordered_set<std::string>>();
+            jsize names = env->GetArrayLength(jinclude);
+            for (jsize j = 0; j < names; j++) {
+                auto jname = reinterpret_cast<jstring>(env->GetObjectArrayElement(jinclude, j));
+                include->insert(to_string(env, jname));
+                env->DeleteLocalRef(jname);
+            }
+            env->DeleteLocalRef(jinclude);
+        }
+        if (!extractor.add_archive(path, data, length, error, include.get())) {
+            throw_io_exception(env, error);
+            return;
+        }
+        assets.push_back(std::move(asset));
+    }
+
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    bool done = false;
+    bool ok = false;
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread runner([&]() {
+        bool result = extractor.run(error);
+        std::lock_guard<std::mutex> lock(mutex);
+        ok = result;
+        done = true;
+        done_cv.notify_all();
+    });
+
+    std::vector<uint64_t> reported(extractor.archive_count(), UINT64_MAX);
+    auto report = [&]() {
+        if (onProgress == nullptr) return;
+        for (size_t i = 0; i < extractor.archive_count(); i++) {
+            uint64_t extracted = extractor.extracted_bytes(i);
+            if (extracted == reported[i]) continue;
+            reported[i] = extracted;
+            env->CallVoidMethod(listener, onProgress, static_cast<jint>(i),
+                                static_cast<jlong>(extracted),
+                                static_cast<jlong>(extractor.total_bytes(i)));
+            if (env->ExceptionCheck()) {
+                // 回调抛出的异常在解压结束后交给Java处理，这里不再继续回调
+                onProgress = nullptr;
+                return;
+            }
+        }
+    };
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!done_cv.wait_for(lock, kProgressInterval, [&]() { return done; })) {
+            lock.unlock();
+            report();
+            lock.lock();
+        }
+    }
+    runner.join();
+
+    if (!ok) {
+        if (!env->ExceptionCheck()) throw_io_exception(env, error);
+        return;
+    }
+    report();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    android_println(LogType::SUCCESS, "Extracted {} archives to {} in {}ms with {} workers",
+                    static_cast<int>(count), target_dir, static_cast<long long>(elapsed),
+                    static_cast<int>(workers));
+}
+
+/**
+ * 校验运行时目录中的文件，返回未通过的文件名
+ *
+ * mode对应RuntimeVerifier::Mode：0只比较元数据，1只计算元数据变化的文件，2全部重新计算
+ */
+extern "C" JNIEXPORT jobjectArray JNICALL
+Java_io_github_eurya_awt_utils_RuntimeVerifier_nativeVerify(JNIEnv *env, jclass thiz,
+                                                            jstring jroot, jobjectArray jnames,
+                                                            jlongArray jcrcs, jlongArray jsizes,
+                                                            jstring jcachePath, jint workers,
+                                                            jint mode) {
+    jsize count = env->GetArrayLength(jnames);
+    std::vector<RuntimeVerifier::Item> items(count);
+    std::vector<jlong> crcs(count);
+    std::vector<jlong> sizes(count);
+    env->GetLongArrayRegion(jcrcs, 0, count, crcs.data());
+    env->GetLongArrayRegion(jsizes, 0, count, sizes.data());
+    for (jsize i = 0; i < count; i++) {
+        auto jname = reinterpret_cast<jstring>(env->GetObjectArrayElement(jnames, i));
+        items[i].name = to_string(env, jname);
+        items[i].crc = static_cast<uint32_t>(crcs[i]);
+        items[i].size = static_cast<uint64_t>(sizes[i]);
+        env->DeleteLocalRef(jname);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    RuntimeVerifier verifier(to_string(env, jroot), to_string(env, jcachePath),
+                             static_cast<unsigned>(workers));
+    auto failed = verifier.verify(items, static_cast<RuntimeVerifier::Mode>(mode));
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    android_println(LogType::DEBUG, "Verified {} files (mode {}) in {}us, {} failed",
+                    static_cast<int>(count), static_cast<int>(mode),
+                    static_cast<long long>(elapsed), failed.size());
+
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(failed.size()), stringClass,
+                                              nullptr);
+    for (size_t i = 0; i < failed.size(); i++) {
+        jstring jname = env->NewStringUTF(failed[i].c_str());
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), jname);
+        env->DeleteLocalRef(jname);
+    }
+    return result;
+}
+
+/**
+ * 设置调用线程的I/O优先级，value为IOPRIO_PRIO_VALUE(class, level)
+ *
+ * 之后由该线程创建的线程会继承这个优先级，原生解压器的工作线程因此一并降级。
+ * 返回ioprio_get得到的原始值，原样传回即可恢复；失败时返回-1
+ */
+extern "C" JNIEXPORT jint JNICALL
+Java_io_github_eurya_awt_utils_IoPriority_nativeSet(JNIEnv *env, jclass thiz, jint value) {
+    long previous = syscall(SYS_ioprio_get, kIoprioWhoProcess, 0);
+    if (previous < 0) return -1;
+
+    if (syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, value) != 0) {
+        // 未显式设置时内核返回IOPRIO_CLASS_NONE和默认等级，部分内核不接受NONE带等级，
+        // 恢复时退回到不带等级的NONE，仍然是“跟随nice值”的默认优先级
+        if (errno != EINVAL || (value >> kIoprioClassShift) != 0
+            || syscall(SYS_ioprio_set, kIoprioWhoProcess, 0, 0) != 0) {
+            android_println(LogType::WARNING, "ioprio_set({}) failed: errno {}", value, errno);
+            return -1;
+        }
+    }
+    return static_cast<jint>(previous);
+}
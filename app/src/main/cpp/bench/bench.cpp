@@ -0,0 +1,264 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <thread>
+
+namespace bench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<Case> &cases() {
+    static std::vector<Case> instance;
+    return instance;
+}
+
+double elapsed_ns(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+    double rank = p * static_cast<double>(sorted.size() - 1);
+    auto low = static_cast<size_t>(rank);
+    size_t high = std::min(low + 1, sorted.size() - 1);
+    return sorted[low] + (sorted[high] - sorted[low]) * (rank - static_cast<double>(low));
+}
+
+#if defined(__clang__)
+constexpr const char *kCompiler = __VERSION__;
+#else
+constexpr const char *kCompiler = "GCC " __VERSION__;
+#endif
+
+std::string escape(const std::string &value) {
+    std::string result;
+    for (char c: value) {
+        if (c == '"' || c == '\\') result.push_back('\\');
+        result.push_back(c);
+    }
+    return result;
+}
+
+// 比较时允许的变慢幅度至少是合并相对标准差的这么多倍，噪声大的用例自动放宽
+constexpr double kNoiseSigmas = 3.0;
+
+struct BaselineEntry {
+    double median_ns = 0;
+    double min_ns = 0;
+    double stddev_ns = 0;
+};
+
+double field(const std::string &line, const char *key) {
+    auto pos = line.find(key);
+    return pos == std::string::npos ? 0.0 : std::strtod(line.c_str() + pos + strlen(key), nullptr);
+}
+
+// 只解析write_json写出的格式：每行一个结果，取name、median_ns、min_ns和stddev_ns；host行中取记录基线的核心数
+std::map<std::string, BaselineEntry> read_baseline(const std::string &path, bool &ok, unsigned &cores) {
+    std::map<std::string, BaselineEntry> baseline;
+    std::ifstream input(path);
+    ok = input.good();
+    cores = 0;
+    std::string line;
+    while (std::getline(input, line)) {
+        auto cores_pos = line.find("\"cores\": ");
+        if (cores_pos != std::string::npos) {
+            cores = static_cast<unsigned>(std::strtoul(line.c_str() + cores_pos + 9, nullptr, 10));
+            continue;
+        }
+        auto name_pos = line.find("\"name\": \"");
+        auto median_pos = line.find("\"median_ns\": ");
+        if (name_pos == std::string::npos || median_pos == std::string::npos) continue;
+        name_pos += 9;
+        auto name_end = line.find('"', name_pos);
+        if (name_end == std::string::npos) continue;
+        BaselineEntry &entry = baseline[line.substr(name_pos, name_end - name_pos)];
+        entry.median_ns = std::strtod(line.c_str() + median_pos + 13, nullptr);
+        entry.min_ns = field(line, "\"min_ns\": ");
+        entry.stddev_ns = field(line, "\"stddev_ns\": ");
+    }
+    return baseline;
+}
+
+} // namespace
+
+bool register_case(std::string name, std::function<Body()> setup) {
+    cases().push_back({std::move(name), std::move(setup)});
+    return true;
+}
+
+std::vector<Case> registered_cases() {
+    auto result = cases();
+    std::sort(result.begin(), result.end(),
+              [](const Case &a, const Case &b) { return a.name < b.name; });
+    return result;
+}
+
+Result run_case(const Case &bench_case, const Options &options) {
+    Body body = bench_case.setup();
+
+    // 预热：至少调用一次，同时估算单次耗时
+    uint64_t warmup_calls = 0;
+    auto warmup_start = Clock::now();
+    do {
+        body.run();
+        warmup_calls++;
+    } while (elapsed_ns(warmup_start) < options.warmup_ms * 1e6);
+    double estimate = elapsed_ns(warmup_start) / static_cast<double>(warmup_calls);
+
+    // 单次很快的用例按批量计时，避免时钟开销和分辨率影响结果
+    auto batch = static_cast<uint64_t>(
+            std::max(1.0, std::ceil(options.min_sample_ms * 1e6 / std::max(estimate, 1.0))));
+
+    std::vector<double> samples;
+    samples.reserve(options.samples);
+    for (int i = 0; i < options.samples; i++) {
+        auto start = Clock::now();
+        for (uint64_t j = 0; j < batch; j++) body.run();
+        samples.push_back(elapsed_ns(start) / static_cast<double>(batch));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = bench_case.name;
+    result.iterations = batch * samples.size();
+    result.min_ns = samples.front();
+    result.median_ns = percentile(samples, 0.5);
+    result.p90_ns = percentile(samples, 0.9);
+    double sum = 0;
+    for (double sample: samples) sum += sample;
+    result.mean_ns = sum / static_cast<double>(samples.size());
+    double variance = 0;
+    for (double sample: samples) variance += (sample - result.mean_ns) * (sample - result.mean_ns);
+    result.stddev_ns = std::sqrt(variance / static_cast<double>(samples.size()));
+    if (body.bytes > 0) {
+        result.mb_per_s = static_cast<double>(body.bytes) / (1024.0 * 1024.0) /
+                          (result.median_ns / 1e9);
+    }
+    return result;
+}
+
+bool write_json(const std::string &path, const std::vector<Result> &results) {
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr) return false;
+
+    fprintf(file, "{\n  \"schema\": 1,\n");
+    fprintf(file, "  \"host\": {\"compiler\": \"%s\", \"cores\": %u},\n",
+            escape(kCompiler).c_str(), std::thread::hardware_concurrency());
+    fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"median_ns\": %.1f, \"min_ns\": %.1f, \"mean_ns\": %.1f, "
+                "\"p90_ns\": %.1f, \"stddev_ns\": %.1f, \"mb_per_s\": %.1f, \"iterations\": %llu}%s\n",
+                escape(r.name).c_str(), r.median_ns, r.min_ns, r.mean_ns, r.p90_ns, r.stddev_ns,
+                r.mb_per_s, static_cast<unsigned long long>(r.iterations),
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+int compare_with_baseline(const std::string &path, std::vector<Result> &results,
+                          const Options &options) {
+    bool ok = false;
+    unsigned baseline_cores = 0;
+    auto baseline = read_baseline(path, ok, baseline_cores);
+    if (!ok) return -1;
+
+    // 多线程用例的耗时取决于核心数，核心数不同的基线无法判断这些用例是否回归
+    unsigned cores = std::thread::hardware_concurrency();
+    bool cores_differ = baseline_cores != cores;
+    if (cores_differ) {
+        printf("\nBaseline was recorded on %u core(s), this host has %u: "
+               "multi-worker cases are not compared\n", baseline_cores, cores);
+    }
+
+    // 比较最小值，它受调度和缓存干扰最少；允许的幅度取threshold与两次运行合并噪声的较大者
+    auto allowed_change = [&options](const BaselineEntry &base, const Result &r) {
+        double base_noise = base.stddev_ns / base.median_ns;
+        double current_noise = r.median_ns > 0 ? r.stddev_ns / r.median_ns : 0.0;
+        return std::max(options.threshold, kNoiseSigmas * std::hypot(base_noise, current_noise));
+    };
+    auto regressed = [&allowed_change](const BaselineEntry &base, const Result &r) {
+        return r.min_ns / base.min_ns - 1.0 > allowed_change(base, r);
+    };
+
+    // 疑似回归的用例重新运行，保留最小值最低的一次，一次偶然的干扰不会让比较失败
+    std::vector<Case> all_cases = registered_cases();
+    for (Result &r: results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second.min_ns <= 0 || it->second.median_ns <= 0) continue;
+        auto bench_case = std::find_if(all_cases.begin(), all_cases.end(),
+                                       [&r](const Case &c) { return c.name == r.name; });
+        for (int run = 0; bench_case != all_cases.end() && run < options.confirm_runs &&
+                          regressed(it->second, r); run++) {
+            printf("Re-running %s to confirm\n", r.name.c_str());
+            Result retry = run_case(*bench_case, options);
+            if (retry.min_ns < r.min_ns) r = std::move(retry);
+        }
+    }
+
+    int regressions = 0;
+    printf("\n%-40s %14s %14s %9s %9s\n", "benchmark", "base min(ns)", "min(ns)", "change", "allowed");
+    for (const Result &r: results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second.min_ns <= 0 || it->second.median_ns <= 0) {
+            printf("%-40s %14s %14.1f %9s\n", r.name.c_str(), "-", r.min_ns, "new");
+            continue;
+        }
+        const BaselineEntry &base = it->second;
+        if (cores_differ && r.name.find("all_workers") != std::string::npos) {
+            printf("%-40s %14.1f %14.1f %9s\n", r.name.c_str(), base.min_ns, r.min_ns, "cores");
+            continue;
+        }
+        double change = r.min_ns / base.min_ns - 1.0;
+        bool is_regression = regressed(base, r);
+        if (is_regression) regressions++;
+        printf("%-40s %14.1f %14.1f %+8.1f%% %8.1f%%%s\n", r.name.c_str(), base.min_ns, r.min_ns,
+               change * 100.0, allowed_change(base, r) * 100.0, is_regression ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+const std::string &work_dir() {
+    // 静态对象析构时删除目录，比atexit更容易保证在所有使用者之后执行
+    struct Dir {
+        std::string path;
+        ~Dir() {
+            std::error_code ignored;
+            std::filesystem::remove_all(path, ignored);
+        }
+    };
+    static const Dir dir = [] {
+        // 基准测量的是解压和校验代码本身；磁盘回写和discard会让反复写小文件的用例在同一台机器上
+        // 相差数倍，未指定TMPDIR时优先使用内存文件系统
+        std::filesystem::path base = std::filesystem::temp_directory_path();
+        std::error_code ignored;
+        if (getenv("TMPDIR") == nullptr && std::filesystem::is_directory("/dev/shm", ignored)) {
+            base = "/dev/shm";
+        }
+        std::string pattern = (base / "my_awt_bench.XXXXXX").string();
+        if (mkdtemp(pattern.data()) == nullptr) {
+            perror("mkdtemp");
+            std::exit(EXIT_FAILURE);
+        }
+        return Dir{pattern};
+    }();
+    return dir.path;
+}
+
+} // namespace bench
@@ -0,0 +1,97 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#ifndef MY_AWT_BENCH_HPP
+#define MY_AWT_BENCH_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * 主机基准测试框架
+ *
+ * 每个用例由setup准备数据并返回被测函数，框架负责预热、按目标时长确定每个样本的批量次数、
+ * 采集多个样本并计算统计量。结果可以输出为JSON并与检入的基线比较
+ */
+namespace bench {
+
+/** 被测函数及每次调用处理的字节数（0表示不统计吞吐量） */
+struct Body {
+    std::function<void()> run;
+    uint64_t bytes = 0;
+};
+
+struct Case {
+    std::string name;
+    std::function<Body()> setup;
+};
+
+struct Options {
+    std::string filter;          // 只运行名称包含该子串的用例
+    int samples = 20;            // 样本数
+    int warmup_ms = 200;         // 每个用例的预热时长
+    int min_sample_ms = 5;       // 单个样本的最短时长，不足时增加批量次数
+    int runs = 1;                // 所有用例运行的轮数，每个用例保留最小值最低的一轮
+    std::string json_path;       // 结果输出路径
+    std::string baseline_path;   // 基线文件路径
+    double threshold = 0.10;     // 最小值变慢超过该比例且超出噪声范围时视为回归
+    int confirm_runs = 2;        // 疑似回归的用例最多重新运行的次数
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations = 0;     // 所有样本的总调用次数
+    double min_ns = 0;
+    double median_ns = 0;
+    double mean_ns = 0;
+    double p90_ns = 0;
+    double stddev_ns = 0;
+    double mb_per_s = 0;         // 按中位数计算的吞吐量
+};
+
+/** 注册用例，供MY_AWT_BENCHMARK宏在静态初始化时调用 */
+bool register_case(std::string name, std::function<Body()> setup);
+
+/** 所有已注册的用例，按名称排序 */
+std::vector<Case> registered_cases();
+
+/** 运行单个用例 */
+Result run_case(const Case &bench_case, const Options &options);
+
+/** 把结果写成JSON，每个结果占一行，基线的改动在评审时一目了然 */
+bool write_json(const std::string &path, const std::vector<Result> &results);
+
+/**
+ * 与基线比较并打印对照表
+ *
+ * 比较各用例的最小值，允许的变慢幅度取options.threshold与基线、本次运行合并相对标准差3倍中的较大者；
+ * 疑似回归的用例最多重新运行options.confirm_runs次，results中保留最小值最低的一次
+ *
+ * @return 出现回归的用例数，基线无法读取时返回-1
+ */
+int compare_with_baseline(const std::string &path, std::vector<Result> &results,
+                          const Options &options);
+
+/** 基准测试使用的临时工作目录，进程退出时删除 */
+const std::string &work_dir();
+
+/** 阻止编译器把结果当作无用代码删除 */
+template<typename T>
+inline void do_not_optimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace bench
+
+#define MY_AWT_BENCH_CONCAT_(a, b) a##b
+#define MY_AWT_BENCH_CONCAT(a, b) MY_AWT_BENCH_CONCAT_(a, b)
+
+/** 注册一个用例，setup是返回bench::Body的可调用对象（可变参数以便lambda中出现逗号） */
+#define MY_AWT_BENCHMARK(name, ...) \
+    static const bool MY_AWT_BENCH_CONCAT(bench_registered_, __LINE__) = \
+            bench::register_case(name, __VA_ARGS__)
+
+#endif // MY_AWT_BENCH_HPP
@@ -0,0 +1,66 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "launch_spec.hpp"
+
+namespace {
+
+// 与设备上NativeJavaLauncher传给nativeLaunchJvm的参数相同：系统属性、模块导出、Cacio jar和应用jar
+const std::vector<std::string> &device_args() {
+    static const std::vector<std::string> args = {
+            "/data/user/0/io.github.eurya.awt/files/runtime_libs/jre17/bin/java",
+            "-Djava.home=/data/user/0/io.github.eurya.awt/files/runtime_libs/jre17",
+            "-Djava.io.tmpdir=/data/user/0/io.github.eurya.awt/cache",
+            "-Djava.awt.headless=false",
+            "-Dawt.useSystemAAFontSettings=on",
+            "-Dswing.aatext=true",
+            "-Dcacio.managed.screensize=1280x720",
+            "-Dcacio.managed.uiscale=2.0",
+            "-Dcacio.font.fontmanager=sun.awt.X11FontManager",
+            "-Dcacio.font.fontscaler=sun.font.FreetypeFontScaler",
+            "-Dswing.defaultlaf=javax.swing.plaf.metal.MetalLookAndFeel",
+            "-Dawt.toolkit=com.github.caciocavallosilano.cacio.ctc.CTCToolkit",
+            "-Djava.awt.graphicsenv=com.github.caciocavallosilano.cacio.ctc.CTCGraphicsEnvironment",
+            "-Djava.system.class.loader=com.github.caciocavallosilano.cacio.ctc.CTCPreloadClassLoader",
+            "--add-exports=java.desktop/java.awt=ALL-UNNAMED",
+            "--add-exports=java.desktop/java.awt.peer=ALL-UNNAMED",
+            "--add-exports=java.desktop/sun.awt.image=ALL-UNNAMED",
+            "--add-exports=java.desktop/sun.java2d=ALL-UNNAMED",
+            "--add-exports=java.desktop/java.awt.dnd.peer=ALL-UNNAMED",
+            "--add-exports=java.desktop/sun.awt=ALL-UNNAMED",
+            "--add-exports=java.desktop/sun.awt.event=ALL-UNNAMED",
+            "--add-exports=java.desktop/sun.awt.datatransfer=ALL-UNNAMED",
+            "--add-exports=java.desktop/sun.font=ALL-UNNAMED",
+            "--add-exports=java.base/sun.security.action=ALL-UNNAMED",
+            "--add-opens=java.base/java.util=ALL-UNNAMED",
+            "--add-opens=java.desktop/java.awt=ALL-UNNAMED",
+            "--add-opens=java.desktop/sun.font=ALL-UNNAMED",
+            "--add-opens=java.desktop/sun.java2d=ALL-UNNAMED",
+            "--add-opens=java.base/java.lang.reflect=ALL-UNNAMED",
+            "--add-opens=java.base/java.net=ALL-UNNAMED",
+            "-javaagent:/data/user/0/io.github.eurya.awt/files/runtime_libs/jre17/cacio/cacio-argent.jar",
+            "-Xbootclasspath/a:/data/user/0/io.github.eurya.awt/files/runtime_libs/jre17/cacio/cacio-boot.jar",
+            "-jar",
+            "/data/user/0/io.github.eurya.awt/files/app.jar",
+    };
+    return args;
+}
+
+} // namespace
+
+// JNI层逐个取出UTF字符串后组装argv，这里用C字符串代替GetStringUTFChars的结果
+MY_AWT_BENCHMARK("launch/assemble_argv", [] {
+    std::vector<const char *> utf_chars;
+    for (const auto &arg: device_args()) utf_chars.push_back(arg.c_str());
+    return bench::Body{[utf_chars] {
+        LaunchSpec spec;
+        spec.reserve(utf_chars.size());
+        for (const char *arg: utf_chars) spec.add(arg);
+        bench::do_not_optimize(spec.argv());
+    }};
+});
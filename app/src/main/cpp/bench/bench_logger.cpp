@@ -0,0 +1,28 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#include "android_log.hpp"
+#include "bench.hpp"
+
+// 标准库没有<format>时android_log.hpp使用替代的占位符替换，两种实现的结果不能直接比较，基线中记录了编译器
+
+MY_AWT_BENCHMARK("log/println_plain", [] {
+    return bench::Body{[] {
+        android_println(LogType::DEBUG, "Pipe EOF, child process finished");
+    }};
+});
+
+MY_AWT_BENCHMARK("log/println_formatted", [] {
+    return bench::Body{[] {
+        android_println(LogType::DEBUG, "Verified {} files (mode {}) in {}us, {} failed",
+                        1342, 1, 215LL, size_t{0});
+    }};
+});
+
+MY_AWT_BENCHMARK("log/println_success", [] {
+    std::string name = "JAVA_HOME";
+    return bench::Body{[name] {
+        android_println(LogType::SUCCESS, "Successfully set environment variable: {}", name);
+    }};
+});
@@ -0,0 +1,114 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+
+namespace {
+
+void print_usage(const char *program) {
+    printf("Usage: %s [options]\n"
+           "  --filter <text>       only run benchmarks whose name contains text\n"
+           "  --samples <n>         samples per benchmark (default 20)\n"
+           "  --warmup-ms <n>       warmup time per benchmark (default 200)\n"
+           "  --min-sample-ms <n>   minimum duration of one sample (default 5)\n"
+           "  --runs <n>            run all benchmarks n times, keep each one's lowest run (default 1)\n"
+           "  --json <path>         write results as JSON\n"
+           "  --baseline <path>     compare minimums with a baseline JSON file\n"
+           "  --threshold <ratio>   smallest slowdown reported as regression (default 0.10);\n"
+           "                        noisy cases allow 3x their combined relative stddev\n"
+           "  --confirm-runs <n>    re-runs of a suspected regression (default 2)\n"
+           "  --list                list benchmarks and exit\n",
+           program);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    bench::Options options;
+    bool list_only = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char * {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Missing value for %s\n", arg.c_str());
+                std::exit(EXIT_FAILURE);
+            }
+            return argv[++i];
+        };
+        if (arg == "--filter") options.filter = next();
+        else if (arg == "--samples") options.samples = std::max(1, atoi(next()));
+        else if (arg == "--warmup-ms") options.warmup_ms = std::max(0, atoi(next()));
+        else if (arg == "--min-sample-ms") options.min_sample_ms = std::max(0, atoi(next()));
+        else if (arg == "--runs") options.runs = std::max(1, atoi(next()));
+        else if (arg == "--json") options.json_path = next();
+        else if (arg == "--baseline") options.baseline_path = next();
+        else if (arg == "--threshold") options.threshold = atof(next());
+        else if (arg == "--confirm-runs") options.confirm_runs = std::max(0, atoi(next()));
+        else if (arg == "--list") list_only = true;
+        else {
+            print_usage(argv[0]);
+            return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    std::vector<bench::Case> selected;
+    for (const auto &bench_case: bench::registered_cases()) {
+        if (!options.filter.empty() && bench_case.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        if (list_only) {
+            printf("%s\n", bench_case.name.c_str());
+            continue;
+        }
+        selected.push_back(bench_case);
+    }
+    if (list_only) return EXIT_SUCCESS;
+
+    // 多轮时每轮依次运行所有用例，持续一段时间的干扰只影响其中一轮；每个用例保留最小值最低的一轮
+    std::vector<bench::Result> results;
+    for (int run = 0; run < options.runs; run++) {
+        for (size_t i = 0; i < selected.size(); i++) {
+            auto result = bench::run_case(selected[i], options);
+            if (run == 0) {
+                results.push_back(std::move(result));
+            } else if (result.min_ns < results[i].min_ns) {
+                results[i] = std::move(result);
+            }
+        }
+    }
+    for (const auto &result: results) {
+        printf("%-40s median %12.1f ns  p90 %12.1f ns  stddev %10.1f ns", result.name.c_str(),
+               result.median_ns, result.p90_ns, result.stddev_ns);
+        if (result.mb_per_s > 0) printf("  %9.1f MB/s", result.mb_per_s);
+        printf("\n");
+    }
+    fflush(stdout);
+
+    if (!options.json_path.empty() && !bench::write_json(options.json_path, results)) {
+        fprintf(stderr, "Failed to write %s\n", options.json_path.c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (!options.baseline_path.empty()) {
+        int regressions = bench::compare_with_baseline(options.baseline_path, results, options);
+        if (regressions < 0) {
+            fprintf(stderr, "Failed to read baseline %s\n", options.baseline_path.c_str());
+            return EXIT_FAILURE;
+        }
+        if (regressions > 0) {
+            printf("\n%d benchmark(s) regressed beyond the allowed slowdown (at least %.0f%%)\n",
+                   regressions, options.threshold * 100.0);
+            return 2;
+        }
+    }
+    return EXIT_SUCCESS;
+}
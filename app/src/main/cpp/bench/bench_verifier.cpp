@@ -0,0 +1,95 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "bench.hpp"
+#include "fixtures.hpp"
+#include "runtime_verifier.hpp"
+
+namespace {
+
+constexpr size_t kFiles = 200;
+constexpr size_t kLargeSize = 32u << 20;
+
+struct Tree {
+    std::string root;
+    std::vector<RuntimeVerifier::Item> items;
+    uint64_t bytes = 0;
+};
+
+// 模拟解压后的运行时目录：一个大文件加上若干小文件
+const Tree &runtime_tree() {
+    static const Tree tree = [] {
+        Tree result;
+        result.root = bench::work_dir() + "/verify";
+        std::filesystem::create_directories(result.root + "/lib");
+        auto add = [&result](const std::string &name, size_t size, uint32_t seed) {
+            auto data = fixtures::make_data(size, seed);
+            FILE *file = fopen((result.root + "/" + name).c_str(), "wb");
+            fwrite(data.data(), 1, data.size(), file);
+            fclose(file);
+            auto crc = static_cast<uint32_t>(crc32(0L, data.data(), static_cast<uInt>(data.size())));
+            result.items.push_back({name, crc, size});
+            result.bytes += size;
+        };
+        add("lib/modules", kLargeSize, 1);
+        for (size_t i = 0; i < kFiles; i++) {
+            add("lib/file" + std::to_string(i) + ".so", 4096 + (i * 7919) % (120 * 1024),
+                static_cast<uint32_t>(i + 2));
+        }
+        return result;
+    }();
+    return tree;
+}
+
+unsigned all_cores() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+MY_AWT_BENCHMARK("verify/crc32_32MB", [] {
+    const Tree &tree = runtime_tree();
+    int fd = open((tree.root + "/lib/modules").c_str(), O_RDONLY | O_CLOEXEC);
+    return bench::Body{[fd] {
+        uint32_t crc = 0;
+        RuntimeVerifier::file_crc32(fd, kLargeSize, crc);
+        bench::do_not_optimize(crc);
+    }, kLargeSize};
+});
+
+MY_AWT_BENCHMARK("verify/stat_only_warm_cache", [] {
+    const Tree &tree = runtime_tree();
+    std::string cache = bench::work_dir() + "/verify_warm.cache";
+    RuntimeVerifier(tree.root, cache, all_cores()).verify(tree.items, RuntimeVerifier::Mode::kChanged);
+    return bench::Body{[&tree, cache] {
+        RuntimeVerifier verifier(tree.root, cache, 1);
+        bench::do_not_optimize(verifier.verify(tree.items, RuntimeVerifier::Mode::kStatOnly).size());
+    }};
+});
+
+MY_AWT_BENCHMARK("verify/full_1_worker", [] {
+    const Tree &tree = runtime_tree();
+    std::string cache = bench::work_dir() + "/verify_full_1.cache";
+    return bench::Body{[&tree, cache] {
+        RuntimeVerifier verifier(tree.root, cache, 1);
+        bench::do_not_optimize(verifier.verify(tree.items, RuntimeVerifier::Mode::kFull).size());
+    }, tree.bytes};
+});
+
+MY_AWT_BENCHMARK("verify/full_all_workers", [] {
+    const Tree &tree = runtime_tree();
+    std::string cache = bench::work_dir() + "/verify_full_n.cache";
+    return bench::Body{[&tree, cache] {
+        RuntimeVerifier verifier(tree.root, cache, all_cores());
+        bench::do_not_optimize(verifier.verify(tree.items, RuntimeVerifier::Mode::kFull).size());
+    }, tree.bytes};
+});
@@ -0,0 +1,105 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+#include <unistd.h>
+
+#include "bench.hpp"
+#include "fixtures.hpp"
+#include "zip_extractor.hpp"
+
+namespace {
+
+constexpr size_t kSmallFiles = 300;
+constexpr size_t kStoredSize = 32u << 20;
+
+struct Archive {
+    std::string path;
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    uint64_t bytes = 0;  // 所有条目的未压缩大小
+};
+
+// 类似jre17-*.zip：大量4KB到64KB的压缩小文件
+const Archive &deflated_archive() {
+    static const Archive archive = [] {
+        Archive result;
+        result.path = bench::work_dir() + "/deflated.zip";
+        std::vector<fixtures::ZipFileSpec> files;
+        for (size_t i = 0; i < kSmallFiles; i++) {
+            size_t size = 4096 + (i * 7919) % (60 * 1024);
+            files.push_back({"lib/pkg" + std::to_string(i % 16) + "/file" + std::to_string(i) + ".class",
+                             fixtures::make_data(size, static_cast<uint32_t>(i))});
+            result.bytes += size;
+        }
+        fixtures::write_zip(result.path, files);
+        result.data = fixtures::map_file(result.path, result.size);
+        return result;
+    }();
+    return archive;
+}
+
+// 一个未压缩存储的大条目，覆盖直接pwrite的路径
+const Archive &stored_archive() {
+    static const Archive archive = [] {
+        Archive result;
+        result.path = bench::work_dir() + "/stored.zip";
+        fixtures::write_zip(result.path, {{"lib/modules", fixtures::make_data(kStoredSize, 7), true}});
+        result.data = fixtures::map_file(result.path, result.size);
+        result.bytes = kStoredSize;
+        return result;
+    }();
+    return archive;
+}
+
+void extract_or_die(const Archive &archive, const std::string &target, unsigned workers) {
+    ZipExtractor extractor(target, workers);
+    std::string error;
+    if (!extractor.add_archive(archive.path, archive.data, archive.size, error) ||
+        !extractor.run(error)) {
+        fprintf(stderr, "extraction failed: %s\n", error.c_str());
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+bench::Body extract_body(const Archive &archive, unsigned workers, const char *dir) {
+    std::string target = bench::work_dir() + "/" + dir;
+    std::filesystem::create_directories(target);
+    return {[&archive, target, workers] {
+        extract_or_die(archive, target, workers);
+    }, archive.bytes};
+}
+
+unsigned all_cores() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+MY_AWT_BENCHMARK("zip/parse_central_directory", [] {
+    const Archive &archive = deflated_archive();
+    return bench::Body{[&archive] {
+        ZipExtractor extractor(bench::work_dir(), 1);
+        std::string error;
+        extractor.add_archive(archive.path, archive.data, archive.size, error);
+        bench::do_not_optimize(extractor.entries().size());
+    }};
+});
+
+MY_AWT_BENCHMARK("zip/extract_deflated_1_worker", [] {
+    return extract_body(deflated_archive(), 1, "deflated_1");
+});
+
+MY_AWT_BENCHMARK("zip/extract_deflated_all_workers", [] {
+    return extract_body(deflated_archive(), all_cores(), "deflated_n");
+});
+
+MY_AWT_BENCHMARK("zip/extract_stored_pwrite", [] {
+    return extract_body(stored_archive(), 1, "stored_pwrite");
+});
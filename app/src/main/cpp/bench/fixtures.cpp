@@ -0,0 +1,151 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#include "fixtures.hpp"
+
+#include <cstdio>
+#include <iterator>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace fixtures {
+
+namespace {
+
+constexpr const char *kWords[] = {
+        "java/lang/Object", "Ljava/lang/String;", "<init>", "()V", "Code", "LineNumberTable",
+        "sun/awt/SunToolkit", "getInstance", "StackMapTable", "java/awt/Component", "(II)V",
+        "SourceFile", "this", "value", "Exceptions", "java/util/List", "size", "()I",
+};
+
+void put16(std::vector<uint8_t> &out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void put32(std::vector<uint8_t> &out, uint32_t value) {
+    put16(out, value & 0xFFFF);
+    put16(out, value >> 16);
+}
+
+std::vector<uint8_t> deflate_raw(const std::vector<uint8_t> &data) {
+    z_stream stream{};
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    std::vector<uint8_t> out(deflateBound(&stream, data.size()));
+    stream.next_in = const_cast<Bytef *>(data.data());
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = out.data();
+    stream.avail_out = static_cast<uInt>(out.size());
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+} // namespace
+
+std::vector<uint8_t> make_data(size_t size, uint32_t seed) {
+    std::vector<uint8_t> data;
+    data.reserve(size);
+    uint32_t state = seed * 2654435761u + 1;
+    while (data.size() < size) {
+        state = state * 1664525u + 1013904223u;
+        // 大部分是常量池里常见的字符串，夹杂少量随机字节，压缩率约为3:1
+        if ((state >> 28) < 3) {
+            for (int i = 0; i < 8 && data.size() < size; i++) {
+                state = state * 1664525u + 1013904223u;
+                data.push_back(static_cast<uint8_t>(state >> 24));
+            }
+        } else {
+            const char *word = kWords[(state >> 16) % std::size(kWords)];
+            for (const char *p = word; *p != '\0' && data.size() < size; p++) {
+                data.push_back(static_cast<uint8_t>(*p));
+            }
+        }
+    }
+    return data;
+}
+
+bool write_zip(const std::string &path, const std::vector<ZipFileSpec> &files) {
+    std::vector<uint8_t> out;
+    std::vector<uint8_t> central;
+    for (const auto &file: files) {
+        uint32_t crc = static_cast<uint32_t>(crc32(0L, file.data.data(),
+                                                   static_cast<uInt>(file.data.size())));
+        std::vector<uint8_t> compressed;
+        const std::vector<uint8_t> &payload = file.stored ? file.data
+                                                          : (compressed = deflate_raw(file.data));
+        uint16_t method = file.stored ? 0 : 8;
+        auto size = static_cast<uint32_t>(file.declared_size >= 0 ? file.declared_size
+                                                                  : static_cast<int64_t>(file.data.size()));
+        auto offset = static_cast<uint32_t>(out.size());
+
+        put32(out, 0x04034b50);
+        put16(out, 20);
+        put16(out, 0);
+        put16(out, method);
+        put32(out, 0);
+        put32(out, crc);
+        put32(out, static_cast<uint32_t>(payload.size()));
+        put32(out, size);
+        put16(out, static_cast<uint32_t>(file.name.size()));
+        put16(out, 0);
+        out.insert(out.end(), file.name.begin(), file.name.end());
+        out.insert(out.end(), payload.begin(), payload.end());
+
+        put32(central, 0x02014b50);
+        put16(central, (3 << 8) | 20);  // 由unix生成，外部属性高16位是权限位
+        put16(central, 20);
+        put16(central, 0);
+        put16(central, method);
+        put32(central, 0);
+        put32(central, crc);
+        put32(central, static_cast<uint32_t>(payload.size()));
+        put32(central, size);
+        put16(central, static_cast<uint32_t>(file.name.size()));
+        put16(central, 0);
+        put16(central, 0);
+        put16(central, 0);
+        put16(central, 0);
+        put32(central, 0100644u << 16);
+        put32(central, offset);
+        central.insert(central.end(), file.name.begin(), file.name.end());
+    }
+
+    auto central_offset = static_cast<uint32_t>(out.size());
+    out.insert(out.end(), central.begin(), central.end());
+    put32(out, 0x06054b50);
+    put16(out, 0);
+    put16(out, 0);
+    put16(out, static_cast<uint32_t>(files.size()));
+    put16(out, static_cast<uint32_t>(files.size()));
+    put32(out, static_cast<uint32_t>(central.size()));
+    put32(out, central_offset);
+    put16(out, 0);
+
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == nullptr) return false;
+    bool ok = fwrite(out.data(), 1, out.size(), file) == out.size();
+    return fclose(file) == 0 && ok;
+}
+
+const uint8_t *map_file(const std::string &path, size_t &size) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    size = static_cast<size_t>(st.st_size);
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    return mapped == MAP_FAILED ? nullptr : static_cast<const uint8_t *>(mapped);
+}
+
+} // namespace fixtures
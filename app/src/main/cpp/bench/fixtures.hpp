@@ -0,0 +1,35 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#ifndef MY_AWT_BENCH_FIXTURES_HPP
+#define MY_AWT_BENCH_FIXTURES_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 基准测试的数据生成工具
+ */
+namespace fixtures {
+
+/** 生成确定性的、压缩率与class文件和.so相近的数据 */
+std::vector<uint8_t> make_data(size_t size, uint32_t seed);
+
+struct ZipFileSpec {
+    std::string name;
+    std::vector<uint8_t> data;
+    bool stored = false;
+    int64_t declared_size = -1;  // 不为-1时写入头部的未压缩大小，用于构造损坏的归档
+};
+
+/** 写一个普通zip文件（不含zip64），压缩条目使用raw deflate */
+bool write_zip(const std::string &path, const std::vector<ZipFileSpec> &files);
+
+/** 把整个文件映射为只读内存，返回映射起点，失败时返回nullptr */
+const uint8_t *map_file(const std::string &path, size_t &size);
+
+} // namespace fixtures
+
+#endif // MY_AWT_BENCH_FIXTURES_HPP
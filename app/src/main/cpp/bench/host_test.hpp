@@ -0,0 +1,43 @@
+//
+// Created by qz919 on 2025/10/14.
+//
+
+#ifndef MY_AWT_HOST_TEST_HPP
+#define MY_AWT_HOST_TEST_HPP
+
+#include <functional>
+#include <string>
+
+/**
+ * 主机单元测试框架
+ *
+ * 与基准测试共用同一份被测源码和数据生成工具，由ctest运行。每个用例是一个无参函数，
+ * EXPECT失败时记录位置并继续执行，用例结束后统一报告
+ */
+namespace host_test {
+
+/** 注册用例，供MY_AWT_TEST宏在静态初始化时调用 */
+bool register_case(std::string name, std::function<void()> body);
+
+/** 记录一次失败的断言 */
+void fail(const char *file, int line, const char *expression);
+
+/** 当前用例独占的临时目录，用例结束后删除 */
+const std::string &case_dir();
+
+} // namespace host_test
+
+#define MY_AWT_TEST_CONCAT_(a, b) a##b
+#define MY_AWT_TEST_CONCAT(a, b) MY_AWT_TEST_CONCAT_(a, b)
+
+/** 定义并注册一个用例 */
+#define MY_AWT_TEST(name) \
+    static void MY_AWT_TEST_CONCAT(host_test_body_, __LINE__)(); \
+    static const bool MY_AWT_TEST_CONCAT(host_test_registered_, __LINE__) = \
+            host_test::register_case(name, MY_AWT_TEST_CONCAT(host_test_body_, __LINE__)); \
+    static void MY_AWT_TEST_CONCAT(host_test_body_, __LINE__)()
+
+#define EXPECT(expression) \
+    ((expression) ? (void) 0 : host_test::fail(__FILE__, __LINE__, #expression))
+
+#endif // MY_AWT_HOST_TEST_HPP
@@ -0,0 +1,82 @@
+//
+// Created by qz919 on 2025/10/14.
+//
+
+#include "host_test.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace host_test {
+
+namespace {
+
+struct Case {
+    std::string name;
+    std::function<void()> body;
+};
+
+std::vector<Case> &cases() {
+    static std::vector<Case> instance;
+    return instance;
+}
+
+int failures = 0;
+std::string current_dir;
+
+} // namespace
+
+bool register_case(std::string name, std::function<void()> body) {
+    cases().push_back({std::move(name), std::move(body)});
+    return true;
+}
+
+void fail(const char *file, int line, const char *expression) {
+    fprintf(stderr, "  %s:%d: EXPECT(%s) failed\n", file, line, expression);
+    failures++;
+}
+
+const std::string &case_dir() {
+    return current_dir;
+}
+
+} // namespace host_test
+
+int main(int argc, char **argv) {
+    using namespace host_test;
+    std::string filter = argc > 1 ? argv[1] : "";
+
+    std::vector<Case> sorted = cases();
+    std::sort(sorted.begin(), sorted.end(), [](const Case &a, const Case &b) { return a.name < b.name; });
+
+    int failed_cases = 0;
+    int run = 0;
+    for (const Case &test_case: sorted) {
+        if (!filter.empty() && test_case.name.find(filter) == std::string::npos) continue;
+
+        std::string pattern = (std::filesystem::temp_directory_path() / "my_awt_test.XXXXXX").string();
+        if (mkdtemp(pattern.data()) == nullptr) {
+            perror("mkdtemp");
+            return EXIT_FAILURE;
+        }
+        current_dir = pattern;
+
+        int before = failures;
+        test_case.body();
+        bool passed = failures == before;
+        printf("%-50s %s\n", test_case.name.c_str(), passed ? "ok" : "FAILED");
+        fflush(stdout);
+        if (!passed) failed_cases++;
+        run++;
+
+        std::error_code ignored;
+        std::filesystem::remove_all(current_dir, ignored);
+    }
+
+    printf("%d/%d passed\n", run - failed_cases, run);
+    return failed_cases == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
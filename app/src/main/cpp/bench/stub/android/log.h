@@ -0,0 +1,33 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#ifndef MY_AWT_BENCH_ANDROID_LOG_H
+#define MY_AWT_BENCH_ANDROID_LOG_H
+
+// 主机基准测试使用的android/log.h替身，只声明android_log.hpp用到的部分
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum android_LogPriority {
+    ANDROID_LOG_UNKNOWN = 0,
+    ANDROID_LOG_DEFAULT,
+    ANDROID_LOG_VERBOSE,
+    ANDROID_LOG_DEBUG,
+    ANDROID_LOG_INFO,
+    ANDROID_LOG_WARN,
+    ANDROID_LOG_ERROR,
+    ANDROID_LOG_FATAL,
+    ANDROID_LOG_SILENT,
+} android_LogPriority;
+
+int __android_log_print(int prio, const char *tag, const char *fmt, ...)
+        __attribute__((__format__(printf, 3, 4)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MY_AWT_BENCH_ANDROID_LOG_H
@@ -0,0 +1,31 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#include <android/log.h>
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+// 设置MY_AWT_BENCH_LOG后把日志打印到stderr，默认丢弃以免输出本身影响测量
+const bool kEcho = std::getenv("MY_AWT_BENCH_LOG") != nullptr;
+
+} // namespace
+
+/**
+ * liblog的替身：与真实实现一样把消息格式化到固定缓冲区，然后丢弃
+ */
+extern "C" int __android_log_print(int prio, const char *tag, const char *fmt, ...) {
+    char buffer[1024];
+    va_list args;
+    va_start(args, fmt);
+    int length = vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    if (kEcho) {
+        fprintf(stderr, "%d/%s: %s", prio, tag, buffer);
+    }
+    return length;
+}
@@ -0,0 +1,26 @@
+//
+// Created by qz919 on 2025/10/14.
+//
+
+#include <cstring>
+#include <string>
+
+#include "host_test.hpp"
+#include "launch_spec.hpp"
+
+MY_AWT_TEST("launch_spec/argv_points_at_every_argument") {
+    LaunchSpec spec;
+    spec.reserve(2);  // 故意预留不足，添加过程中参数字符串会被移动
+    for (int i = 0; i < 40; i++) {
+        spec.add(i % 2 == 0 ? "-Dshort=" + std::to_string(i)
+                            : std::string(64, 'x') + std::to_string(i));
+    }
+    spec.add("");
+
+    char **argv = spec.argv();
+    EXPECT(spec.size() == 41);
+    for (size_t i = 0; i < spec.size(); i++) {
+        EXPECT(argv[i] != nullptr && std::strcmp(argv[i], spec.args()[i].c_str()) == 0);
+    }
+    EXPECT(argv[spec.size()] == nullptr);
+}
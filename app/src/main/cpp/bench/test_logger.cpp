@@ -0,0 +1,25 @@
+//
+// Created by qz919 on 2025/10/14.
+//
+
+#include <sstream>
+
+#include "android_log.hpp"
+#include "host_test.hpp"
+
+#ifndef MY_AWT_HAVE_STD_FORMAT
+// 只在使用替代实现时编译，std::format本身不需要测试
+MY_AWT_TEST("log/fallback_format_replaces_placeholders_in_order") {
+    std::ostringstream out;
+    android_log_detail::format_to(out, "Verified {} files (mode {}) in {}us", 1342, 1, 215LL);
+    EXPECT(out.str() == "Verified 1342 files (mode 1) in 215us");
+
+    std::ostringstream extra;
+    android_log_detail::format_to(extra, "only {}", "one", "dropped");
+    EXPECT(extra.str() == "only one");
+
+    std::ostringstream missing;
+    android_log_detail::format_to(missing, "{} and {}", 1);
+    EXPECT(missing.str() == "1 and {}");
+}
+#endif
@@ -0,0 +1,93 @@
+//
+// Created by qz919 on 2025/10/14.
+//
+
+#include <cstdio>
+#include <filesystem>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#include "fixtures.hpp"
+#include "host_test.hpp"
+#include "runtime_verifier.hpp"
+
+namespace {
+
+using Mode = RuntimeVerifier::Mode;
+
+struct Tree {
+    std::string root;
+    std::string cache;
+    std::vector<RuntimeVerifier::Item> items;
+};
+
+void write_file(const std::string &path, const std::vector<uint8_t> &data) {
+    FILE *file = fopen(path.c_str(), "wb");
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+}
+
+Tree make_tree() {
+    Tree tree;
+    tree.root = host_test::case_dir() + "/runtime";
+    tree.cache = host_test::case_dir() + "/verify.cache";
+    std::filesystem::create_directories(tree.root + "/lib");
+    const char *names[] = {"lib/modules", "lib/libjvm.so", "lib/libawt.so", "release"};
+    uint32_t seed = 1;
+    for (const char *name: names) {
+        auto data = fixtures::make_data(8192 * seed, seed);
+        write_file(tree.root + "/" + name, data);
+        auto crc = static_cast<uint32_t>(crc32(0L, data.data(), static_cast<uInt>(data.size())));
+        tree.items.push_back({name, crc, data.size()});
+        seed++;
+    }
+    return tree;
+}
+
+/** 改变文件的mtime，内容不变，使缓存中的元数据失效 */
+void touch(const Tree &tree, size_t index, int64_t seconds) {
+    struct timespec times[2] = {{seconds, 0}, {seconds, 0}};
+    utimensat(AT_FDCWD, (tree.root + "/" + tree.items[index].name).c_str(), times, 0);
+}
+
+std::vector<std::string> verify(const Tree &tree, const std::vector<RuntimeVerifier::Item> &items, Mode mode) {
+    return RuntimeVerifier(tree.root, tree.cache, 2).verify(items, mode);
+}
+
+} // namespace
+
+MY_AWT_TEST("verify/changed_runs_keep_unrelated_cache_entries") {
+    Tree tree = make_tree();
+    EXPECT(verify(tree, tree.items, Mode::kChanged).empty());
+    EXPECT(verify(tree, tree.items, Mode::kStatOnly).empty());
+
+    // 连续两次只校验发生变化的文件，其余文件的缓存条目不能丢失
+    touch(tree, 1, 1000);
+    EXPECT(verify(tree, tree.items, Mode::kStatOnly) == std::vector<std::string>{"lib/libjvm.so"});
+    EXPECT(verify(tree, {tree.items[1]}, Mode::kChanged).empty());
+    EXPECT(verify(tree, tree.items, Mode::kStatOnly).empty());
+
+    touch(tree, 2, 2000);
+    EXPECT(verify(tree, {tree.items[2]}, Mode::kChanged).empty());
+    EXPECT(verify(tree, tree.items, Mode::kStatOnly).empty());
+}
+
+MY_AWT_TEST("verify/failed_files_are_removed_from_cache") {
+    Tree tree = make_tree();
+    EXPECT(verify(tree, tree.items, Mode::kChanged).empty());
+
+    // 大小不变、内容损坏
+    auto corrupted = fixtures::make_data(tree.items[0].size, 99);
+    write_file(tree.root + "/" + tree.items[0].name, corrupted);
+    EXPECT(verify(tree, {tree.items[0]}, Mode::kChanged) == std::vector<std::string>{"lib/modules"});
+    EXPECT(verify(tree, tree.items, Mode::kStatOnly) == std::vector<std::string>{"lib/modules"});
+}
+
+MY_AWT_TEST("verify/full_mode_on_subset_keeps_other_entries") {
+    Tree tree = make_tree();
+    EXPECT(verify(tree, tree.items, Mode::kChanged).empty());
+    EXPECT(verify(tree, {tree.items[3]}, Mode::kFull).empty());
+    EXPECT(verify(tree, tree.items, Mode::kStatOnly).empty());
+}
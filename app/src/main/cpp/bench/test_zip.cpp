@@ -0,0 +1,61 @@
+//
+// Created by qz919 on 2025/10/14.
+//
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include <sys/mman.h>
+
+#include "fixtures.hpp"
+#include "host_test.hpp"
+#include "zip_extractor.hpp"
+
+namespace {
+
+std::vector<uint8_t> read_file(const std::string &path) {
+    std::ifstream input(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>()};
+}
+
+/** 写出并映射归档，解压到case_dir()/out，返回run()的结果 */
+bool extract(const std::vector<fixtures::ZipFileSpec> &files, std::string &error) {
+    std::string path = host_test::case_dir() + "/archive.zip";
+    std::string target = host_test::case_dir() + "/out";
+    std::filesystem::create_directories(target);
+    if (!fixtures::write_zip(path, files)) {
+        error = "write_zip failed";
+        return false;
+    }
+    size_t size = 0;
+    const uint8_t *data = fixtures::map_file(path, size);
+    if (data == nullptr) {
+        error = "map_file failed";
+        return false;
+    }
+    ZipExtractor extractor(target, 2);
+    bool ok = extractor.add_archive(path, data, size, error) && extractor.run(error);
+    munmap(const_cast<uint8_t *>(data), size);
+    return ok;
+}
+
+} // namespace
+
+MY_AWT_TEST("zip/extracts_stored_and_deflated_entries") {
+    auto stored = fixtures::make_data(70000, 1);
+    auto deflated = fixtures::make_data(50000, 2);
+    std::string error;
+    EXPECT(extract({{"lib/modules", stored, true}, {"lib/a.class", deflated}}, error));
+    EXPECT(read_file(host_test::case_dir() + "/out/lib/modules") == stored);
+    EXPECT(read_file(host_test::case_dir() + "/out/lib/a.class") == deflated);
+}
+
+MY_AWT_TEST("zip/rejects_stored_entry_with_mismatched_size") {
+    // 声明的未压缩大小远大于实际数据，按size复制会越过映射区末尾
+    fixtures::ZipFileSpec spec{"lib/modules", fixtures::make_data(4096, 3), true, 1 << 30};
+    std::string error;
+    EXPECT(!extract({spec}, error));
+    EXPECT(error.find("size mismatch") != std::string::npos);
+    EXPECT(!std::filesystem::exists(host_test::case_dir() + "/out/lib/modules"));
+}
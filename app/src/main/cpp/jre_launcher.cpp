@@ -15,6 +15,8 @@
 #include <poll.h>
 
 #include "android_log.hpp"
+#include "launch_spec.hpp"
+#include "trace_ring.hpp"
 
 static volatile sig_atomic_t child_pid = -1;
 static volatile sig_atomic_t signal_received = 0;
@@ -83,6 +85,9 @@ static int launchJvm(char **argv) {
     int flags = fcntl(pipefd[0], F_GETFL, 0);
     fcntl(pipefd[0], F_SETFL, flags | O_NONBLOCK);
 
+    // 子进程继承追踪缓冲区的fd，Agent写入前先清空上一次运行留下的事件
+    trace::reset_child_region();
+
     pid_t pid = fork();
 
     if (pid == -1) {
@@ -110,6 +115,11 @@ static int launchJvm(char **argv) {
         child_pid = pid;
         close(pipefd[1]);
 
+        trace::set_child_pid(pid);
+        trace::instant(trace::Name::LauncherFork, 0, pid);
+        trace::Slice jvm_slice(trace::Name::LauncherJvm, 0, pid);
+        bool first_output = true;
+
         char buffer[1024];
         ssize_t bytes_read;
         struct pollfd fds[1];
@@ -149,6 +159,10 @@ static int launchJvm(char **argv) {
             if (fds[0].revents & POLLIN) {
                 bytes_read = read(pipefd[0], buffer, sizeof(buffer));
                 if (bytes_read > 0) {
+                    if (first_output) {
+                        trace::instant(trace::Name::LauncherFirstOutput, 0, pid);
+                        first_output = false;
+                    }
                     if (write(STDOUT_FILENO, buffer, bytes_read) == -1) {
                         if (errno == EPIPE) {
                             break;
@@ -209,6 +223,7 @@ static int launchJvm(char **argv) {
         }
 
         child_pid = -1;
+        trace::instant(trace::Name::LauncherExit, 0, status);
 
         if (WIFSIGNALED(status)) {
             fprintf(stderr, "Child process terminated by signal: %d\n", WTERMSIG(status));
@@ -267,17 +282,14 @@ Java_io_github_eurya_awt_utils_NativeJavaLauncher_nativeLaunchJvm(JNIEnv *env, j
         return -1;
     }
 
-    std::vector<std::string> args;
-    std::vector<char *> argv;
-
-    args.reserve(argc);
-    argv.reserve(argc + 1);  // +1 for null terminator
+    LaunchSpec spec;
+    spec.reserve(argc);
 
     for (jsize i = 0; i < argc; i++) {
         auto str = reinterpret_cast<jstring>(env->GetObjectArrayElement(jargs, i));
         if (str == nullptr) {
             android_println(LogType::DEBUG, "Warning: Argument {} is null, using empty string", i);
-            args.emplace_back("");
+            spec.add("");
             continue;
         }
 
@@ -288,19 +300,14 @@ Java_io_github_eurya_awt_utils_NativeJavaLauncher_nativeLaunchJvm(JNIEnv *env, j
             return -1;
         }
 
-        args.emplace_back(utf_chars);
+        spec.add(utf_chars);
         env->ReleaseStringUTFChars(str, utf_chars);
         env->DeleteLocalRef(str);
     }
 
-    for (auto &arg: args) {
-        argv.push_back(const_cast<char *>(arg.c_str()));
-    }
-    argv.push_back(nullptr);  // null terminator
-
     android_println("Prepared {} arguments for JVM launch:", argc);
 
-    int result = launchJvm(argv.data());
+    int result = launchJvm(spec.argv());
 
     android_println("JVM execution completed with result: {}", result);
     return result;
@@ -0,0 +1,23 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#include "launch_spec.hpp"
+
+void LaunchSpec::reserve(size_t count) {
+    args_.reserve(count);
+    argv_.reserve(count + 1);  // +1 for null terminator
+}
+
+void LaunchSpec::add(std::string_view arg) {
+    args_.emplace_back(arg);
+}
+
+char **LaunchSpec::argv() {
+    argv_.clear();
+    for (auto &arg: args_) {
+        argv_.push_back(arg.data());
+    }
+    argv_.push_back(nullptr);  // null terminator
+    return argv_.data();
+}
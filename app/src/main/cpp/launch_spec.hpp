@@ -0,0 +1,44 @@
+//
+// Created by qz919 on 2025/10/5.
+//
+
+#ifndef LAUNCH_SPEC_HPP
+#define LAUNCH_SPEC_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * JVM启动参数
+ *
+ * 持有Java层传来的参数字符串，并生成execvp需要的以nullptr结尾的argv。
+ * argv在所有参数添加完成后一次性生成，添加参数时字符串可能被移动，之前取得的指针会失效
+ *
+ * 该类不依赖JNI，主机基准测试直接用字符串数组构造
+ */
+class LaunchSpec {
+public:
+    /** 预留参数个数，避免逐个添加时扩容 */
+    void reserve(size_t count);
+
+    /** 追加一个参数 */
+    void add(std::string_view arg);
+
+    [[nodiscard]] size_t size() const { return args_.size(); }
+    [[nodiscard]] const std::vector<std::string> &args() const { return args_; }
+
+    /**
+     * 生成以nullptr结尾的argv，指向内部的参数字符串
+     *
+     * @return argv，在下一次add()之前有效
+     */
+    char **argv();
+
+private:
+    std::vector<std::string> args_;
+    std::vector<char *> argv_;
+};
+
+#endif // LAUNCH_SPEC_HPP
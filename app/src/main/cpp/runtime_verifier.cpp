@@ -0,0 +1,192 @@
+//
+// Created by qz919 on 2025/10/4.
+//
+
+#include "runtime_verifier.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace {
+
+constexpr const char *kCacheHeader = "# runtime verify cache v1";
+
+// 一次交给zlib的最大长度，crc32的长度参数是uInt
+constexpr uint64_t kCrcChunk = 1u << 30;
+
+struct FileStamp {
+    uint64_t inode = 0;
+    uint64_t size = 0;
+    int64_t mtime_sec = 0;
+    int64_t mtime_nsec = 0;
+
+    bool operator==(const FileStamp &other) const {
+        return inode == other.inode && size == other.size && mtime_sec == other.mtime_sec &&
+               mtime_nsec == other.mtime_nsec;
+    }
+};
+
+struct CacheEntry {
+    FileStamp stamp;
+    uint32_t crc = 0;
+};
+
+FileStamp to_stamp(const struct stat &st) {
+    FileStamp stamp;
+    stamp.inode = static_cast<uint64_t>(st.st_ino);
+    stamp.size = static_cast<uint64_t>(st.st_size);
+    stamp.mtime_sec = static_cast<int64_t>(st.st_mtim.tv_sec);
+    stamp.mtime_nsec = static_cast<int64_t>(st.st_mtim.tv_nsec);
+    return stamp;
+}
+
+// 缓存格式: inode \t size \t mtime秒 \t mtime纳秒 \t crc(十六进制) \t 路径
+std::unordered_map<std::string, CacheEntry> load_cache(const std::string &path) {
+    std::unordered_map<std::string, CacheEntry> cache;
+    FILE *file = fopen(path.c_str(), "re");
+    if (file == nullptr) return cache;
+
+    char *line = nullptr;
+    size_t capacity = 0;
+    ssize_t length = getline(&line, &capacity, file);
+    bool valid = length > 0 && std::string(line, length).rfind(kCacheHeader, 0) == 0;
+    while (valid && (length = getline(&line, &capacity, file)) > 0) {
+        if (line[length - 1] == '\n') line[--length] = '\0';
+        CacheEntry entry;
+        int name_offset = 0;
+        if (sscanf(line, "%" SCNu64 "\t%" SCNu64 "\t%" SCNd64 "\t%" SCNd64 "\t%" SCNx32 "\t%n",
+                   &entry.stamp.inode, &entry.stamp.size, &entry.stamp.mtime_sec,
+                   &entry.stamp.mtime_nsec, &entry.crc, &name_offset) != 5 || name_offset == 0) {
+            continue;
+        }
+        cache.emplace(std::string(line + name_offset), entry);
+    }
+    free(line);
+    fclose(file);
+    return cache;
+}
+
+void store_cache(const std::string &path, const std::unordered_map<std::string, CacheEntry> &entries) {
+    std::string temp = path + ".tmp";
+    FILE *file = fopen(temp.c_str(), "we");
+    if (file == nullptr) return;
+    fprintf(file, "%s\n", kCacheHeader);
+    for (const auto &[name, entry]: entries) {
+        fprintf(file, "%" PRIu64 "\t%" PRIu64 "\t%" PRId64 "\t%" PRId64 "\t%" PRIx32 "\t%s\n",
+                entry.stamp.inode, entry.stamp.size, entry.stamp.mtime_sec, entry.stamp.mtime_nsec,
+                entry.crc, name.c_str());
+    }
+    bool ok = fflush(file) == 0;
+    ok = fclose(file) == 0 && ok;
+    if (!ok || rename(temp.c_str(), path.c_str()) != 0) {
+        unlink(temp.c_str());
+    }
+}
+
+} // namespace
+
+RuntimeVerifier::RuntimeVerifier(std::string root, std::string cache_path, unsigned workers)
+        : root_(std::move(root)), cache_path_(std::move(cache_path)),
+          workers_(std::max(1u, workers)) {}
+
+bool RuntimeVerifier::file_crc32(int fd, uint64_t size, uint32_t &crc) {
+    uLong value = crc32(0L, Z_NULL, 0);
+    if (size == 0) {
+        crc = static_cast<uint32_t>(value);
+        return true;
+    }
+    void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) return false;
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    auto data = static_cast<const Bytef *>(mapped);
+    for (uint64_t offset = 0; offset < size; offset += kCrcChunk) {
+        auto chunk = static_cast<uInt>(std::min(size - offset, kCrcChunk));
+        value = crc32(value, data + offset, chunk);
+    }
+    munmap(mapped, size);
+    crc = static_cast<uint32_t>(value);
+    return true;
+}
+
+std::vector<std::string> RuntimeVerifier::verify(const std::vector<Item> &items, Mode mode) {
+    // kFull同样加载缓存：调用方可能只传入部分文件，其余文件的缓存条目需要原样保留
+    auto cache = load_cache(cache_path_);
+
+    std::vector<std::string> result;
+    std::vector<std::pair<const std::string *, CacheEntry>> verified;
+    std::vector<const Item *> pending;
+
+    // 热路径：每个文件一次stat，元数据与缓存一致且CRC等于期望值即视为完好
+    for (const Item &item: items) {
+        struct stat st{};
+        std::string path = root_ + "/" + item.name;
+        if (stat(path.c_str(), &st) != 0 || static_cast<uint64_t>(st.st_size) != item.size) {
+            result.push_back(item.name);
+            continue;
+        }
+        auto it = mode == Mode::kFull ? cache.end() : cache.find(item.name);
+        if (it != cache.end() && it->second.stamp == to_stamp(st) && it->second.crc == item.crc) {
+            continue;
+        }
+        if (mode == Mode::kStatOnly) {
+            result.push_back(item.name);
+        } else {
+            pending.push_back(&item);
+        }
+    }
+    if (mode == Mode::kStatOnly) return result;
+
+    // 大文件优先，避免最后只剩一个线程在算libjvm.so或lib/modules
+    std::sort(pending.begin(), pending.end(),
+              [](const Item *a, const Item *b) { return a->size > b->size; });
+
+    std::mutex mutex;
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next.fetch_add(1); i < pending.size(); i = next.fetch_add(1)) {
+            const Item &item = *pending[i];
+            std::string path = root_ + "/" + item.name;
+            int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat st{};
+            uint32_t crc = 0;
+            bool ok = fd >= 0 && fstat(fd, &st) == 0 &&
+                      static_cast<uint64_t>(st.st_size) == item.size &&
+                      file_crc32(fd, item.size, crc) && crc == item.crc;
+            if (fd >= 0) close(fd);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ok) {
+                verified.emplace_back(&item.name, CacheEntry{to_stamp(st), crc});
+            } else {
+                result.push_back(item.name);
+            }
+        }
+    };
+
+    unsigned count = std::min<unsigned>(workers_, std::max<size_t>(pending.size(), 1));
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < count; ++i) threads.emplace_back(worker);
+    worker();
+    for (auto &thread: threads) thread.join();
+
+    // 合并进已有缓存：只更新本次计算过的文件并删除校验失败的文件，未传入的文件保持不变
+    if (!pending.empty() || !result.empty()) {
+        for (const auto &[name, entry]: verified) cache[*name] = entry;
+        for (const std::string &name: result) cache.erase(name);
+        store_cache(cache_path_, cache);
+    }
+    return result;
+}
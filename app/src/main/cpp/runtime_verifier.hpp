@@ -0,0 +1,58 @@
+//
+// Created by qz919 on 2025/10/4.
+//
+
+#ifndef RUNTIME_VERIFIER_HPP
+#define RUNTIME_VERIFIER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 已解压运行库的完整性校验器
+ *
+ * 期望值是归档中央目录里的CRC32（与运行库清单一致），校验时把文件mmap后交给zlib的crc32，
+ * 在支持CRC指令的CPU上由硬件加速。多个文件在线程池中并行计算。
+ *
+ * 校验通过的文件连同(inode, size, mtime)写入缓存，元数据未变的文件在下次启动时只需要一次stat，
+ * 因此热路径的开销只是几百次stat调用。
+ *
+ * 该类不依赖JNI和Android API
+ */
+class RuntimeVerifier {
+public:
+    struct Item {
+        std::string name;   // 相对运行时目录的路径
+        uint32_t crc = 0;   // 期望的CRC32
+        uint64_t size = 0;  // 期望的大小
+    };
+
+    enum class Mode {
+        kStatOnly,  // 只比较元数据和缓存，不读文件；返回需要重新计算的文件
+        kChanged,   // 只对元数据与缓存不符的文件计算CRC；返回损坏的文件
+        kFull,      // 忽略缓存对所有文件计算CRC；返回损坏的文件
+    };
+
+    RuntimeVerifier(std::string root, std::string cache_path, unsigned workers);
+
+    /**
+     * 按指定模式校验文件
+     *
+     * kChanged和kFull把本次计算过的文件合并进缓存：校验通过的更新条目，失败的删除条目，
+     * 未传入的文件保留原有条目，因此只校验部分文件不会让其余文件在下次启动时重新计算
+     *
+     * @return kStatOnly时为需要重新计算的文件，其余模式为缺失、大小不符或CRC不符的文件
+     */
+    std::vector<std::string> verify(const std::vector<Item> &items, Mode mode);
+
+    /** 计算文件内容的CRC32，失败时返回false */
+    static bool file_crc32(int fd, uint64_t size, uint32_t &crc);
+
+private:
+    std::string root_;
+    std::string cache_path_;
+    unsigned workers_;
+};
+
+#endif // RUNTIME_VERIFIER_HPP
@@ -0,0 +1,33 @@
+//
+// Created by qz919 on 2025/10/6.
+//
+
+#include <jni.h>
+
+#include <string>
+
+#include "trace_ring.hpp"
+
+extern "C" JNIEXPORT jint JNICALL
+Java_io_github_eurya_awt_utils_Tracing_nativeStart(JNIEnv *env, jclass thiz, jint slots) {
+    if (slots <= 0) return -1;
+    return trace::start(static_cast<uint32_t>(slots));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_io_github_eurya_awt_utils_Tracing_nativeRecord(JNIEnv *env, jclass thiz, jint name, jint phase,
+                                                    jlong ts_ns, jlong dur_ns, jlong flow, jint arg) {
+    trace::record(static_cast<trace::Name>(name), static_cast<trace::Phase>(phase),
+                  static_cast<uint64_t>(ts_ns), static_cast<uint64_t>(dur_ns),
+                  static_cast<uint64_t>(flow), arg);
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_io_github_eurya_awt_utils_Tracing_nativeExport(JNIEnv *env, jclass thiz, jstring jpath,
+                                                    jboolean perfetto) {
+    const char *path = env->GetStringUTFChars(jpath, nullptr);
+    std::string target(path);
+    env->ReleaseStringUTFChars(jpath, path);
+
+    return trace::export_to(target, perfetto ? trace::Format::Perfetto : trace::Format::ChromeJson);
+}
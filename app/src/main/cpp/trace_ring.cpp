@@ -0,0 +1,488 @@
+//
+// Created by qz919 on 2025/10/6.
+//
+
+#include "trace_ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "android_log.hpp"
+
+namespace trace {
+
+namespace {
+
+struct Slot {
+    uint32_t seq;
+    uint16_t name;
+    uint8_t phase;
+    uint8_t reserved;
+    int32_t tid;
+    int32_t arg;
+    uint64_t ts;
+    uint64_t dur;
+    uint64_t flow;
+};
+static_assert(sizeof(Slot) == kSlotSize, "槽位布局必须与Java端一致");
+
+struct Event {
+    int pid;
+    Slot slot;
+};
+
+std::mutex start_mutex;
+std::atomic<bool> is_enabled{false};
+int ring_fd = -1;
+uint8_t *ring_base = nullptr;
+uint32_t ring_slots = 0;
+
+uint8_t *region_base(uint32_t region) {
+    return ring_base + kHeaderSize + region * (kRegionHeaderSize + ring_slots * kSlotSize);
+}
+
+uint64_t *region_next(uint32_t region) {
+    return reinterpret_cast<uint64_t *>(region_base(region));
+}
+
+int32_t *region_pid(uint32_t region) {
+    return reinterpret_cast<int32_t *>(region_base(region) + 8);
+}
+
+Slot *slot_at(uint32_t region, uint64_t index) {
+    return reinterpret_cast<Slot *>(region_base(region) + kRegionHeaderSize + (index % ring_slots) * kSlotSize);
+}
+
+const char *name_of(uint16_t name) {
+    switch (static_cast<Name>(name)) {
+        case Name::ThreadName:          return "thread_name";
+        case Name::LauncherJvm:         return "launcher.jvm";
+        case Name::LauncherFork:        return "launcher.fork";
+        case Name::LauncherFirstOutput: return "launcher.first_output";
+        case Name::LauncherExit:        return "launcher.exit";
+        case Name::AgentCapture:        return "agent.capture";
+        case Name::AgentEncode:         return "agent.encode";
+        case Name::AgentSend:           return "agent.send";
+        case Name::AgentDispatch:       return "agent.dispatch";
+        case Name::AgentServerStart:    return "agent.server_start";
+        case Name::ViewerReceive:       return "viewer.receive";
+        case Name::ViewerDecode:        return "viewer.decode";
+        case Name::ViewerDraw:          return "viewer.draw";
+        case Name::ViewerInput:         return "viewer.input";
+        default:                        return "unknown";
+    }
+}
+
+std::string category_of(uint16_t name) {
+    std::string full = name_of(name);
+    return full.substr(0, full.find('.'));
+}
+
+std::string flow_label(uint64_t flow) {
+    uint64_t id = flow & ((1ULL << 56) - 1);
+    if ((flow & ~((1ULL << 56) - 1)) == kFlowFrame) return "frame " + std::to_string(id);
+    if ((flow & ~((1ULL << 56) - 1)) == kFlowInput) return "input " + std::to_string(id);
+    return "flow " + std::to_string(flow);
+}
+
+std::string read_first_line(const std::string &path) {
+    std::ifstream input(path);
+    std::string line;
+    std::getline(input, line, '\n');
+    // cmdline以'\0'分隔参数，只保留程序名
+    return line.substr(0, line.find('\0'));
+}
+
+uint64_t boottime_offset() {
+    timespec boot{}, mono{};
+    clock_gettime(CLOCK_BOOTTIME, &boot);
+    clock_gettime(CLOCK_MONOTONIC, &mono);
+    int64_t boot_ns = static_cast<int64_t>(boot.tv_sec) * 1000000000LL + boot.tv_nsec;
+    int64_t mono_ns = static_cast<int64_t>(mono.tv_sec) * 1000000000LL + mono.tv_nsec;
+    return static_cast<uint64_t>(boot_ns - mono_ns);
+}
+
+/** 按seqlock规则复制两个区域中所有完整的槽位 */
+std::vector<Event> collect(std::map<std::pair<int, int>, std::string> &thread_names) {
+    std::vector<Event> events;
+    for (uint32_t region = 0; region < kRegionCount; region++) {
+        int pid = __atomic_load_n(region_pid(region), __ATOMIC_ACQUIRE);
+        if (pid <= 0) continue;
+        for (uint64_t i = 0; i < ring_slots; i++) {
+            Slot *shared = slot_at(region, i);
+            uint32_t before = __atomic_load_n(&shared->seq, __ATOMIC_ACQUIRE);
+            if (before == 0) continue;
+            Slot copy{};
+            memcpy(&copy, shared, sizeof(Slot));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (__atomic_load_n(&shared->seq, __ATOMIC_RELAXED) != before || copy.seq != before) continue;
+
+            if (copy.phase == static_cast<uint8_t>(Phase::ThreadName)) {
+                char name[kThreadNameBytes + 1]{};
+                memcpy(name, &copy.ts, kThreadNameBytes);
+                thread_names[{pid, copy.tid}] = name;
+                continue;
+            }
+            events.push_back({pid, copy});
+        }
+    }
+    std::sort(events.begin(), events.end(),
+              [](const Event &a, const Event &b) { return a.slot.ts < b.slot.ts; });
+
+    // 应用进程的线程名直接从/proc读取，线程已退出时退化为tid
+    int self = getpid();
+    for (const Event &event: events) {
+        auto key = std::make_pair(event.pid, event.slot.tid);
+        if (thread_names.count(key)) continue;
+        std::string comm;
+        if (event.pid == self) {
+            comm = read_first_line("/proc/self/task/" + std::to_string(event.slot.tid) + "/comm");
+        }
+        thread_names[key] = comm.empty() ? "thread " + std::to_string(event.slot.tid) : comm;
+    }
+    return events;
+}
+
+std::string process_name(int pid) {
+    if (pid == getpid()) {
+        std::string name = read_first_line("/proc/self/cmdline");
+        return name.empty() ? "app" : name;
+    }
+    return "jvm";
+}
+
+std::string json_escape(const std::string &value) {
+    std::string result;
+    for (char c: value) {
+        if (c == '"' || c == '\\') {
+            result.push_back('\\');
+            result.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buffer[8];
+            snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+            result += buffer;
+        } else {
+            result.push_back(c);
+        }
+    }
+    return result;
+}
+
+bool write_json(FILE *file, const std::vector<Event> &events,
+                const std::map<std::pair<int, int>, std::string> &thread_names) {
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) fputs(",\n", file);
+        first = false;
+    };
+
+    std::map<int, bool> processes;
+    for (const auto &[key, name]: thread_names) {
+        if (!processes[key.first]) {
+            processes[key.first] = true;
+            separator();
+            fprintf(file, R"({"ph":"M","name":"process_name","pid":%d,"tid":0,"args":{"name":"%s"}})",
+                    key.first, json_escape(process_name(key.first)).c_str());
+        }
+        separator();
+        fprintf(file, R"({"ph":"M","name":"thread_name","pid":%d,"tid":%d,"args":{"name":"%s"}})",
+                key.first, key.second, json_escape(name).c_str());
+    }
+
+    // 同一流ID的事件按时间串联：第一个为s，最后一个为f，中间为t
+    std::map<uint64_t, std::pair<size_t, size_t>> flow_bounds;
+    for (size_t i = 0; i < events.size(); i++) {
+        uint64_t flow = events[i].slot.flow;
+        if (flow == 0) continue;
+        auto it = flow_bounds.find(flow);
+        if (it == flow_bounds.end()) flow_bounds[flow] = {i, i};
+        else it->second.second = i;
+    }
+
+    for (size_t i = 0; i < events.size(); i++) {
+        const Event &event = events[i];
+        const Slot &slot = event.slot;
+        double ts_us = static_cast<double>(slot.ts) / 1000.0;
+        separator();
+        if (slot.phase == static_cast<uint8_t>(Phase::Complete)) {
+            fprintf(file, R"({"ph":"X","name":"%s","cat":"%s","pid":%d,"tid":%d,"ts":%.3f,"dur":%.3f,)",
+                    name_of(slot.name), category_of(slot.name).c_str(), event.pid, slot.tid, ts_us,
+                    static_cast<double>(slot.dur) / 1000.0);
+        } else {
+            fprintf(file, R"({"ph":"i","s":"t","name":"%s","cat":"%s","pid":%d,"tid":%d,"ts":%.3f,)",
+                    name_of(slot.name), category_of(slot.name).c_str(), event.pid, slot.tid, ts_us);
+        }
+        if (slot.flow != 0) {
+            fprintf(file, R"("args":{"arg":%d,"flow":"%s"}})", slot.arg, flow_label(slot.flow).c_str());
+        } else {
+            fprintf(file, R"("args":{"arg":%d}})", slot.arg);
+        }
+
+        if (slot.flow == 0) continue;
+        const auto &bounds = flow_bounds[slot.flow];
+        if (bounds.first == bounds.second) continue;
+        const char *phase = i == bounds.first ? "s" : i == bounds.second ? "f" : "t";
+        separator();
+        fprintf(file, R"({"ph":"%s","id":"0x%llx","name":"%s","cat":"flow","pid":%d,"tid":%d,"ts":%.3f%s})",
+                phase, static_cast<unsigned long long>(slot.flow), flow_label(slot.flow).c_str(),
+                event.pid, slot.tid, ts_us, phase[0] == 's' ? "" : R"(,"bp":"e")");
+    }
+    fprintf(file, "\n]}\n");
+    return true;
+}
+
+/** 最小的protobuf编码器，只覆盖Perfetto TracePacket需要的字段类型 */
+class Proto {
+public:
+    void varint(uint32_t field, uint64_t value) {
+        tag(field, 0);
+        raw_varint(value);
+    }
+
+    void fixed64(uint32_t field, uint64_t value) {
+        tag(field, 1);
+        for (int i = 0; i < 8; i++) buffer_.push_back(static_cast<char>(value >> (i * 8)));
+    }
+
+    void bytes(uint32_t field, const std::string &value) {
+        tag(field, 2);
+        raw_varint(value.size());
+        buffer_ += value;
+    }
+
+    void message(uint32_t field, const Proto &value) { bytes(field, value.buffer_); }
+
+    const std::string &data() const { return buffer_; }
+
+private:
+    void tag(uint32_t field, uint32_t wire_type) { raw_varint((field << 3) | wire_type); }
+
+    void raw_varint(uint64_t value) {
+        while (value >= 0x80) {
+            buffer_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        buffer_.push_back(static_cast<char>(value));
+    }
+
+    std::string buffer_;
+};
+
+// Perfetto trace.proto中用到的字段编号
+constexpr uint32_t kTracePacket = 1;
+constexpr uint32_t kPacketTimestamp = 8;
+constexpr uint32_t kPacketSequenceId = 10;
+constexpr uint32_t kPacketTrackEvent = 11;
+constexpr uint32_t kPacketSequenceFlags = 13;
+constexpr uint32_t kPacketTrackDescriptor = 60;
+constexpr uint32_t kTrackUuid = 1;
+constexpr uint32_t kTrackName = 2;
+constexpr uint32_t kTrackProcess = 3;
+constexpr uint32_t kTrackParentUuid = 5;
+constexpr uint32_t kProcessPid = 1;
+constexpr uint32_t kProcessName = 6;
+constexpr uint32_t kEventDebugAnnotation = 4;
+constexpr uint32_t kEventType = 9;
+constexpr uint32_t kEventTrackUuid = 11;
+constexpr uint32_t kEventCategory = 22;
+constexpr uint32_t kEventName = 23;
+constexpr uint32_t kEventFlowIds = 47;
+constexpr uint32_t kAnnotationIntValue = 4;
+constexpr uint32_t kAnnotationName = 10;
+constexpr uint64_t kTypeSliceBegin = 1;
+constexpr uint64_t kTypeSliceEnd = 2;
+constexpr uint64_t kTypeInstant = 3;
+constexpr uint64_t kSequenceId = 1;
+constexpr uint64_t kIncrementalStateCleared = 1;
+
+uint64_t process_uuid(int pid) { return static_cast<uint64_t>(pid) << 32; }
+
+uint64_t thread_uuid(int pid, int tid) { return process_uuid(pid) | static_cast<uint32_t>(tid); }
+
+void write_packet(FILE *file, const Proto &packet) {
+    Proto trace;
+    trace.message(kTracePacket, packet);
+    fwrite(trace.data().data(), 1, trace.data().size(), file);
+}
+
+bool write_perfetto(FILE *file, const std::vector<Event> &events,
+                    const std::map<std::pair<int, int>, std::string> &thread_names) {
+    std::map<int, bool> processes;
+    bool first_packet = true;
+    for (const auto &[key, name]: thread_names) {
+        if (!processes[key.first]) {
+            processes[key.first] = true;
+            Proto process;
+            process.varint(kProcessPid, static_cast<uint64_t>(key.first));
+            process.bytes(kProcessName, process_name(key.first));
+            Proto track;
+            track.varint(kTrackUuid, process_uuid(key.first));
+            track.message(kTrackProcess, process);
+            Proto packet;
+            packet.varint(kPacketSequenceId, kSequenceId);
+            if (first_packet) packet.varint(kPacketSequenceFlags, kIncrementalStateCleared);
+            first_packet = false;
+            packet.message(kPacketTrackDescriptor, track);
+            write_packet(file, packet);
+        }
+        // Java线程ID不是系统tid，因此统一使用进程下的命名轨道而不是ThreadDescriptor
+        Proto track;
+        track.varint(kTrackUuid, thread_uuid(key.first, key.second));
+        track.varint(kTrackParentUuid, process_uuid(key.first));
+        track.bytes(kTrackName, name);
+        Proto packet;
+        packet.varint(kPacketSequenceId, kSequenceId);
+        packet.message(kPacketTrackDescriptor, track);
+        write_packet(file, packet);
+    }
+
+    // Perfetto默认使用BOOTTIME时钟
+    uint64_t offset = boottime_offset();
+    auto emit = [&](const Event &event, uint64_t type, uint64_t ts, bool with_details) {
+        Proto track_event;
+        track_event.varint(kEventType, type);
+        track_event.varint(kEventTrackUuid, thread_uuid(event.pid, event.slot.tid));
+        if (with_details) {
+            track_event.bytes(kEventCategory, category_of(event.slot.name));
+            track_event.bytes(kEventName, name_of(event.slot.name));
+            if (event.slot.flow != 0) track_event.fixed64(kEventFlowIds, event.slot.flow);
+            if (event.slot.arg != 0) {
+                Proto annotation;
+                annotation.bytes(kAnnotationName, "arg");
+                annotation.varint(kAnnotationIntValue, static_cast<uint64_t>(static_cast<int64_t>(event.slot.arg)));
+                track_event.message(kEventDebugAnnotation, annotation);
+            }
+        }
+        Proto packet;
+        packet.varint(kPacketTimestamp, ts + offset);
+        packet.varint(kPacketSequenceId, kSequenceId);
+        packet.message(kPacketTrackEvent, track_event);
+        write_packet(file, packet);
+    };
+
+    for (const Event &event: events) {
+        if (event.slot.phase == static_cast<uint8_t>(Phase::Complete)) {
+            emit(event, kTypeSliceBegin, event.slot.ts, true);
+            emit(event, kTypeSliceEnd, event.slot.ts + event.slot.dur, false);
+        } else {
+            emit(event, kTypeInstant, event.slot.ts, true);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int start(uint32_t slots) {
+    std::lock_guard<std::mutex> lock(start_mutex);
+    if (ring_fd >= 0) return ring_fd;
+    if (slots == 0) return -1;
+
+    // 不带MFD_CLOEXEC，JVM子进程exec后仍可通过/proc/self/fd访问
+    int fd = static_cast<int>(syscall(__NR_memfd_create, "my_awt_trace", 0));
+    if (fd < 0) {
+        android_println(LogType::ERROR, "memfd_create failed: {}", strerror(errno));
+        return -1;
+    }
+
+    size_t size = kHeaderSize + kRegionCount * (kRegionHeaderSize + static_cast<size_t>(slots) * kSlotSize);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        android_println(LogType::ERROR, "ftruncate trace buffer failed: {}", strerror(errno));
+        close(fd);
+        return -1;
+    }
+    void *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        android_println(LogType::ERROR, "mmap trace buffer failed: {}", strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    ring_base = static_cast<uint8_t *>(base);
+    ring_slots = slots;
+    auto *header = reinterpret_cast<uint32_t *>(ring_base);
+    header[0] = kMagic;
+    header[1] = kVersion;
+    header[2] = slots;
+    header[3] = kRegionCount;
+    *region_pid(kRegionApp) = getpid();
+
+    ring_fd = fd;
+    is_enabled.store(true, std::memory_order_release);
+    android_println(LogType::SUCCESS, "Trace ring started: fd={}, {} slots per region, {} KB",
+                    fd, slots, size / 1024);
+    return fd;
+}
+
+bool enabled() {
+    return is_enabled.load(std::memory_order_acquire);
+}
+
+int fd() {
+    return enabled() ? ring_fd : -1;
+}
+
+void record(Name name, Phase phase, uint64_t ts_ns, uint64_t dur_ns, uint64_t flow, int32_t arg) {
+    if (!enabled()) return;
+
+    uint64_t index = __atomic_fetch_add(region_next(kRegionApp), 1, __ATOMIC_RELAXED);
+    Slot *slot = slot_at(kRegionApp, index);
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->name = static_cast<uint16_t>(name);
+    slot->phase = static_cast<uint8_t>(phase);
+    slot->reserved = 0;
+    slot->tid = gettid();
+    slot->arg = arg;
+    slot->ts = ts_ns;
+    slot->dur = dur_ns;
+    slot->flow = flow;
+
+    auto seq = static_cast<uint32_t>(index + 1);
+    __atomic_store_n(&slot->seq, seq == 0 ? 1 : seq, __ATOMIC_RELEASE);
+}
+
+void reset_child_region() {
+    if (!enabled()) return;
+    __atomic_store_n(region_pid(kRegionJvm), 0, __ATOMIC_RELEASE);
+    memset(region_base(kRegionJvm) + kRegionHeaderSize, 0, ring_slots * kSlotSize);
+    __atomic_store_n(region_next(kRegionJvm), 0, __ATOMIC_RELEASE);
+}
+
+void set_child_pid(int pid) {
+    if (!enabled()) return;
+    __atomic_store_n(region_pid(kRegionJvm), pid, __ATOMIC_RELEASE);
+}
+
+long export_to(const std::string &path, Format format) {
+    if (!enabled()) return -1;
+
+    std::map<std::pair<int, int>, std::string> thread_names;
+    std::vector<Event> events = collect(thread_names);
+
+    FILE *file = fopen(path.c_str(), format == Format::Perfetto ? "wb" : "w");
+    if (file == nullptr) {
+        android_println(LogType::ERROR, "Failed to open trace file {}: {}", path, strerror(errno));
+        return -1;
+    }
+    bool ok = format == Format::Perfetto ? write_perfetto(file, events, thread_names)
+                                         : write_json(file, events, thread_names);
+    ok = fclose(file) == 0 && ok;
+    if (!ok) return -1;
+
+    android_println(LogType::SUCCESS, "Exported {} trace events to {}", events.size(), path);
+    return static_cast<long>(events.size());
+}
+
+} // namespace trace
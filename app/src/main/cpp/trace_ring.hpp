@@ -0,0 +1,149 @@
+//
+// Created by qz919 on 2025/10/6.
+//
+
+#ifndef MY_AWT_TRACE_RING_HPP
+#define MY_AWT_TRACE_RING_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+/**
+ * 跨进程追踪环形缓冲区
+ *
+ * 缓冲区位于memfd共享内存中，分为两个区域：区域0由应用进程（启动器和查看器）写入，
+ * 区域1由JVM子进程中的Agent写入。memfd不带CLOEXEC，fork/exec后子进程通过
+ * /proc/self/fd/N映射同一块内存，因此不需要任何额外的收集步骤
+ *
+ * 所有时间戳使用CLOCK_MONOTONIC，与Java的System.nanoTime一致。导出时转换为
+ * Chrome JSON或Perfetto protobuf，可直接在ui.perfetto.dev中打开
+ *
+ * 布局（小端）：
+ *   文件头 64字节: magic u32, version u32, slots u32（每个区域的槽位数）, regions u32
+ *   每个区域: 区域头 64字节（next u64, pid i32），随后是slots个40字节的槽位
+ *   槽位: seq u32, name u16, phase u8, 保留u8, tid i32, arg i32, ts u64, dur u64, flow u64
+ *
+ * seq在写入期间为0，写完后置为写入序号+1，读取端前后两次读到相同的非0值才接受该槽位。
+ * 线程名记录（phase 'M'）把最多24字节的UTF-8名称存放在ts/dur/flow的位置
+ *
+ * 修改布局时需同步cacio-argent中的TraceRing.java和应用中的Tracing.kt
+ */
+namespace trace {
+
+constexpr uint32_t kMagic = 0x5254414d; // "MATR"
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kRegionCount = 2;
+constexpr size_t kHeaderSize = 64;
+constexpr size_t kRegionHeaderSize = 64;
+constexpr size_t kSlotSize = 40;
+constexpr size_t kThreadNameBytes = 24;
+
+/** 区域编号 */
+enum Region : uint32_t {
+    kRegionApp = 0,
+    kRegionJvm = 1,
+};
+
+/** 事件类型 */
+enum class Phase : uint8_t {
+    Complete = 'X',
+    Instant = 'i',
+    ThreadName = 'M',
+};
+
+/**
+ * 事件名称表，三个进程共用同一套编号，名称字符串只保存在导出端
+ */
+enum class Name : uint16_t {
+    ThreadName = 0,
+
+    LauncherJvm = 1,          // 从fork到子进程退出
+    LauncherFork = 2,         // arg为子进程pid
+    LauncherFirstOutput = 3,  // 首次收到子进程输出
+    LauncherExit = 4,         // arg为退出状态
+
+    AgentCapture = 10,
+    AgentEncode = 11,
+    AgentSend = 12,
+    AgentDispatch = 13,
+    AgentServerStart = 14,    // 从premain安排启动到服务器开始监听
+
+    ViewerReceive = 20,
+    ViewerDecode = 21,
+    ViewerDraw = 22,
+    ViewerInput = 23,
+};
+
+/** 流ID的高8位区分种类，低56位为各自的序号 */
+constexpr uint64_t kFlowFrame = 1ULL << 56;
+constexpr uint64_t kFlowInput = 2ULL << 56;
+
+/** 导出格式 */
+enum class Format {
+    ChromeJson,
+    Perfetto,
+};
+
+/** CLOCK_MONOTONIC纳秒 */
+inline uint64_t now_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * 创建共享缓冲区并开始记录，重复调用返回已有的fd
+ *
+ * @param slots 每个区域的槽位数
+ * @return memfd文件描述符，失败时返回-1
+ */
+int start(uint32_t slots);
+
+/** 是否正在记录 */
+bool enabled();
+
+/** 当前缓冲区的fd，未启用时为-1 */
+int fd();
+
+/** 写入应用进程区域 */
+void record(Name name, Phase phase, uint64_t ts_ns, uint64_t dur_ns, uint64_t flow = 0, int32_t arg = 0);
+
+inline void instant(Name name, uint64_t flow = 0, int32_t arg = 0) {
+    if (enabled()) record(name, Phase::Instant, now_ns(), 0, flow, arg);
+}
+
+/** 在启动JVM子进程前清空其区域，并记录子进程pid */
+void reset_child_region();
+void set_child_pid(int pid);
+
+/**
+ * 把两个区域中的事件导出到文件
+ *
+ * @return 写入的事件数，失败时返回-1
+ */
+long export_to(const std::string &path, Format format);
+
+/** 作用域内的耗时记录 */
+class Slice {
+public:
+    explicit Slice(Name name, uint64_t flow = 0, int32_t arg = 0)
+            : name_(name), flow_(flow), arg_(arg), start_(enabled() ? now_ns() : 0) {}
+
+    ~Slice() {
+        if (start_ != 0) record(name_, Phase::Complete, start_, now_ns() - start_, flow_, arg_);
+    }
+
+    Slice(const Slice &) = delete;
+    Slice &operator=(const Slice &) = delete;
+
+private:
+    Name name_;
+    uint64_t flow_;
+    int32_t arg_;
+    uint64_t start_;
+};
+
+} // namespace trace
+
+#endif // MY_AWT_TRACE_RING_HPP
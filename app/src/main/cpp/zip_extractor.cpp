@@ -0,0 +1,362 @@
+//
+// Created by qz919 on 2025/10/3.
+//
+
+#include "zip_extractor.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace {
+
+constexpr uint32_t kEocdSignature = 0x06054b50;
+constexpr uint32_t kCenSignature = 0x02014b50;
+constexpr uint32_t kLocSignature = 0x04034b50;
+constexpr size_t kEocdMinSize = 22;
+constexpr size_t kCenHeaderSize = 46;
+constexpr size_t kLocHeaderSize = 30;
+constexpr size_t kMaxCommentSize = 0xffff;
+
+constexpr uint16_t kMethodStored = 0;
+constexpr uint16_t kMethodDeflated = 8;
+
+// 超过该大小的条目单独作为一个任务，其余条目合并成批次
+constexpr uint64_t kLargeEntryBytes = 1u << 20;
+constexpr uint64_t kBatchBytes = 2u << 20;
+
+constexpr size_t kOutputBufferSize = 256 * 1024;
+
+inline uint16_t read_u16(const uint8_t *p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t read_u32(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+bool write_fully(int fd, const uint8_t *data, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd, data, size, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+} // namespace
+
+ZipExtractor::ZipExtractor(std::string target_dir, unsigned workers)
+        : target_dir_(std::move(target_dir)), workers_(std::max(1u, workers)) {}
+
+ZipExtractor::~ZipExtractor() = default;
+
+bool ZipExtractor::is_safe_entry_name(const std::string &name) {
+    if (name.empty() || name.front() == '/' || name.find('\0') != std::string::npos) {
+        return false;
+    }
+    size_t start = 0;
+    while (start <= name.size()) {
+        size_t end = name.find_first_of("/\\", start);
+        if (end == std::string::npos) end = name.size();
+        if (name.compare(start, end - start, "..") == 0 && end - start == 2) {
+            return false;
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+bool ZipExtractor::add_archive(std::string name, const uint8_t *data, size_t size,
+                               std::string &error,
+                               const std::unordered_set<std::string> *include) {
+    if (data == nullptr || size < kEocdMinSize) {
+        error = "archive too small: " + name;
+        return false;
+    }
+
+    // 从尾部向前查找中央目录结束记录，注释最长64KB
+    size_t tail = std::min(size, kEocdMinSize + kMaxCommentSize);
+    const uint8_t *eocd = nullptr;
+    for (size_t back = kEocdMinSize; back <= tail; ++back) {
+        if (read_u32(data + size - back) == kEocdSignature) {
+            eocd = data + size - back;
+            break;
+        }
+    }
+    if (eocd == nullptr) {
+        error = "end of central directory not found: " + name;
+        return false;
+    }
+
+    uint16_t count = read_u16(eocd + 10);
+    uint64_t cen_size = read_u32(eocd + 12);
+    uint64_t cen_offset = read_u32(eocd + 16);
+    if (count == 0xffff || cen_offset == 0xffffffffu || cen_offset + cen_size > size) {
+        error = "unsupported archive (zip64?): " + name;
+        return false;
+    }
+
+    auto archive = std::make_unique<Archive>();
+    archive->name = std::move(name);
+    archive->data = data;
+    archive->size = size;
+    size_t index = archives_.size();
+
+    std::vector<Entry> parsed;
+    parsed.reserve(count);
+    const uint8_t *p = data + cen_offset;
+    const uint8_t *end = p + cen_size;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (end - p < static_cast<ptrdiff_t>(kCenHeaderSize) || read_u32(p) != kCenSignature) {
+            error = "corrupt central directory: " + archive->name;
+            return false;
+        }
+        uint16_t version_made_by = read_u16(p + 4);
+        uint16_t flags = read_u16(p + 8);
+        Entry entry;
+        entry.method = read_u16(p + 10);
+        entry.compressed_size = read_u32(p + 20);
+        entry.size = read_u32(p + 24);
+        uint16_t name_length = read_u16(p + 28);
+        uint16_t extra_length = read_u16(p + 30);
+        uint16_t comment_length = read_u16(p + 32);
+        uint32_t external_attrs = read_u32(p + 38);
+        entry.local_header_offset = read_u32(p + 42);
+        entry.archive = index;
+
+        size_t record_size = kCenHeaderSize + name_length + extra_length + comment_length;
+        if (static_cast<size_t>(end - p) < record_size) {
+            error = "corrupt central directory: " + archive->name;
+            return false;
+        }
+        entry.name.assign(reinterpret_cast<const char *>(p + kCenHeaderSize), name_length);
+
+        if ((flags & 1) != 0 ||
+            (entry.method != kMethodStored && entry.method != kMethodDeflated)) {
+            error = "unsupported entry: " + entry.name;
+            return false;
+        }
+        if (!is_safe_entry_name(entry.name)) {
+            error = "unsafe zip entry: " + entry.name;
+            return false;
+        }
+        // 高字节为3表示由unix系统创建，外部属性的高16位是st_mode
+        if ((version_made_by >> 8) == 3) {
+            entry.mode = (external_attrs >> 16) & 0777;
+        }
+
+        p += record_size;
+        if (include != nullptr && include->count(entry.name) == 0) {
+            continue;
+        }
+        archive->total += entry.size;
+        parsed.push_back(std::move(entry));
+    }
+
+    archives_.push_back(std::move(archive));
+    entries_.insert(entries_.end(), std::make_move_iterator(parsed.begin()),
+                    std::make_move_iterator(parsed.end()));
+    return true;
+}
+
+std::vector<std::vector<const ZipExtractor::Entry *>> ZipExtractor::plan_tasks() const {
+    std::vector<const Entry *> large;
+    std::vector<std::vector<const Entry *>> tasks;
+    std::vector<const Entry *> batch;
+    uint64_t batch_bytes = 0;
+
+    for (const Entry &entry: entries_) {
+        if (entry.is_directory()) continue;
+        if (entry.size >= kLargeEntryBytes) {
+            large.push_back(&entry);
+            continue;
+        }
+        batch.push_back(&entry);
+        batch_bytes += entry.size;
+        if (batch_bytes >= kBatchBytes) {
+            tasks.push_back(std::move(batch));
+            batch.clear();
+            batch_bytes = 0;
+        }
+    }
+    if (!batch.empty()) tasks.push_back(std::move(batch));
+
+    // 大条目按大小降序排在最前，耗时最长的工作最先开始
+    std::sort(large.begin(), large.end(),
+              [](const Entry *a, const Entry *b) { return a->size > b->size; });
+    std::vector<std::vector<const Entry *>> ordered;
+    ordered.reserve(large.size() + tasks.size());
+    for (const Entry *entry: large) ordered.push_back({entry});
+    for (auto &task: tasks) ordered.push_back(std::move(task));
+    return ordered;
+}
+
+bool ZipExtractor::extract_entry(const Entry &entry, uint8_t *buffer, size_t buffer_size,
+                                 std::string &error) {
+    Archive &archive = *archives_[entry.archive];
+    if (entry.local_header_offset + kLocHeaderSize > archive.size ||
+        read_u32(archive.data + entry.local_header_offset) != kLocSignature) {
+        error = "invalid local header: " + entry.name;
+        return false;
+    }
+    const uint8_t *loc = archive.data + entry.local_header_offset;
+    uint64_t data_offset = entry.local_header_offset + kLocHeaderSize +
+                           read_u16(loc + 26) + read_u16(loc + 28);
+    if (data_offset + entry.compressed_size > archive.size) {
+        error = "truncated entry: " + entry.name;
+        return false;
+    }
+    // 存储条目按size复制，上面的边界检查只覆盖了compressed_size，两者不一致时会读到映射区之外
+    if (entry.method == kMethodStored && entry.size != entry.compressed_size) {
+        error = "stored entry size mismatch: " + entry.name;
+        return false;
+    }
+    const uint8_t *data = archive.data + data_offset;
+
+    std::string path = target_dir_ + "/" + entry.name;
+    std::string temp_path = path + kTempSuffix;
+    mode_t mode = entry.mode != 0 ? entry.mode : 0644;
+    int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, mode);
+    if (fd < 0) {
+        error = "open " + temp_path + ": " + strerror(errno);
+        return false;
+    }
+    if (entry.size > 0) {
+        // 预分配失败（文件系统不支持等）不影响正确性
+        posix_fallocate(fd, 0, static_cast<off_t>(entry.size));
+    }
+
+    bool ok = true;
+    if (entry.method == kMethodStored) {
+        ok = write_fully(fd, data, entry.size, 0);
+        if (ok) archive.extracted.fetch_add(entry.size, std::memory_order_relaxed);
+    } else {
+        z_stream stream{};
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+            close(fd);
+            unlink(temp_path.c_str());
+            error = "inflateInit failed: " + entry.name;
+            return false;
+        }
+        // 映射区可能超过uInt范围，分段喂给zlib
+        const uint8_t *next_in = data;
+        uint64_t remaining_in = entry.compressed_size;
+        off_t offset = 0;
+        int ret = Z_OK;
+        while (ret != Z_STREAM_END) {
+            if (stream.avail_in == 0) {
+                if (remaining_in == 0) {
+                    ret = Z_DATA_ERROR;
+                    break;
+                }
+                auto chunk = static_cast<uInt>(std::min<uint64_t>(remaining_in, 1u << 30));
+                stream.next_in = const_cast<Bytef *>(next_in);
+                stream.avail_in = chunk;
+                next_in += chunk;
+                remaining_in -= chunk;
+            }
+            stream.next_out = buffer;
+            stream.avail_out = static_cast<uInt>(buffer_size);
+            ret = inflate(&stream, Z_NO_FLUSH);
+            if (ret != Z_OK && ret != Z_STREAM_END) break;
+            size_t produced = buffer_size - stream.avail_out;
+            if (!write_fully(fd, buffer, produced, offset)) {
+                ok = false;
+                break;
+            }
+            offset += static_cast<off_t>(produced);
+            archive.extracted.fetch_add(produced, std::memory_order_relaxed);
+        }
+        inflateEnd(&stream);
+        if (ok && ret != Z_STREAM_END) {
+            close(fd);
+            unlink(temp_path.c_str());
+            error = "corrupt entry data: " + entry.name;
+            return false;
+        }
+        if (ok && static_cast<uint64_t>(offset) != entry.size) {
+            close(fd);
+            unlink(temp_path.c_str());
+            error = "size mismatch: " + entry.name;
+            return false;
+        }
+    }
+
+    if (!ok) {
+        error = "write " + temp_path + ": " + strerror(errno);
+    }
+    if (close(fd) != 0 && ok) {
+        error = "close " + temp_path + ": " + strerror(errno);
+        ok = false;
+    }
+    if (ok && rename(temp_path.c_str(), path.c_str()) != 0) {
+        error = "rename " + path + ": " + strerror(errno);
+        ok = false;
+    }
+    if (!ok) {
+        unlink(temp_path.c_str());
+    }
+    return ok;
+}
+
+bool ZipExtractor::run(std::string &error) {
+    namespace fs = std::filesystem;
+
+    // 先在调用线程上创建所有目录，工作线程只负责写文件
+    std::error_code ec;
+    fs::create_directories(target_dir_, ec);
+    for (const Entry &entry: entries_) {
+        fs::path path = fs::path(target_dir_) / entry.name;
+        fs::create_directories(entry.is_directory() ? path : path.parent_path(), ec);
+        if (ec) {
+            error = "mkdir " + path.string() + ": " + ec.message();
+            return false;
+        }
+    }
+
+    auto tasks = plan_tasks();
+    std::atomic<size_t> next_task{0};
+    std::atomic<bool> failed{false};
+    std::mutex error_mutex;
+
+    auto worker = [&]() {
+        std::vector<uint8_t> buffer(kOutputBufferSize);
+        std::string local_error;
+        while (!failed.load(std::memory_order_relaxed)) {
+            size_t index = next_task.fetch_add(1);
+            if (index >= tasks.size()) break;
+            for (const Entry *entry: tasks[index]) {
+                if (!extract_entry(*entry, buffer.data(), buffer.size(), local_error)) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!failed.exchange(true)) error = local_error;
+                    return;
+                }
+            }
+        }
+    };
+
+    unsigned count = std::min<unsigned>(workers_, std::max<size_t>(tasks.size(), 1));
+    std::vector<std::thread> threads;
+    threads.reserve(count - 1);
+    for (unsigned i = 1; i < count; ++i) threads.emplace_back(worker);
+    worker();
+    for (auto &thread: threads) thread.join();
+
+    return !failed.load();
+}
@@ -0,0 +1,98 @@
+//
+// Created by qz919 on 2025/10/3.
+//
+
+#ifndef ZIP_EXTRACTOR_HPP
+#define ZIP_EXTRACTOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * 基于内存映射的ZIP解压器
+ *
+ * 归档数据由调用方映射到内存（AAsset_getBuffer、mmap等），这里直接解析中央目录，
+ * 多个线程并行把条目写入目标目录：
+ * - 存储（未压缩）条目直接从映射区pwrite到输出文件，没有中间缓冲
+ * - 压缩条目用zlib从映射区原地inflate后pwrite
+ * - 输出文件先fallocate到最终大小，减少文件系统碎片和元数据更新
+ * - 每个文件先写入临时文件再rename替换，中途崩溃不会留下写了一半的文件
+ *
+ * 该类不依赖JNI和Android API，可以在主机上直接用普通zip文件编译测试
+ */
+class ZipExtractor {
+public:
+    struct Entry {
+        std::string name;
+        uint16_t method = 0;
+        uint64_t compressed_size = 0;
+        uint64_t size = 0;
+        uint64_t local_header_offset = 0;
+        uint32_t mode = 0;        // 来自外部属性的unix权限位，0表示未知
+        size_t archive = 0;       // 所属归档的下标
+
+        [[nodiscard]] bool is_directory() const { return !name.empty() && name.back() == '/'; }
+    };
+
+    ZipExtractor(std::string target_dir, unsigned workers);
+    ~ZipExtractor();
+
+    ZipExtractor(const ZipExtractor &) = delete;
+    ZipExtractor &operator=(const ZipExtractor &) = delete;
+
+    /** 解压中的临时文件后缀，与Kotlin实现保持一致 */
+    static constexpr const char *kTempSuffix = ".extracting";
+
+    /**
+     * 添加一个已映射到内存的归档并解析其中央目录
+     *
+     * 映射区必须在run()返回前保持有效。include不为空时只解压其中列出的条目，
+     * 用于增量更新时只写入发生变化的文件
+     */
+    bool add_archive(std::string name, const uint8_t *data, size_t size, std::string &error,
+                     const std::unordered_set<std::string> *include = nullptr);
+
+    /**
+     * 解压所有归档，阻塞直到完成或出错
+     *
+     * 解压期间可以在其他线程调用extracted_bytes()查询进度
+     */
+    bool run(std::string &error);
+
+    [[nodiscard]] size_t archive_count() const { return archives_.size(); }
+    [[nodiscard]] const std::string &archive_name(size_t index) const { return archives_[index]->name; }
+    [[nodiscard]] uint64_t total_bytes(size_t index) const { return archives_[index]->total; }
+    [[nodiscard]] uint64_t extracted_bytes(size_t index) const {
+        return archives_[index]->extracted.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] const std::vector<Entry> &entries() const { return entries_; }
+
+    /**
+     * 检查条目名是否安全：拒绝绝对路径和任何“..”路径段，防止写到目标目录之外
+     */
+    static bool is_safe_entry_name(const std::string &name);
+
+private:
+    struct Archive {
+        std::string name;
+        const uint8_t *data;
+        size_t size;
+        uint64_t total = 0;
+        std::atomic<uint64_t> extracted{0};
+    };
+
+    bool extract_entry(const Entry &entry, uint8_t *buffer, size_t buffer_size, std::string &error);
+    [[nodiscard]] std::vector<std::vector<const Entry *>> plan_tasks() const;
+
+    std::string target_dir_;
+    unsigned workers_;
+    std::vector<std::unique_ptr<Archive>> archives_;
+    std::vector<Entry> entries_;
+};
+
+#endif // ZIP_EXTRACTOR_HPP
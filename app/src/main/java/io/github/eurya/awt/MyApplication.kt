@@ -1,7 +1,18 @@
 package io.github.eurya.awt
 
 import android.app.Application
+import android.content.pm.ApplicationInfo
 import dagger.hilt.android.HiltAndroidApp
+import io.github.eurya.awt.utils.Tracing
 
 @HiltAndroidApp
-class MyApplication : Application()
\ No newline at end of file
+class MyApplication : Application() {
+
+    override fun onCreate() {
+        super.onCreate()
+        // 可调试版本默认开启跨进程追踪，缓冲区需在JVM启动前创建
+        if (applicationInfo.flags and ApplicationInfo.FLAG_DEBUGGABLE != 0) {
+            Tracing.start()
+        }
+    }
+}
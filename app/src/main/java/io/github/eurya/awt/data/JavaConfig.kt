@@ -14,6 +14,7 @@ import java.io.File
  * @property jrePath Java运行时环境根目录路径，包含bin、lib等标准JRE目录结构
  * @property screenWidth 虚拟屏幕显示宽度，单位为像素，默认1280
  * @property screenHeight 虚拟屏幕显示高度，单位为像素，默认720
+ * @property uiScale UI缩放比例，屏幕尺寸为逻辑像素，实际渲染分辨率 = 屏幕尺寸 × uiScale，默认1.0
  * @property logFile 日志输出文件名，JVM标准输出和错误输出将重定向到此文件
  *
  * @author qz919
@@ -25,6 +26,7 @@ data class JavaConfig(
     val jrePath: String,
     val screenWidth: Int = 1280,
     val screenHeight: Int = 720,
+    val uiScale: Float = 1.0f,
     val logFile: String = "logcat",
 ) {
 
@@ -40,6 +42,7 @@ data class JavaConfig(
         require(jrePath.isNotEmpty()) { "jrePath不能为空" }
         require(screenWidth > 0) { "screenWidth必须大于0" }
         require(screenHeight > 0) { "screenHeight必须大于0" }
+        require(uiScale > 0f) { "uiScale必须大于0" }
         require(logFile.isNotEmpty()) { "logFile不能为空" }
     }
 
@@ -11,6 +11,7 @@ package io.github.eurya.awt.data
  * @property version 运行库版本号，标识Java运行时版本（如：17）
  * @property size 运行库文件大小，以字节为单位，用于验证文件完整性
  * @property isExtracted 库文件是否已成功提取到目标目录，用于状态跟踪
+ * @property progress 解压进度，取值0到1，用于界面显示每个库的解压进度
  *
  * @author qz919
  * @data 2025/10/02
@@ -19,5 +20,6 @@ data class RuntimeLibrary(
     val name: String,
     val version: String,
     val size: Long,
-    val isExtracted: Boolean = false
+    val isExtracted: Boolean = false,
+    val progress: Float = 0f
 )
\ No newline at end of file
@@ -17,8 +17,11 @@ import android.graphics.Bitmap
  * @property dataRate 数据传输速率，单位为MB/s，反映网络带宽使用情况
  * @property width 远程桌面图像宽度，单位为像素，由服务器初始化时指定
  * @property height 远程桌面图像高度，单位为像素，由服务器初始化时指定
+ * @property uiScale 远程桌面UI缩放比例，宽高为设备像素，逻辑尺寸 = 设备尺寸 / uiScale
  * @property pixelFormat 当前图像数据的像素格式，如ARGB、RGB、RGB565等
  * @property bitmap 当前显示的位图图像，包含最新的远程桌面画面
+ * @property isPlaceholder 当前位图是否为上一次会话的末帧快照，占位期间不响应输入
+ * @property frameId 当前位图对应的帧序号，用于把绘制事件与服务端的帧关联起来
  * @property errorMessage 错误信息描述，当连接或数据传输失败时显示
  * @property startTime 连接开始时间戳，用于计算运行时长和性能指标
  * @property totalData 累计接收的数据总量，单位为字节，用于统计和监控
@@ -35,8 +38,11 @@ data class AwtUiState(
     val dataRate: Double = 0.0,
     val width: Int = 0,
     val height: Int = 0,
+    val uiScale: Float = 1f,
     val pixelFormat: String = "",
     val bitmap: Bitmap? = null,
+    val isPlaceholder: Boolean = false,
+    val frameId: Long = -1,
     val errorMessage: String? = null,
     val startTime: Long = System.currentTimeMillis(),
     val totalData: Long = 0
@@ -0,0 +1,138 @@
+package io.github.eurya.awt.manager
+
+import android.content.Context
+import android.graphics.Bitmap
+import android.graphics.BitmapFactory
+import android.util.Log
+import dagger.hilt.android.qualifiers.ApplicationContext
+import java.io.File
+import java.io.FileOutputStream
+import java.io.IOException
+import java.security.MessageDigest
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * 末帧快照存储
+ *
+ * 功能：
+ * - 会话结束时把最后一帧以PNG无损压缩保存到缓存目录，按jar路径和屏幕尺寸区分
+ * - 下次启动同一个jar时读取最近的快照，在JVM启动、第一帧到达之前作为不可交互的占位画面显示
+ * - 第一帧真实画面到达后与快照逐像素比较，累计快照完全一致的次数和平均相同像素比例，用于评估占位画面的可信度
+ *
+ * @author qz919
+ * @data 2025/10/13
+ */
+@Singleton
+class FrameSnapshotStore @Inject constructor(
+    @ApplicationContext context: Context
+) {
+
+    companion object {
+        private const val TAG = "FrameSnapshotStore"
+        private const val DIRECTORY_NAME = "frame_snapshots"
+        private const val PREFS_NAME = "frame_snapshots"
+        private const val KEY_SHOWN = "shown"
+        private const val KEY_EXACT = "exact"
+        private const val KEY_SIMILARITY_SUM = "similarity_sum"
+    }
+
+    /**
+     * 一张快照
+     *
+     * @property bitmap 占位显示的位图
+     * @property pixels 快照像素，用于与第一帧真实画面比较
+     */
+    class Snapshot(val bitmap: Bitmap, val pixels: IntArray) {
+        val width: Int get() = bitmap.width
+        val height: Int get() = bitmap.height
+    }
+
+    private val directory = File(context.cacheDir, DIRECTORY_NAME)
+
+    private val prefs = context.getSharedPreferences(PREFS_NAME, Context.MODE_PRIVATE)
+
+    /**
+     * 读取jar最近一次会话的快照
+     *
+     * 启动时还不知道屏幕尺寸，因此取该jar所有尺寸中最新的一张，握手后尺寸不一致时由调用方丢弃
+     *
+     * @param jarPath 应用jar路径
+     * @return 快照，没有或读取失败时返回null
+     */
+    fun load(jarPath: String): Snapshot? {
+        val prefix = jarKey(jarPath) + "_"
+        val file = directory.listFiles { f -> f.name.startsWith(prefix) && f.name.endsWith(".png") }
+            ?.maxByOrNull { it.lastModified() } ?: return null
+
+        val startTime = System.nanoTime()
+        val options = BitmapFactory.Options().apply { inPreferredConfig = Bitmap.Config.ARGB_8888 }
+        val bitmap = BitmapFactory.decodeFile(file.absolutePath, options) ?: return null
+        val pixels = IntArray(bitmap.width * bitmap.height)
+        bitmap.getPixels(pixels, 0, bitmap.width, 0, 0, bitmap.width, bitmap.height)
+        Log.i(TAG, "Loaded snapshot ${file.name} in ${(System.nanoTime() - startTime) / 1000}us")
+        return Snapshot(bitmap, pixels)
+    }
+
+    /**
+     * 保存会话的最后一帧，先写临时文件再重命名，避免进程被杀时留下不完整的文件
+     *
+     * @param jarPath 应用jar路径
+     * @param bitmap 最后一帧画面
+     */
+    fun save(jarPath: String, bitmap: Bitmap) {
+        val startTime = System.nanoTime()
+        val name = "${jarKey(jarPath)}_${bitmap.width}x${bitmap.height}.png"
+        val temp = File(directory, "$name.tmp")
+        try {
+            directory.mkdirs()
+            FileOutputStream(temp).use { out ->
+                if (!bitmap.compress(Bitmap.CompressFormat.PNG, 100, out)) throw IOException("PNG编码失败")
+            }
+            if (!temp.renameTo(File(directory, name))) throw IOException("重命名失败")
+            Log.i(TAG, "Saved snapshot $name in ${(System.nanoTime() - startTime) / 1000}us")
+        } catch (e: IOException) {
+            Log.w(TAG, "Failed to save snapshot: ${e.message}")
+            temp.delete()
+        }
+    }
+
+    /**
+     * 比较快照与第一帧真实画面并累计命中统计
+     *
+     * 只比较RGB，PNG往返不保证非不透明像素的Alpha完全一致
+     *
+     * @param snapshot 显示过的快照
+     * @param pixels 第一帧真实画面，尺寸与快照相同
+     * @return 相同像素的比例
+     */
+    fun recordMatch(snapshot: Snapshot, pixels: IntArray): Double {
+        val expected = snapshot.pixels
+        var same = 0
+        for (i in expected.indices) {
+            if ((expected[i] xor pixels[i]) and 0xFFFFFF == 0) same++
+        }
+        val similarity = if (expected.isEmpty()) 0.0 else same.toDouble() / expected.size
+
+        val shown = prefs.getInt(KEY_SHOWN, 0) + 1
+        val exact = prefs.getInt(KEY_EXACT, 0) + if (same == expected.size) 1 else 0
+        val similaritySum = prefs.getFloat(KEY_SIMILARITY_SUM, 0f) + similarity.toFloat()
+        prefs.edit()
+            .putInt(KEY_SHOWN, shown)
+            .putInt(KEY_EXACT, exact)
+            .putFloat(KEY_SIMILARITY_SUM, similaritySum)
+            .apply()
+
+        Log.i(
+            TAG, "Snapshot matched ${"%.1f".format(similarity * 100)}% of pixels; " +
+                    "exact $exact/$shown, average ${"%.1f".format(similaritySum / shown * 100)}%"
+        )
+        return similarity
+    }
+
+    /** jar路径的摘要，作为文件名前缀 */
+    private fun jarKey(jarPath: String): String {
+        val digest = MessageDigest.getInstance("SHA-1").digest(jarPath.toByteArray())
+        return digest.take(8).joinToString("") { "%02x".format(it) }
+    }
+}
@@ -5,6 +5,8 @@ import io.github.eurya.awt.data.LaunchResult
 import io.github.eurya.awt.utils.NativeJavaLauncher
 import kotlinx.coroutines.*
 import kotlinx.coroutines.channels.Channel
+import javax.inject.Inject
+import javax.inject.Singleton
 
 /**
  * Java应用程序启动管理器
@@ -12,12 +14,14 @@ import kotlinx.coroutines.channels.Channel
  * 功能：
  * - 负责管理Java应用程序的启动生命周期，提供异步启动、进度监控和运行状态管理功能
  * - 使用协程和Channel实现非阻塞的启动流程和实时进度反馈
- * - 利用协程Job状态来跟踪运行状态
+ * - 利用协程Job状态来跟踪运行状态，原生启动调用阻塞到JVM退出，任务活跃即JVM在运行
+ * - 属于进程而不是Activity，Activity因配置变化重建时JVM继续运行，服务端保留的会话可以被恢复
  *
  * @author qz919
  * @data 2025/10/02
  */
-class JavaLauncherManager {
+@Singleton
+class JavaLauncherManager @Inject constructor() {
     /**
      * 协程作用域，使用IO调度器和监督作业
      * 确保启动任务在后台线程执行，且一个任务的失败不会影响其他任务
@@ -102,13 +106,13 @@ class JavaLauncherManager {
     fun isApplicationRunning(): Boolean = currentJob?.isActive == true
 
     /**
-     * 关闭启动管理器并释放所有资源
+     * 停止正在运行的Java应用程序
      *
-     * 取消所有正在进行的启动任务，清理协程作用域
-     * 应在应用程序退出或不再需要启动服务时调用，防止资源泄漏
+     * 取消启动任务并结束JVM子进程，之后可以重新启动
+     * 只应在界面真正退出时调用，配置变化导致的Activity重建不应停止JVM
      */
-    fun shutdown() {
+    fun stopApplication() {
         cancelCurrentLaunch()
-        scope.cancel("JavaLauncherManager关闭")
+        NativeJavaLauncher.nativeStopJvm()
     }
-}
\ No newline at end of file
+}
@@ -4,12 +4,29 @@ import android.content.Context
 import android.util.Log
 import io.github.eurya.awt.data.RuntimeLibrary
 import io.github.eurya.awt.utils.Architecture
+import io.github.eurya.awt.utils.IoPriority
+import io.github.eurya.awt.utils.NativeZipExtractor
+import io.github.eurya.awt.utils.ParallelZipExtractor
+import io.github.eurya.awt.utils.RuntimeManifest
+import io.github.eurya.awt.utils.RuntimeVerifier
 import jakarta.inject.Inject
 import kotlinx.coroutines.CoroutineDispatcher
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Deferred
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.async
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.StateFlow
+import kotlinx.coroutines.flow.asStateFlow
+import kotlinx.coroutines.flow.update
+import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
 import java.io.File
+import java.io.FileInputStream
+import java.io.FileNotFoundException
 import java.io.FileOutputStream
+import java.io.IOException
 import java.util.zip.ZipEntry
 import java.util.zip.ZipInputStream
 
@@ -19,7 +36,9 @@ import java.util.zip.ZipInputStream
  * 功能：
  * - 负责管理和解压应用程序运行所需的Java运行时库文件
  * - 从assets目录提取ZIP格式的运行库到应用数据目录，并提供库状态检查、解压进度跟踪等功能
- * - 支持增量解压和完整性验证，确保运行时环境的可靠性
+ * - 通过运行库清单实现增量更新：应用升级后只重新解压内容变化的文件，并删除旧版本独有的文件
+ * - 启动时按文件元数据快速校验完整性，损坏的文件会被重新解压
+ * - 安装包更新后由[io.github.eurya.awt.service.RuntimeExtractionJobService]在后台低优先级预先解压
  *
  * @author qz919
  * @data 2025/10/02
@@ -29,57 +48,355 @@ class RuntimeLibraryManager @Inject constructor(
 ) {
 
     companion object {
+        private const val TAG = "RuntimeLibraryManager"
         private const val RUNTIME_DIR_NAME = "runtime_libs/jre17"
+
+        /** 旧版本使用的解压完成标记，已由[RuntimeManifest]取代 */
+        private const val LEGACY_MARKER = ".extraction_complete"
+
+        /** Cacio JAR所在的子目录 */
+        private const val CACIO_DIR_NAME = "cacio"
+
+        /** 后台全量校验的最小间隔 */
+        private const val FULL_VERIFY_INTERVAL_MS = 24 * 60 * 60 * 1000L
     }
 
+    /** 后台解压和校验使用的作用域，与管理器（单例）生命周期一致 */
+    private val backgroundScope = CoroutineScope(SupervisorJob() + dispatcher)
+
+    private val _extractionProgress = MutableStateFlow<List<RuntimeLibrary>>(emptyList())
+
+    /**
+     * 当前或最近一次解压中每个库的进度，界面和后台任务共用同一次解压的状态
+     */
+    val extractionProgress: StateFlow<List<RuntimeLibrary>> = _extractionProgress.asStateFlow()
+
+    private val extractionLock = Any()
+
+    /** 正在进行或最近一次的解压 */
+    private var extraction: Deferred<List<RuntimeLibrary>>? = null
+
+    /** 有界面在等待解压完成时，后台解压的剩余归档不再降低I/O优先级 */
+    @Volatile
+    private var foregroundWaiting = false
+
     /**
      * 检查运行库是否需要解压
      *
-     * 验证目标目录是否存在以及所有期望的库文件是否已完整解压
-     * 用于判断应用程序启动时是否需要执行解压流程
+     * 读取已安装的运行库清单并与当前安装包的更新时间比较，
+     * 不需要打开任何归档；安装包更新过或清单不存在时需要执行（增量）解压。
+     *
+     * 清单有效时再按校验缓存比较每个文件的元数据，只有元数据变化的文件才会同步计算CRC，
+     * 损坏或缺失的文件从清单中移除，随后的增量解压会重新写入它们
      *
      * @return true表示需要解压，false表示所有库文件已就绪
      */
     suspend fun checkLibrariesNeedExtraction(): Boolean {
         return withContext(dispatcher) {
-            val targetDir = getRuntimeDir()
-            if (!targetDir.exists()) return@withContext true
+            val runtimeDir = getRuntimeDir()
+            val manifest = RuntimeManifest.read(runtimeDir) ?: return@withContext true
+            if (manifest.stamp != getPackageStamp()) return@withContext true
+            if (!RuntimeVerifier.isAvailable) return@withContext false
+
+            val startTime = System.nanoTime()
+            val files = manifest.files
+            val stale = RuntimeVerifier.verify(runtimeDir, files, RuntimeVerifier.Mode.STAT_ONLY)
+            val corrupt = if (stale.isEmpty()) {
+                emptyList()
+            } else {
+                val staleSet = stale.toHashSet()
+                RuntimeVerifier.verify(
+                    runtimeDir, files.filter { it.name in staleSet }, RuntimeVerifier.Mode.CHANGED
+                )
+            }
+            Log.i(
+                TAG, "Verified ${files.size} runtime files in " +
+                        "${(System.nanoTime() - startTime) / 1000}us: " +
+                        "${stale.size} changed, ${corrupt.size} corrupt"
+            )
+
+            if (corrupt.isNotEmpty()) {
+                Log.w(TAG, "Corrupt runtime files will be re-extracted: $corrupt")
+                manifest.invalidate(corrupt).writeTo(runtimeDir)
+            }
+            corrupt.isNotEmpty()
+        }
+    }
+
+    /**
+     * 在后台对所有运行库文件做一次全量校验
+     *
+     * 用于发现元数据未变但内容已损坏的文件（存储错误等），距离上次全量校验不足
+     * [FULL_VERIFY_INTERVAL_MS]时跳过。发现损坏时使清单失效，下次启动会修复这些文件
+     */
+    fun verifyInBackground() {
+        if (!RuntimeVerifier.isAvailable) return
+        backgroundScope.launch {
+            val runtimeDir = getRuntimeDir()
+            val cache = File(runtimeDir, RuntimeVerifier.CACHE_FILE_NAME)
+            if (System.currentTimeMillis() - cache.lastModified() < FULL_VERIFY_INTERVAL_MS) {
+                return@launch
+            }
+            val manifest = RuntimeManifest.read(runtimeDir) ?: return@launch
 
-            // 检查是否所有库都已解压完成
-            !isExtractionComplete(targetDir)
+            // 后台校验不抢占前台，只用一半的核心
+            val workers = (ParallelZipExtractor.defaultWorkerCount() / 2).coerceAtLeast(1)
+            val corrupt = RuntimeVerifier.verify(
+                runtimeDir, manifest.files, RuntimeVerifier.Mode.FULL, workers
+            )
+            if (corrupt.isNotEmpty()) {
+                Log.w(TAG, "Background verification found corrupt files: $corrupt")
+                manifest.invalidate(corrupt).writeTo(runtimeDir)
+            }
         }
     }
 
     /**
      * 解压所有运行库文件到统一的jre17目录
      *
-     * 遍历预定义的库列表，逐个从assets目录解压到统一的jre17目录
-     * 创建目标目录结构，确保文件权限正确设置
+     * 先读取各归档的中央目录生成新的运行库清单，与已安装的清单比较，
+     * 只解压内容变化或新增的文件并删除旧版本独有的文件；没有已安装清单时完整解压。
+     * 所有文件就绪后才原子地写入新清单，中途崩溃时下次启动会重新计算增量。
      *
+     * 优先使用[NativeZipExtractor]直接映射APK中的资源解压，原生库不可用时
+     * 退回到[ParallelZipExtractor]；两者都在有界线程池中并行解压所有库的条目，
+     * 解压过程中按库更新[extractionProgress]，完成后记录耗时和线程数便于在不同设备上对比。
+     *
+     * 同一时间只有一次解压在进行：后台任务已经在解压时，界面的调用会等待同一次解压完成，
+     * 并让后台解压的剩余归档恢复正常的I/O优先级
+     *
+     * @param workerCount 并发解压的线程数，默认按CPU核心数选择
+     * @param background 为true时以低I/O优先级逐个归档解压，每完成一个归档就写入检查点，
+     *                   进程被杀后下次只需处理剩余的归档
      * @return 解压完成的库信息列表，包含解压状态标记
      * @throws RuntimeException 当解压过程中发生I/O错误时抛出
      */
-    suspend fun extractLibraries(): List<RuntimeLibrary> {
-        return withContext(dispatcher) {
-            val targetDir = getRuntimeDir()
-            if (!targetDir.exists()) {
-                targetDir.mkdirs()
+    suspend fun extractLibraries(
+        workerCount: Int = ParallelZipExtractor.defaultWorkerCount(),
+        background: Boolean = false
+    ): List<RuntimeLibrary> {
+        val job = synchronized(extractionLock) {
+            val running = extraction?.takeIf { it.isActive }
+            if (running != null) {
+                if (!background) foregroundWaiting = true
+                running
+            } else {
+                foregroundWaiting = !background
+                backgroundScope.async { runExtraction(workerCount, background) }
+                    .also { extraction = it }
+            }
+        }
+        return job.await()
+    }
+
+    private fun runExtraction(workerCount: Int, resumable: Boolean): List<RuntimeLibrary> {
+        val targetDir = getRuntimeDir()
+        if (!targetDir.exists()) {
+            targetDir.mkdirs()
+        }
+
+        val libraries = getExpectedLibraries()
+        _extractionProgress.value = libraries
+        val sources = mutableListOf<ParallelZipExtractor.Source>()
+        val startTime = System.nanoTime()
+        try {
+            libraries.forEach { sources.add(openAssetSource(it)) }
+            val reader = ParallelZipExtractor(workerCount)
+            val target = RuntimeManifest(
+                getPackageStamp(), sources.associate { it.name to reader.listEntries(it) }
+            )
+
+            // 没有清单（首次安装或旧版本的标记方式）时无法确认现有文件，完整解压
+            val installed = RuntimeManifest.read(targetDir)
+            val delta = installed?.diff(target)
+            delta?.removed?.forEach { File(targetDir, it).delete() }
+            if (installed == null) {
+                // 旧版本只有标记文件，无法知道哪些文件已不再发布；cacio目录完全来自cacio.zip，
+                // 整个删除以清掉合并前的cacio-shared.jar和cacio-tta.jar
+                File(targetDir, CACIO_DIR_NAME).deleteRecursively()
+            }
+            File(targetDir, LEGACY_MARKER).delete()
+
+            val writtenBytes = delta?.changedBytes ?: target.totalBytes
+            if (resumable) {
+                extractPerArchive(
+                    libraries, sources, reader, installed, target, delta, targetDir, workerCount
+                )
+            } else if (delta == null || !delta.isEmpty) {
+                extractArchives(libraries, sources, reader, delta?.changed, targetDir, workerCount)
+            }
+            target.writeTo(targetDir)
+
+            // 校验刚写入的文件并填充校验缓存，下次启动只需比较元数据
+            if (RuntimeVerifier.isAvailable) {
+                val corrupt = RuntimeVerifier.verify(
+                    targetDir, target.files, RuntimeVerifier.Mode.CHANGED, workerCount
+                )
+                if (corrupt.isNotEmpty()) {
+                    target.invalidate(corrupt).writeTo(targetDir)
+                    throw IOException("解压后校验失败: $corrupt")
+                }
+            }
+
+            val elapsedMs = (System.nanoTime() - startTime) / 1_000_000
+            Log.i(
+                TAG, "Updated ${libraries.size} libraries in ${elapsedMs}ms: " +
+                        "wrote $writtenBytes of ${target.totalBytes} bytes, " +
+                        "removed ${delta?.removed?.size ?: 0} files " +
+                        "(workers=$workerCount, cores=${Runtime.getRuntime().availableProcessors()}, " +
+                        "background=$resumable)"
+            )
+        } catch (e: Exception) {
+            throw RuntimeException("解压运行库失败: ${e.message}", e)
+        } finally {
+            sources.forEach { it.close() }
+            File(context.cacheDir, RUNTIME_DIR_NAME).deleteRecursively()
+        }
+
+        val extracted = libraries.map { it.copy(isExtracted = true, progress = 1f) }
+        _extractionProgress.value = extracted
+        return extracted
+    }
+
+    /**
+     * 逐个归档解压，每个归档完成后写入检查点清单
+     *
+     * 检查点中已完成的归档记录新条目，未完成的归档保留旧条目，时间戳为[RuntimeManifest.INVALID_STAMP]，
+     * 因此中断后重新计算的增量只包含剩余归档中的文件。每个归档开始前检查是否有前台调用方在等待，
+     * 没有时才降低I/O优先级
+     */
+    private fun extractPerArchive(
+        libraries: List<RuntimeLibrary>,
+        sources: List<ParallelZipExtractor.Source>,
+        reader: ParallelZipExtractor,
+        installed: RuntimeManifest?,
+        target: RuntimeManifest,
+        delta: RuntimeManifest.Delta?,
+        targetDir: File,
+        workerCount: Int
+    ) {
+        val removed = delta?.removed.orEmpty().toHashSet()
+        val completed = HashMap<String, List<ParallelZipExtractor.EntryInfo>>()
+        libraries.forEachIndexed { index, library ->
+            val changed = delta?.changed?.get(library.name)
+            if (changed == null || changed.isNotEmpty()) {
+                val previous =
+                    if (foregroundWaiting) IoPriority.UNCHANGED else IoPriority.lowerCurrentThread()
+                try {
+                    extractArchives(
+                        listOf(library), listOf(sources[index]), reader,
+                        changed?.let { mapOf(library.name to it) }, targetDir, workerCount
+                    )
+                } finally {
+                    IoPriority.restore(previous)
+                }
             }
 
-            val libraries = getExpectedLibraries()
-            val extractedLibraries = mutableListOf<RuntimeLibrary>()
+            completed[library.name] = target.archives[library.name].orEmpty()
+            val checkpoint = RuntimeManifest(
+                RuntimeManifest.INVALID_STAMP,
+                target.archives.keys.associateWith { name ->
+                    completed[name]
+                        ?: installed?.archives?.get(name)?.filterNot { it.name in removed }
+                        ?: emptyList()
+                }
+            )
+            checkpoint.writeTo(targetDir)
+        }
+    }
+
+    /**
+     * 解压一组归档，include为null时完整解压
+     */
+    private fun extractArchives(
+        libraries: List<RuntimeLibrary>,
+        sources: List<ParallelZipExtractor.Source>,
+        reader: ParallelZipExtractor,
+        include: Map<String, Set<String>>?,
+        targetDir: File,
+        workerCount: Int
+    ) {
+        if (NativeZipExtractor.isAvailable) {
+            extractWithNative(libraries, include, targetDir, workerCount)
+        } else {
+            reader.extract(sources, targetDir, include.orEmpty(), ::reportProgress)
+        }
+    }
+
+    /**
+     * 使用原生解压器解压，include为null时完整解压
+     */
+    private fun extractWithNative(
+        libraries: List<RuntimeLibrary>,
+        include: Map<String, Set<String>>?,
+        targetDir: File,
+        workerCount: Int
+    ) {
+        val assetPaths = libraries.map { "runtime_libs/${it.name}" }
+        val assetInclude = include?.mapKeys { (name, _) -> "runtime_libs/$name" }
+        NativeZipExtractor.extract(
+            context.assets, assetPaths, assetInclude, targetDir, workerCount
+        ) { index, extractedBytes, totalBytes ->
+            reportProgress(
+                ParallelZipExtractor.Progress(libraries[index].name, extractedBytes, totalBytes)
+            )
+        }
+    }
 
-            // 按顺序解压所有库到同一个目录
-            libraries.forEach { library ->
-                extractZipFromAssets(library, targetDir)
-                extractedLibraries.add(library.copy(isExtracted = true))
+    private fun reportProgress(progress: ParallelZipExtractor.Progress) {
+        _extractionProgress.update { libraries ->
+            libraries.map { library ->
+                if (library.name == progress.name) {
+                    library.copy(
+                        progress = maxOf(library.progress, progress.fraction),
+                        isExtracted = progress.extractedBytes >= progress.totalBytes
+                    )
+                } else {
+                    library
+                }
             }
+        }
+    }
 
-            // 所有库解压完成后创建标记文件
-            File(targetDir, ".extraction_complete").createNewFile()
+    /**
+     * 获取安装包的更新时间，作为assets是否变化的快速判断依据
+     */
+    @Suppress("DEPRECATION")
+    private fun getPackageStamp(): Long {
+        return context.packageManager.getPackageInfo(context.packageName, 0).lastUpdateTime
+    }
+
+    /**
+     * 以可随机访问的方式打开assets中的运行库
+     *
+     * ZIP资源在APK中通常以不压缩方式存储，此时直接定位到APK内的数据区间；
+     * 如果资源被压缩过无法获取文件描述符，则先复制到缓存目录再打开
+     *
+     * @param library 要打开的库信息
+     * @return 解压器使用的数据源，由调用方负责关闭
+     */
+    private fun openAssetSource(library: RuntimeLibrary): ParallelZipExtractor.Source {
+        val assetPath = "runtime_libs/${library.name}"
+        try {
+            val afd = context.assets.openFd(assetPath)
+            val input = afd.createInputStream()
+            return ParallelZipExtractor.Source(
+                library.name, input.channel, afd.startOffset, afd.length
+            ) {
+                input.close()
+                afd.close()
+            }
+        } catch (_: FileNotFoundException) {
+            Log.w(TAG, "${library.name} is compressed in the APK, copying to cache first")
+        }
 
-            extractedLibraries
+        val cached = File(context.cacheDir, "$RUNTIME_DIR_NAME/${library.name}")
+        cached.parentFile?.mkdirs()
+        context.assets.open(assetPath).use { input ->
+            FileOutputStream(cached).use { input.copyTo(it) }
         }
+        val input = FileInputStream(cached)
+        return ParallelZipExtractor.Source(library.name, input.channel, 0, cached.length(), input)
     }
 
     /**
@@ -111,7 +428,7 @@ class RuntimeLibraryManager @Inject constructor(
      *
      * @return 预定义的运行时库配置列表
      */
-    private fun getExpectedLibraries(): List<RuntimeLibrary> {
+    fun getExpectedLibraries(): List<RuntimeLibrary> {
         val jreRuntime = if (Architecture.deviceArchitecture == "arm64") {
             RuntimeLibrary(
                 "jre17-arm64.zip",  // 修正文件名
@@ -121,7 +438,7 @@ class RuntimeLibraryManager @Inject constructor(
             RuntimeLibrary("jre17-x86_64.zip", "17", 16256 * 4096)
         }
 
-        Log.d("RuntimeLibraryManager", "Expected libraries: ${jreRuntime.name}")
+        Log.d(TAG, "Expected libraries: ${jreRuntime.name}")
 
         return listOf(
             RuntimeLibrary("cacio.zip", "18", 296 * 4096),
@@ -130,59 +447,17 @@ class RuntimeLibraryManager @Inject constructor(
         )
     }
 
-    /**
-     * 从assets目录解压ZIP文件到目标目录
-     *
-     * 打开assets中的ZIP文件流，逐个解压条目到目标目录
-     * 包含安全检查防止路径遍历攻击
-     *
-     * @param library 要解压的库信息
-     * @param targetDir 解压目标目录（统一的jre17目录）
-     * @throws SecurityException 当检测到不安全的ZIP条目时抛出
-     * @throws RuntimeException 当解压过程中发生I/O错误时抛出
-     */
-    private fun extractZipFromAssets(library: RuntimeLibrary, targetDir: File) {
-        try {
-            context.assets.open("runtime_libs/${library.name}").use { input ->
-                ZipInputStream(input).use { zis ->
-                    var entry: ZipEntry?
-                    while (zis.nextEntry.also { entry = it } != null) {
-                        val entryName = entry!!.name
-                        val entryFile = File(targetDir, entryName)
-
-                        if (!entryFile.canonicalPath.startsWith(targetDir.canonicalPath)) {
-                            throw SecurityException("不安全的ZIP条目: $entryName")
-                        }
-
-                        if (entry.isDirectory) {
-                            entryFile.mkdirs()
-                        } else {
-                            entryFile.parentFile?.mkdirs()
-
-                            FileOutputStream(entryFile).use { fos ->
-                                zis.copyTo(fos)
-                            }
-                        }
-                        zis.closeEntry()
-                    }
-                }
-            }
-        } catch (e: Exception) {
-            throw RuntimeException("解压运行库 ${library.name} 失败", e)
-        }
-    }
-
     /**
      * 检查解压是否完整
      *
-     * 通过检查是否存在解压完成标记文件来验证所有库是否已成功解压
+     * 解压过程中每完成一个归档就以[RuntimeManifest.INVALID_STAMP]写入检查点，清单存在并不代表完整；
+     * 只有所有文件就绪后写入的清单才带有当前安装包的时间戳
      *
      * @param runtimeDir 运行时目录
-     * @return true表示解压完整，false表示解压可能被中断
+     * @return true表示解压完整且与当前安装包一致，false表示解压被中断或安装包已更新
      */
     private fun isExtractionComplete(runtimeDir: File): Boolean {
-        val completionMarker = File(runtimeDir, ".extraction_complete")
-        return completionMarker.exists()
+        return RuntimeManifest.readStamp(runtimeDir) == getPackageStamp()
     }
 
     /**
@@ -226,7 +501,8 @@ class RuntimeLibraryManager @Inject constructor(
                 return@withContext emptyList()
             }
 
-            runtimeDir.walk().filter { it.isFile && it.name != ".extraction_complete" }.toList()
+            runtimeDir.walk().filter { it.isFile && !it.name.startsWith(RuntimeManifest.FILE_NAME) }
+                .toList()
         }
     }
 
@@ -0,0 +1,512 @@
+package io.github.eurya.awt.manager
+
+import android.graphics.Bitmap
+import io.github.eurya.awt.codec.FrameDecoder
+import io.github.eurya.awt.codec.FrameStreamReader
+import io.github.eurya.awt.codec.InputMessages
+import io.github.eurya.awt.codec.PixelFormat
+import io.github.eurya.awt.codec.TileFrameDecoder
+import io.github.eurya.awt.data.state.AwtUiState
+import io.github.eurya.awt.utils.BitmapTileDecoder
+import io.github.eurya.awt.utils.Tracing
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.delay
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.StateFlow
+import kotlinx.coroutines.flow.asStateFlow
+import kotlinx.coroutines.flow.update
+import kotlinx.coroutines.launch
+import java.io.DataInputStream
+import java.io.IOException
+import java.io.PrintWriter
+import java.net.InetSocketAddress
+import java.net.Socket
+import javax.inject.Inject
+import javax.inject.Singleton
+
+/**
+ * 远程桌面会话管理器
+ *
+ * 功能：
+ * - 进程级单例，持有与屏幕流服务端的连接、分块解码器和最后一帧画面，Activity重建、ViewModel销毁后会话仍然保留
+ * - 界面重新连接同一服务端时直接复用正在运行的会话，最后一帧立即显示，不再经历重试、握手和整帧传输
+ * - HELLO中请求会话令牌；连接断开后保留恢复点（令牌和已应用的帧数），重连时带回，
+ *   服务端接管断开前的编码状态，只发送之后变化的块
+ * - 恢复被拒绝（令牌过期或服务端还有帧未送达）时服务端重新发送所有块，解码器和像素缓冲区照常覆盖，不需要额外处理
+ * - 记住输入法的键盘区域，连接后随HELLO发送，服务端据此切换按键映射的键盘布局
+ * - 启动应用时先显示该jar上一次会话的末帧快照作为不可交互的占位画面，第一帧真实画面到达后替换，见[FrameSnapshotStore]
+ *
+ * @author qz919
+ * @data 2025/10/12
+ */
+@Singleton
+class StreamSessionManager @Inject constructor(
+    private val snapshots: FrameSnapshotStore
+) {
+
+    /** 会话的协程作用域，不随任何界面组件的生命周期取消 */
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.IO)
+
+    /** UI状态的可变数据流，用于观察界面状态变化 */
+    private val _uiState = MutableStateFlow(AwtUiState())
+
+    /** 对外暴露的UI状态只读数据流，最后一帧画面保留在其中 */
+    val uiState: StateFlow<AwtUiState> = _uiState.asStateFlow()
+
+    /** 网络Socket连接实例 */
+    @Volatile
+    private var socket: Socket? = null
+
+    /** 连接任务引用，用于取消连接操作 */
+    private var connectionJob: Job? = null
+
+    /** 当前会话的服务端和屏幕尺寸，恢复点只对同一服务端、同一尺寸有效 */
+    private var sessionKey: SessionKey? = null
+
+    /** 服务端分配的会话令牌，0表示没有可恢复的会话 */
+    @Volatile
+    private var sessionToken = 0L
+
+    /** 当前会话已应用的帧数，与服务端已编码的帧数一致时可以只接收变化的块 */
+    @Volatile
+    private var appliedFrames = 0L
+
+    /** 正在运行的应用jar路径，会话结束时按它保存末帧快照 */
+    @Volatile
+    private var launchJar: String? = null
+
+    /** 正在作为占位画面显示的快照，第一帧真实画面到达后与之比较并清空 */
+    @Volatile
+    private var placeholder: FrameSnapshotStore.Snapshot? = null
+
+    /** 上次保存快照之后是否收到了新的画面 */
+    @Volatile
+    private var snapshotDirty = false
+
+    /** 解码像素的复用缓冲区，保存会话的最后一帧，Bitmap.createBitmap会复制数据，因此可以跨帧复用 */
+    private var pixels = IntArray(0)
+
+    /** 当前会话的分块帧解码器，持有服务端指定的缓存槽位，恢复会话时继续使用 */
+    private var tileDecoder: TileFrameDecoder? = null
+
+    /** 当前连接收到的帧头数量，与服务端的帧序号一一对应，用作追踪的流ID */
+    private var frameId = 0L
+
+    /** 当前连接发送的输入行数量，与服务端收到的行序号一一对应 */
+    private var inputId = 0L
+
+    /** 保证输入计数与写入顺序一致 */
+    private val inputLock = Any()
+
+    /** 查看器键盘的语言标签，每次连接后紧跟HELLO发送，服务端据此选择按键映射 */
+    @Volatile
+    private var keyboardLocale: String? = null
+
+    /**
+     * 准备启动应用，在JVM启动之前调用
+     *
+     * 会话还没有画面时读取该jar上一次会话的末帧快照，作为不可交互的占位画面立即显示
+     *
+     * @param jarPath 应用jar路径
+     */
+    fun prepareLaunch(jarPath: String) {
+        launchJar = jarPath
+        if (_uiState.value.bitmap != null) return
+
+        scope.launch {
+            val snapshot = snapshots.load(jarPath) ?: return@launch
+            _uiState.update { state ->
+                if (state.bitmap != null) return@update state
+                placeholder = snapshot
+                state.copy(
+                    bitmap = snapshot.bitmap,
+                    width = snapshot.width,
+                    height = snapshot.height,
+                    isPlaceholder = true
+                )
+            }
+        }
+    }
+
+    /**
+     * 连接到远程AWT服务器
+     *
+     * 已有连接同一服务端的会话在运行时直接复用；否则建立连接，存在同一服务端、同一尺寸的恢复点时请求恢复会话
+     *
+     * @param host 服务器主机地址
+     * @param port 服务器监听端口
+     */
+    fun connect(host: String, port: Int) {
+        val state = _uiState.value
+        if (connectionJob?.isActive == true && state.serverHost == host && state.serverPort == port) {
+            return
+        }
+        connectionJob?.cancel()
+        closeSocket(socket) // 阻塞中的读取不响应取消，关闭连接让旧的接收循环退出
+        _uiState.update { it.copy(serverHost = host, serverPort = port) }
+
+        connectionJob = scope.launch {
+            var current: Socket? = null
+            try {
+                _uiState.update { it.copy(errorMessage = null) }
+
+                // 使用重试机制建立连接
+                current = retryConnect(host, port, 10000) // 10秒超时
+                socket = current
+                val reader = FrameStreamReader(DataInputStream(current.getInputStream()))
+                frameId = 0
+                synchronized(inputLock) { inputId = 0 }
+
+                val (width, height, _, uiScale) = reader.readScreenInfo()
+                val key = SessionKey(host, port, width, height)
+                val resumeFrom = if (key == sessionKey && sessionToken != 0L && tileDecoder != null) {
+                    FrameStreamReader.ResumePoint(sessionToken, appliedFrames)
+                } else {
+                    sessionKey = key
+                    sessionToken = 0
+                    tileDecoder = TileFrameDecoder(width, height, TILE_CACHE_BYTES, BitmapTileDecoder())
+                    pixels = IntArray(width * height)
+                    null
+                }
+                val hello = InputMessages.hello(
+                    TILE_CACHE_BYTES, jpeg = true, deflateLevel = DEFLATE_LEVEL, mux = true,
+                    resume = true, resumeFrom = resumeFrom
+                )
+                // 键盘区域与HELLO在同一次发送中写出，保证新连接的服务端先切换布局再处理按键
+                sendInput(*listOfNotNull(hello, keyboardLocale?.let(InputMessages::keyboardLocale)).toTypedArray())
+
+                val staleSnapshot = placeholder?.let { it.width != width || it.height != height } == true
+                if (staleSnapshot) placeholder = null
+                _uiState.update { state ->
+                    state.copy(
+                        isConnected = true,
+                        width = width,
+                        height = height,
+                        uiScale = uiScale,
+                        startTime = System.currentTimeMillis(),
+                        // 尺寸不同的快照无法作为占位画面
+                        bitmap = if (staleSnapshot && state.isPlaceholder) null else state.bitmap,
+                        isPlaceholder = state.isPlaceholder && !staleSnapshot
+                    )
+                }
+
+                // 开始接收数据循环
+                try {
+                    startDataReceivingLoop(reader, current, width, height, resumeFrom != null)
+                } finally {
+                    reader.close()
+                }
+
+            } catch (e: Exception) {
+                _uiState.update { state ->
+                    state.copy(
+                        errorMessage = "连接失败: ${e.message}",
+                        isConnected = false
+                    )
+                }
+            } finally {
+                closeSocket(current)
+                saveSnapshot()
+            }
+        }
+    }
+
+    /** 会话结束时保存末帧快照，下次启动同一个jar时作为占位画面 */
+    private fun saveSnapshot() {
+        val jarPath = launchJar ?: return
+        val state = _uiState.value
+        val bitmap = state.bitmap ?: return
+        if (!snapshotDirty || state.isPlaceholder) return
+        snapshotDirty = false
+        snapshots.save(jarPath, bitmap)
+    }
+
+    /**
+     * 重试连接机制
+     *
+     * 在指定超时时间内每500ms尝试连接一次，直到连接成功或超时
+     *
+     * @param host 服务器主机地址
+     * @param port 服务器监听端口
+     * @param timeoutMs 超时时间（毫秒），默认10秒
+     * @return 成功建立的Socket连接
+     * @throws IOException 连接超时或所有重试尝试都失败
+     */
+    private suspend fun retryConnect(host: String, port: Int, timeoutMs: Long = 10000): Socket {
+        val startTime = System.currentTimeMillis()
+
+        while (true) {
+            try {
+                // 尝试连接，设置连接超时2秒
+                val socket = Socket()
+                socket.soTimeout = 2000
+                socket.connect(InetSocketAddress(host, port), 2000)
+                return socket
+
+            } catch (e: Exception) {
+                if (System.currentTimeMillis() - startTime > timeoutMs) {
+                    throw IOException("连接超时 (${timeoutMs}ms)，最后错误: ${e.message}")
+                }
+
+                // 等待500ms后重试
+                delay(500)
+            }
+        }
+    }
+
+    /**
+     * 开始接收数据循环
+     *
+     * 在连接成功后持续接收和处理图像帧数据。恢复会话时，服务端在收到HELLO之前可能已经为新连接发送了整帧，
+     * 这些帧在会话消息之前到达，直接丢弃，像素缓冲区保持断开时的画面，与服务端接管的编码状态一致
+     *
+     * @param reader 已完成握手的帧读取器
+     * @param current 当前连接
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @param resuming 是否正在恢复会话
+     */
+    private fun startDataReceivingLoop(
+        reader: FrameStreamReader,
+        current: Socket,
+        width: Int,
+        height: Int,
+        resuming: Boolean
+    ) {
+        var awaitingSession = resuming
+        reader.onSession = { point ->
+            sessionToken = point.token
+            frameId = point.frames
+            awaitingSession = false
+        }
+
+        while (!current.isClosed) {
+            try {
+                val receiveStart = System.nanoTime()
+                val frame = reader.readFrame()
+                val currentFrameId = frameId++
+                val flow = Tracing.frameFlow(currentFrameId)
+                Tracing.slice(Tracing.RECEIVE, receiveStart, flow, frame.wireLength)
+
+                // 服务端不认识令牌时不会发送会话消息，第一个分块帧包含所有块，可以直接应用
+                if (awaitingSession && frame.isTiled) awaitingSession = false
+                if (awaitingSession) continue
+
+                if (frame.length == 0) {
+                    appliedFrames = frameId
+                    continue
+                }
+
+                if (frame.length == -1) {
+                    appliedFrames = frameId
+                    updateFrameCount()
+                    continue
+                }
+
+                val decodeStart = System.nanoTime()
+                val bitmap = if (frame.isTiled) {
+                    convertTilesToBitmap(frame.data, frame.length, width, height)
+                } else {
+                    val format = frame.format ?: throw IOException("未知的像素格式: ${frame.formatName}")
+                    convertBytesToBitmap(frame.data, format, width, height)
+                }
+                Tracing.slice(Tracing.DECODE, decodeStart, flow)
+                appliedFrames = frameId
+
+                if (bitmap != null) {
+                    updateUIWithNewFrame(bitmap, frame.formatName, frame.wireLength, currentFrameId)
+                }
+
+            } catch (e: Exception) {
+                if (!current.isClosed) {
+                    _uiState.update { state ->
+                        state.copy(errorMessage = "接收数据错误: ${e.message}")
+                    }
+                }
+                break
+            }
+        }
+    }
+
+    /**
+     * 更新查看器键盘的区域
+     *
+     * 输入法切换语言时调用，已连接时立即通知服务端，之后每次（重新）连接都在HELLO后再次发送
+     *
+     * @param languageTag IETF语言标签，如de-DE
+     */
+    fun setKeyboardLocale(languageTag: String) {
+        if (languageTag.isEmpty() || languageTag == keyboardLocale) return
+        keyboardLocale = languageTag
+        sendInput(InputMessages.keyboardLocale(languageTag))
+    }
+
+    /**
+     * 断开与服务器的连接并结束会话
+     *
+     * 取消连接任务，关闭Socket连接，丢弃恢复点，并更新UI状态为未连接
+     */
+    fun disconnect() {
+        connectionJob?.cancel()
+        connectionJob = null
+        sessionToken = 0
+        sessionKey = null
+        closeSocket(socket)
+    }
+
+    /** 关闭指定的连接，仍是当前连接时清空引用并更新UI状态为未连接 */
+    private fun closeSocket(target: Socket?) {
+        try {
+            target?.close()
+        } catch (_: IOException) {
+        }
+
+        if (target == null || socket === target) {
+            socket = null
+            _uiState.update { state -> state.copy(isConnected = false) }
+        }
+    }
+
+    /**
+     * 按顺序发送输入消息
+     *
+     * 在IO线程中发送到服务器，每条消息占一行
+     * 服务端按行为输入编号，这里在同一把锁内计数和写入，保证两端的序号一致
+     *
+     * @param messages 需要发送的输入消息
+     */
+    fun sendInput(vararg messages: String) {
+        scope.launch {
+            val current = socket ?: return@launch
+            if (current.isClosed) return@launch
+            synchronized(inputLock) {
+                val printWriter = PrintWriter(current.outputStream, true) // autoFlush = true
+                messages.forEach { message ->
+                    Tracing.instant(Tracing.INPUT, Tracing.inputFlow(inputId++))
+                    printWriter.println(message)
+                }
+            }
+        }
+    }
+
+    /**
+     * 更新帧计数和性能统计信息
+     *
+     * 在收到不含图像数据的特殊帧时调用，用于更新FPS和数据传输速率
+     */
+    private fun updateFrameCount() {
+        _uiState.update { state ->
+            val newFrameCount = state.frameCount + 1
+            val currentTime = System.currentTimeMillis()
+            val elapsedSeconds = (currentTime - state.startTime) / 1000.0
+
+            val fps = if (elapsedSeconds > 0) newFrameCount / elapsedSeconds else 0.0
+            val dataRate =
+                if (elapsedSeconds > 0) state.totalData / (1024.0 * 1024.0) / elapsedSeconds else 0.0
+
+            state.copy(
+                frameCount = newFrameCount,
+                fps = fps,
+                dataRate = dataRate
+            )
+        }
+    }
+
+    /**
+     * 使用新接收的图像帧更新UI状态
+     *
+     * 更新帧计数、总数据量、FPS、数据传输速率，并设置新的Bitmap图像
+     *
+     * @param bitmap 转换后的Bitmap图像
+     * @param format 像素格式字符串
+     * @param dataLength 当前帧的数据长度（字节数）
+     * @param frameId 当前帧的序号
+     */
+    private fun updateUIWithNewFrame(bitmap: Bitmap, format: String, dataLength: Int, frameId: Long) {
+        placeholder?.let { snapshot ->
+            placeholder = null
+            if (snapshot.pixels.size == pixels.size) snapshots.recordMatch(snapshot, pixels)
+        }
+        snapshotDirty = true
+        _uiState.update { state ->
+            val newFrameCount = state.frameCount + 1
+            val newTotalData = state.totalData + dataLength
+            val currentTime = System.currentTimeMillis()
+            val elapsedSeconds = (currentTime - state.startTime) / 1000.0
+
+            val fps = if (elapsedSeconds > 0) newFrameCount / elapsedSeconds else 0.0
+            val dataRate =
+                if (elapsedSeconds > 0) newTotalData / (1024.0 * 1024.0) / elapsedSeconds else 0.0
+
+            state.copy(
+                frameCount = newFrameCount,
+                totalData = newTotalData,
+                fps = fps,
+                dataRate = dataRate,
+                pixelFormat = format,
+                bitmap = bitmap,
+                isPlaceholder = false,
+                frameId = frameId
+            )
+        }
+    }
+
+    /**
+     * 将字节数组转换为Android Bitmap图像
+     *
+     * 像素解码由[FrameDecoder]完成，与主机端基准测试的查看器共用同一份实现
+     *
+     * @param pixelBytes 原始像素数据字节数组
+     * @param format 像素格式
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @return 转换后的Bitmap对象，转换失败时返回null
+     */
+    private fun convertBytesToBitmap(
+        pixelBytes: ByteArray,
+        format: PixelFormat,
+        width: Int,
+        height: Int
+    ): Bitmap? {
+        return try {
+            if (pixels.size != width * height) pixels = IntArray(width * height)
+            FrameDecoder.decode(pixelBytes, format, pixels)
+            Bitmap.createBitmap(pixels, width, height, Bitmap.Config.ARGB_8888)
+        } catch (_: Exception) {
+            null
+        }
+    }
+
+    /**
+     * 把分块帧应用到复用的像素缓冲区后生成Bitmap
+     *
+     * 分块帧只包含变化的块，未变化的区域保留在[pixels]中，因此缓冲区不能在帧之间清空，恢复会话时也继续使用
+     *
+     * @param data 分块帧数据
+     * @param length 数据长度
+     * @param width 图像宽度
+     * @param height 图像高度
+     * @return 转换后的Bitmap对象
+     * @throws IOException 当分块数据与缓存状态不一致时抛出，此时画面已不可信，需要断开重连
+     */
+    private fun convertTilesToBitmap(data: ByteArray, length: Int, width: Int, height: Int): Bitmap {
+        val decoder = tileDecoder ?: throw IOException("未声明分块缓存却收到分块帧")
+        if (pixels.size != width * height) pixels = IntArray(width * height)
+        decoder.decode(data, length, pixels)
+        return Bitmap.createBitmap(pixels, width, height, Bitmap.Config.ARGB_8888)
+    }
+
+    /** 会话对应的服务端和屏幕尺寸 */
+    private data class SessionKey(val host: String, val port: Int, val width: Int, val height: Int)
+
+    companion object {
+        /** 分块缓存预算，64x64的块约可缓存1024个，覆盖1280x720屏幕约4屏的内容 */
+        private const val TILE_CACHE_BYTES = 16L * 1024 * 1024
+
+        /** 跨帧deflate压缩等级，1级压缩最快，服务端CPU开销小，对界面内容已有明显收益 */
+        private const val DEFLATE_LEVEL = 1
+    }
+}
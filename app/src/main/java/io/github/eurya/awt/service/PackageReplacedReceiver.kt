@@ -0,0 +1,23 @@
+package io.github.eurya.awt.service
+
+import android.content.BroadcastReceiver
+import android.content.Context
+import android.content.Intent
+
+/**
+ * 安装包更新广播接收器
+ *
+ * 功能：
+ * - 收到ACTION_MY_PACKAGE_REPLACED后立即调度[RuntimeExtractionJobService]
+ *
+ * @author qz919
+ * @data 2025/10/05
+ */
+class PackageReplacedReceiver : BroadcastReceiver() {
+
+    override fun onReceive(context: Context, intent: Intent) {
+        if (intent.action == Intent.ACTION_MY_PACKAGE_REPLACED) {
+            RuntimeExtractionJobService.schedule(context)
+        }
+    }
+}
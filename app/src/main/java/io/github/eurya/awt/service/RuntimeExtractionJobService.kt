@@ -0,0 +1,106 @@
+package io.github.eurya.awt.service
+
+import android.app.job.JobInfo
+import android.app.job.JobParameters
+import android.app.job.JobScheduler
+import android.app.job.JobService
+import android.content.ComponentName
+import android.content.Context
+import android.os.Build
+import android.util.Log
+import dagger.hilt.android.AndroidEntryPoint
+import io.github.eurya.awt.manager.RuntimeLibraryManager
+import jakarta.inject.Inject
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.isActive
+import kotlinx.coroutines.launch
+
+/**
+ * 运行库后台预解压任务
+ *
+ * 功能：
+ * - 安装包更新后立即由[PackageReplacedReceiver]调度，在用户打开应用前完成运行库的（增量）解压
+ * - 通过[RuntimeLibraryManager]以后台模式解压：低I/O优先级、逐个归档写入检查点
+ * - 任务被系统停止时请求重新调度，下次从未完成的归档继续
+ *
+ * @author qz919
+ * @data 2025/10/05
+ */
+@AndroidEntryPoint
+class RuntimeExtractionJobService : JobService() {
+
+    companion object {
+        private const val TAG = "RuntimeExtractionJob"
+        private const val JOB_ID = 0x6a7265
+
+        /**
+         * 调度预解压任务，已调度时替换为新的任务
+         *
+         * Android 12及以上作为加急任务调度，配额不足时退回到普通任务
+         *
+         * @param context 上下文
+         */
+        fun schedule(context: Context) {
+            val scheduler = context.getSystemService(JobScheduler::class.java) ?: return
+            val component = ComponentName(context, RuntimeExtractionJobService::class.java)
+
+            if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.S) {
+                val expedited = JobInfo.Builder(JOB_ID, component).setExpedited(true).build()
+                if (scheduler.schedule(expedited) == JobScheduler.RESULT_SUCCESS) return
+                Log.w(TAG, "Expedited job rejected, falling back to a regular job")
+            }
+            // 普通任务至少需要一个约束，截止时间为0表示尽快执行
+            val regular = JobInfo.Builder(JOB_ID, component).setOverrideDeadline(0).build()
+            scheduler.schedule(regular)
+        }
+    }
+
+    @Inject
+    lateinit var libraryManager: RuntimeLibraryManager
+
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.Default)
+
+    /** 正在运行的任务协程，系统停止任务时取消 */
+    private var running: Job? = null
+
+    override fun onStartJob(params: JobParameters): Boolean {
+        running = scope.launch {
+            var reschedule = false
+            try {
+                if (libraryManager.checkLibrariesNeedExtraction()) {
+                    libraryManager.extractLibraries(background = true)
+                    Log.i(TAG, "Runtime libraries extracted in background")
+                }
+            } catch (e: CancellationException) {
+                // 任务已被系统停止，不能再对它调用jobFinished
+                throw e
+            } catch (e: Exception) {
+                Log.e(TAG, "Background extraction failed", e)
+                reschedule = true
+            }
+            if (isActive) jobFinished(params, reschedule)
+        }
+        return true
+    }
+
+    /**
+     * 系统停止任务时取消等待解压的协程，之后不再调用jobFinished
+     *
+     * 解压本身仍在管理器的作用域中继续，进程被杀时由重新调度的任务从检查点继续
+     */
+    override fun onStopJob(params: JobParameters): Boolean {
+        running?.cancel()
+        running = null
+        return true
+    }
+
+    override fun onDestroy() {
+        scope.cancel()
+        super.onDestroy()
+    }
+}
@@ -1,7 +1,13 @@
 package io.github.eurya.awt.ui.activity
 
+import android.content.BroadcastReceiver
+import android.content.Context
+import android.content.Intent
+import android.content.IntentFilter
 import android.os.Bundle
 import android.util.Log
+import android.view.inputmethod.InputMethodManager
+import android.widget.Toast
 import androidx.activity.ComponentActivity
 import androidx.activity.compose.setContent
 import androidx.activity.enableEdgeToEdge
@@ -10,6 +16,7 @@ import androidx.compose.foundation.layout.fillMaxSize
 import androidx.compose.foundation.layout.padding
 import androidx.compose.material.icons.Icons
 import androidx.compose.material.icons.filled.Person
+import androidx.compose.material.icons.filled.Share
 import androidx.compose.material3.ExperimentalMaterial3Api
 import androidx.compose.material3.Icon
 import androidx.compose.material3.IconButton
@@ -25,22 +32,45 @@ import androidx.compose.ui.Modifier
 import dagger.hilt.android.AndroidEntryPoint
 import io.github.eurya.awt.data.JavaConfig
 import io.github.eurya.awt.manager.JavaLauncherManager
+import io.github.eurya.awt.manager.StreamSessionManager
 import io.github.eurya.awt.ui.screen.AwtScreen
 import io.github.eurya.awt.ui.screen.InitScreen
 import io.github.eurya.awt.ui.theme.MyAWTTheme
-import io.github.eurya.awt.utils.NativeJavaLauncher
+import io.github.eurya.awt.utils.Tracing
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.launch
+import kotlinx.coroutines.withContext
+import java.io.File
+import javax.inject.Inject
 
 /**
  * 主活动
+ *
+ * 功能：
+ * - 初始化运行时后启动Java应用，并显示远程桌面画面
+ * - 回到前台和输入法切换时把输入法的键盘区域告知会话，服务端据此选择按键映射的键盘布局
+ * - 配置变化导致重建时不停止JVM，只有界面真正退出时才结束Java应用
+ *
  * @author qz919
  * @data 2025/10/2
  */
 @AndroidEntryPoint
 class AwtActivity : ComponentActivity() {
-    private val javaLauncherManager = JavaLauncherManager()
+    /** Java应用启动管理器，由进程持有，Activity重建时JVM继续运行 */
+    @Inject
+    lateinit var javaLauncherManager: JavaLauncherManager
+
+    /** 远程桌面会话，启动应用前先显示上一次会话的末帧快照 */
+    @Inject
+    lateinit var streamSession: StreamSessionManager
+
+    /** 输入法切换时重新读取键盘区域 */
+    private val inputMethodReceiver = object : BroadcastReceiver() {
+        override fun onReceive(context: Context, intent: Intent) {
+            updateKeyboardLocale()
+        }
+    }
 
     @OptIn(ExperimentalMaterial3Api::class)
     override fun onCreate(savedInstanceState: Bundle?) {
@@ -54,6 +84,14 @@ class AwtActivity : ComponentActivity() {
                 Scaffold(modifier = Modifier.fillMaxSize(), topBar = {
                     TopAppBar(
                         actions = {
+                            if (Tracing.isEnabled) {
+                                IconButton(onClick = { exportTrace() }) {
+                                    Icon(
+                                        imageVector = Icons.Default.Share,
+                                        contentDescription = "导出追踪数据"
+                                    )
+                                }
+                            }
                             IconButton(onClick = { isFullMode = !isFullMode }) {
                                 Icon(
                                     imageVector = Icons.Default.Person,
@@ -84,26 +122,53 @@ class AwtActivity : ComponentActivity() {
         }
     }
 
+    override fun onStart() {
+        super.onStart()
+        registerReceiver(inputMethodReceiver, IntentFilter(Intent.ACTION_INPUT_METHOD_CHANGED))
+    }
+
+    override fun onResume() {
+        super.onResume()
+        // 同一输入法内切换语言没有广播，在后台切换后回到前台时重新读取
+        updateKeyboardLocale()
+    }
+
+    override fun onStop() {
+        super.onStop()
+        unregisterReceiver(inputMethodReceiver)
+    }
+
     override fun onDestroy() {
         super.onDestroy()
-        javaLauncherManager.shutdown()
-        NativeJavaLauncher.nativeStopJvm()
+        // 配置变化导致的重建保留JVM，新的Activity重新连接后恢复服务端保留的会话
+        if (!isChangingConfigurations) {
+            javaLauncherManager.stopApplication()
+        }
     }
 
     /**
      * 启动 Java 应用
+     *
+     * Activity重建前启动的JVM仍在运行时不再重复启动
+     *
      * @param javaLauncherManager JavaLauncherManager
      */
     private fun startJavaApplication(
         javaLauncherManager: JavaLauncherManager,
     ) {
+        if (javaLauncherManager.isApplicationRunning()) {
+            Log.i(TAG, "Java应用仍在运行，复用现有JVM")
+            return
+        }
+
         val config = JavaConfig(
             home = filesDir.absolutePath,
             nativePath = applicationInfo.nativeLibraryDir,
             jrePath = "${filesDir.absolutePath}/runtime_libs/jre17"
-        )
+        ).run { copy(uiScale = displayUiScale(screenWidth, screenHeight)) }
 
         val jarPath = "${config.home}/app.jar"
+        streamSession.prepareLaunch(jarPath)
 
         val progressChannel = javaLauncherManager.launchApplicationWithFlow(config, jarPath)
 
@@ -118,6 +183,50 @@ class AwtActivity : ComponentActivity() {
         }
     }
 
+    /**
+     * 按屏幕密度计算UI缩放比例
+     *
+     * 以displayMetrics.density渲染，使文字和图形在高密度屏幕上按原生分辨率光栅化；
+     * 渲染分辨率不超过屏幕的物理像素，超过的部分在显示时也会被缩小，只会增加捕获和传输的数据量
+     *
+     * @param screenWidth 虚拟屏幕的逻辑宽度
+     * @param screenHeight 虚拟屏幕的逻辑高度
+     * @return 不小于1的缩放比例
+     */
+    private fun displayUiScale(screenWidth: Int, screenHeight: Int): Float {
+        val metrics = resources.displayMetrics
+        // 全屏时为横屏，长边对应虚拟屏幕的宽度
+        val longSide = maxOf(metrics.widthPixels, metrics.heightPixels)
+        val shortSide = minOf(metrics.widthPixels, metrics.heightPixels)
+        val fit = minOf(longSide.toFloat() / screenWidth, shortSide.toFloat() / screenHeight)
+        return metrics.density.coerceAtMost(fit).coerceAtLeast(1f)
+    }
+
+    /**
+     * 把当前输入法子类型的语言告知会话，子类型没有语言时使用系统区域
+     */
+    private fun updateKeyboardLocale() {
+        val inputMethodManager = getSystemService(InputMethodManager::class.java)
+        val languageTag = inputMethodManager?.currentInputMethodSubtype?.languageTag
+            ?.takeIf { it.isNotEmpty() }
+            ?: resources.configuration.locales[0].toLanguageTag()
+        streamSession.setKeyboardLocale(languageTag)
+    }
+
+    /**
+     * 导出跨进程追踪数据到应用外部存储的traces目录
+     */
+    private fun exportTrace() {
+        val directory = getExternalFilesDir("traces") ?: File(filesDir, "traces")
+        CoroutineScope(Dispatchers.IO).launch {
+            val files = Tracing.export(directory)
+            withContext(Dispatchers.Main) {
+                val message = if (files.isEmpty()) "追踪数据导出失败" else "已导出到 ${directory.absolutePath}"
+                Toast.makeText(this@AwtActivity, message, Toast.LENGTH_LONG).show()
+            }
+        }
+    }
+
     companion object {
         const val TAG = "AwtActivity"
     }
@@ -16,7 +16,10 @@ import androidx.compose.foundation.layout.fillMaxSize
 import androidx.compose.foundation.layout.fillMaxWidth
 import androidx.compose.foundation.layout.height
 import androidx.compose.foundation.layout.padding
+import androidx.compose.foundation.layout.width
 import androidx.compose.foundation.shape.RoundedCornerShape
+import androidx.compose.foundation.text.KeyboardActions
+import androidx.compose.foundation.text.KeyboardOptions
 import androidx.compose.material3.Button
 import androidx.compose.material3.ButtonDefaults
 import androidx.compose.material3.Card
@@ -25,6 +28,7 @@ import androidx.compose.material3.OutlinedTextField
 import androidx.compose.material3.Surface
 import androidx.compose.material3.Text
 import androidx.compose.runtime.Composable
+import androidx.compose.runtime.LaunchedEffect
 import androidx.compose.runtime.collectAsState
 import androidx.compose.runtime.getValue
 import androidx.compose.runtime.mutableStateOf
@@ -34,6 +38,8 @@ import androidx.compose.ui.Alignment
 import androidx.compose.ui.Modifier
 import androidx.compose.ui.draw.clip
 import androidx.compose.ui.draw.drawWithContent
+import androidx.compose.ui.focus.FocusRequester
+import androidx.compose.ui.focus.focusRequester
 import androidx.compose.ui.geometry.Offset
 import androidx.compose.ui.geometry.Rect
 import androidx.compose.ui.geometry.Size
@@ -42,10 +48,13 @@ import androidx.compose.ui.graphics.asImageBitmap
 import androidx.compose.ui.graphics.drawscope.Stroke
 import androidx.compose.ui.input.pointer.pointerInput
 import androidx.compose.ui.layout.ContentScale
+import androidx.compose.ui.platform.LocalClipboardManager
+import androidx.compose.ui.text.input.ImeAction
 import androidx.compose.ui.tooling.preview.Preview
 import androidx.compose.ui.unit.dp
 import androidx.hilt.lifecycle.viewmodel.compose.hiltViewModel
 import io.github.eurya.awt.data.state.AwtUiState
+import io.github.eurya.awt.utils.Tracing
 import io.github.eurya.awt.viewmodel.AwtViewModel
 import kotlin.math.min
 
@@ -192,6 +201,7 @@ fun StatisticsView(uiState: AwtUiState) {
                 StatisticItem("FPS", String.format("%.1f", uiState.fps))
                 StatisticItem("数据速率", String.format("%.2f MB/s", uiState.dataRate))
                 StatisticItem("分辨率", "${uiState.width}x${uiState.height}")
+                StatisticItem("UI缩放", String.format("%.2fx", uiState.uiScale))
                 StatisticItem("像素格式", uiState.pixelFormat)
             } else {
                 Text(
@@ -339,6 +349,7 @@ fun ConnectionStatusView(uiState: AwtUiState) {
  * 功能：
  * - 专门为全屏模式设计的图像显示和交互界面，提供精确的点击坐标映射
  * - 支持图像保持原始比例居中显示，并带有红色边框标识图像边界
+ * - 长按画面打开文本输入栏，输入法整句和剪贴板内容作为一条TEXT_COMMIT提交到焦点组件
  *
  * @param viewModel 远程桌面视图模型，用于处理用户交互事件
  */
@@ -346,6 +357,7 @@ fun ConnectionStatusView(uiState: AwtUiState) {
 fun DisplayViewFull(viewModel: AwtViewModel = hiltViewModel()) {
     val uiState by viewModel.uiState.collectAsState()
     var imageDisplayRect by remember { mutableStateOf(Rect.Zero) }
+    var showTextInput by remember { mutableStateOf(false) }
 
     if (!uiState.isConnected)
         viewModel.connect("localhost", 8888)
@@ -357,7 +369,12 @@ fun DisplayViewFull(viewModel: AwtViewModel = hiltViewModel()) {
                 .aspectRatio(uiState.width.toFloat() / uiState.height.toFloat())
                 .background(Color.Black)
                 .pointerInput(uiState.width, uiState.height) {
-                    detectTapGestures { offset ->
+                    detectTapGestures(onLongPress = {
+                        if (!uiState.isPlaceholder) showTextInput = true
+                    }) { offset ->
+                        // 占位快照不对应真实画面，点击不转发
+                        if (uiState.isPlaceholder) return@detectTapGestures
+
                         val relativeX = offset.x - imageDisplayRect.left
                         val relativeY = offset.y - imageDisplayRect.top
 
@@ -402,7 +419,9 @@ fun DisplayViewFull(viewModel: AwtViewModel = hiltViewModel()) {
                             bottom = top + scaledHeight
                         )
 
+                        val drawStart = System.nanoTime()
                         drawContent()
+                        Tracing.slice(Tracing.DRAW, drawStart, Tracing.frameFlow(uiState.frameId))
 
                         drawRect(
                             color = Color.Red,
@@ -413,6 +432,75 @@ fun DisplayViewFull(viewModel: AwtViewModel = hiltViewModel()) {
                     },
                 contentScale = ContentScale.Fit
             )
+
+            if (showTextInput) {
+                TextInputBar(
+                    onCommit = viewModel::commitText,
+                    onDismiss = { showTextInput = false },
+                    modifier = Modifier.align(Alignment.BottomCenter)
+                )
+            }
+        }
+    }
+}
+
+/**
+ * 文本输入栏组件
+ *
+ * 功能：
+ * - 打开时自动获取焦点并弹出输入法，输入法组合完成后按发送键把整段文本一次提交
+ * - 粘贴按钮把剪贴板中的文本原样提交，不经过输入框
+ * - 文本以单条TEXT_COMMIT发送，服务端直接插入焦点组件，不逐字符模拟按键
+ *
+ * @param onCommit 提交文本的回调
+ * @param onDismiss 关闭输入栏的回调
+ * @param modifier 输入栏在画面中的位置
+ */
+@Composable
+fun TextInputBar(onCommit: (String) -> Unit, onDismiss: () -> Unit, modifier: Modifier = Modifier) {
+    val clipboard = LocalClipboardManager.current
+    val focusRequester = remember { FocusRequester() }
+    var text by remember { mutableStateOf("") }
+
+    LaunchedEffect(Unit) { focusRequester.requestFocus() }
+
+    Surface(
+        modifier = modifier
+            .fillMaxWidth()
+            .padding(8.dp),
+        color = MaterialTheme.colorScheme.surface.copy(alpha = 0.9f),
+        shape = MaterialTheme.shapes.small
+    ) {
+        Row(
+            modifier = Modifier.padding(8.dp),
+            verticalAlignment = Alignment.CenterVertically
+        ) {
+            OutlinedTextField(
+                value = text,
+                onValueChange = { text = it },
+                label = { Text("输入文本") },
+                singleLine = true,
+                keyboardOptions = KeyboardOptions(imeAction = ImeAction.Send),
+                keyboardActions = KeyboardActions(onSend = {
+                    onCommit(text)
+                    text = ""
+                }),
+                modifier = Modifier
+                    .weight(1f)
+                    .focusRequester(focusRequester)
+            )
+
+            Spacer(modifier = Modifier.width(8.dp))
+
+            Button(onClick = { clipboard.getText()?.text?.let(onCommit) }) {
+                Text("粘贴")
+            }
+
+            Spacer(modifier = Modifier.width(8.dp))
+
+            Button(onClick = onDismiss) {
+                Text("关闭")
+            }
         }
     }
 }
@@ -85,7 +85,7 @@ fun InitScreen(
             }
 
             is InitState.Extracting -> {
-                ExtractingView()
+                ExtractingView(libraries = libraries)
             }
 
             is InitState.Success -> {
@@ -147,9 +147,11 @@ private fun CheckingView() {
  * 功能：
  * - 显示运行库解压进度
  * - 实时更新每个库文件的解压状态
+ *
+ * @param libraries 正在解压的运行库列表，包含每个库的解压进度
  */
 @Composable
-private fun ExtractingView() {
+private fun ExtractingView(libraries: List<RuntimeLibrary>) {
 
     Column(
         horizontalAlignment = Alignment.CenterHorizontally,
@@ -164,6 +166,7 @@ private fun ExtractingView() {
             color = MaterialTheme.colorScheme.primary
         )
 
+        LibraryList(libraries = libraries)
     }
 }
 
@@ -296,6 +299,10 @@ private fun LibraryItem(library: RuntimeLibrary) {
                     contentDescription = "已解压",
                     tint = MaterialTheme.colorScheme.primary
                 )
+            } else if (library.progress > 0f) {
+                CircularProgressIndicator(
+                    progress = { library.progress }, modifier = Modifier.size(20.dp)
+                )
             } else {
                 CircularProgressIndicator(modifier = Modifier.size(20.dp))
             }
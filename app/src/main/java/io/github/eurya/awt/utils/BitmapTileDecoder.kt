@@ -0,0 +1,46 @@
+package io.github.eurya.awt.utils
+
+import android.graphics.Bitmap
+import android.graphics.BitmapFactory
+import io.github.eurya.awt.codec.TileFrameDecoder
+import io.github.eurya.awt.codec.TileImageDecoder
+import java.io.IOException
+
+/**
+ * 基于BitmapFactory的JPEG分块解码器
+ *
+ * 功能：
+ * - 解码服务端发送的照片类分块，BitmapFactory内部使用libjpeg-turbo，IDCT和颜色转换带NEON加速
+ * - 完整尺寸的块通过inBitmap复用同一个Bitmap，避免每块分配；边缘块尺寸不同，单独解码
+ *
+ * 只在接收线程中使用，不是线程安全的
+ *
+ * @author qz919
+ * @data 2025/10/07
+ */
+class BitmapTileDecoder : TileImageDecoder {
+
+    private val reusable: Bitmap = Bitmap.createBitmap(
+        TileFrameDecoder.TILE_SIZE, TileFrameDecoder.TILE_SIZE, Bitmap.Config.ARGB_8888
+    )
+
+    private val options = BitmapFactory.Options().apply {
+        inPreferredConfig = Bitmap.Config.ARGB_8888
+        inMutable = true
+    }
+
+    override fun decode(data: ByteArray, offset: Int, length: Int, width: Int, height: Int, out: IntArray) {
+        val fullTile = width == reusable.width && height == reusable.height
+        options.inBitmap = if (fullTile) reusable else null
+        val bitmap = BitmapFactory.decodeByteArray(data, offset, length, options)
+            ?: throw IOException("无法解码JPEG块")
+        try {
+            if (bitmap.width != width || bitmap.height != height) {
+                throw IOException("JPEG块尺寸不匹配: ${bitmap.width}x${bitmap.height}")
+            }
+            bitmap.getPixels(out, 0, width, 0, 0, width, height)
+        } finally {
+            if (bitmap !== reusable) bitmap.recycle()
+        }
+    }
+}
@@ -0,0 +1,58 @@
+package io.github.eurya.awt.utils
+
+import android.util.Log
+
+/**
+ * 线程I/O优先级工具
+ *
+ * 功能：
+ * - 通过libmy_awt中的ioprio_set调整当前线程的I/O调度优先级
+ * - 优先级会被之后创建的子线程继承，适合在启动解压器前临时降级
+ *
+ * @author qz919
+ * @data 2025/10/05
+ */
+object IoPriority {
+
+    private const val TAG = "IoPriority"
+
+    /** 尽力而为调度类，等级0到7，数值越大优先级越低 */
+    private const val CLASS_BEST_EFFORT = 2
+    private const val CLASS_SHIFT = 13
+    private const val LOWEST_LEVEL = 7
+
+    /** 设置失败时的返回值 */
+    const val UNCHANGED = -1
+
+    private val isAvailable: Boolean = try {
+        System.loadLibrary("my_awt")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        Log.w(TAG, "无法加载原生库: ${e.message}")
+        false
+    }
+
+    /**
+     * 把当前线程降到尽力而为调度类的最低等级
+     *
+     * 不使用idle调度类，避免前台持续读写时后台解压完全得不到执行
+     *
+     * @return 之前的优先级（ioprio_get的原始值，包括未显式设置时的默认值），传给[restore]以原样恢复；失败时为[UNCHANGED]
+     */
+    fun lowerCurrentThread(): Int {
+        if (!isAvailable) return UNCHANGED
+        return nativeSet((CLASS_BEST_EFFORT shl CLASS_SHIFT) or LOWEST_LEVEL)
+    }
+
+    /**
+     * 恢复当前线程的I/O优先级
+     *
+     * @param previous [lowerCurrentThread]的返回值
+     */
+    fun restore(previous: Int) {
+        if (previous != UNCHANGED) nativeSet(previous)
+    }
+
+    @JvmStatic
+    private external fun nativeSet(value: Int): Int
+}
@@ -1,6 +1,7 @@
 package io.github.eurya.awt.utils
 
 import android.util.Log
+import io.github.eurya.awt.codec.JvmLaunchFlags
 import io.github.eurya.awt.data.JavaConfig
 import io.github.eurya.awt.data.LaunchResult
 import io.github.eurya.awt.exception.JavaRuntimeException
@@ -32,6 +33,9 @@ class NativeJavaLauncher private constructor(
 
         const val TAG = "NativeJavaLauncher"
 
+        /** buildRuntime合并cacio-shared和cacio-tta生成的引导JAR */
+        private const val BOOT_JAR_NAME = "cacio-boot.jar"
+
         init {
             try {
                 System.loadLibrary("my_awt")
@@ -399,62 +403,27 @@ class NativeJavaLauncher private constructor(
     /**
      * 添加系统属性参数
      *
-     * 配置AWT、图形环境和字体管理相关的系统属性
-     * 使用Cacio作为AWT工具包以在headless环境中提供图形支持
+     * 配置AWT、图形环境和字体管理相关的系统属性，与主机端回环基准测试共用[JvmLaunchFlags]
      */
     private fun addSystemProperties() {
-        javaArgList.addAll(
-            listOf(
-                "-Djava.awt.headless=false",
-                // 开启抗锯齿
-                "-Dawt.useSystemAAFontSettings=on",
-                "-Dswing.aatext=true",
-
-                "-Dcacio.managed.screensize=${config.screenWidth}x${config.screenHeight}",
-                "-Dcacio.font.fontmanager=sun.awt.X11FontManager",
-                "-Dcacio.font.fontscaler=sun.font.FreetypeFontScaler",
-                "-Dswing.defaultlaf=javax.swing.plaf.metal.MetalLookAndFeel",
-                "-Dawt.toolkit=com.github.caciocavallosilano.cacio.ctc.CTCToolkit",
-                "-Djava.awt.graphicsenv=com.github.caciocavallosilano.cacio.ctc.CTCGraphicsEnvironment",
-                "-Djava.system.class.loader=com.github.caciocavallosilano.cacio.ctc.CTCPreloadClassLoader"
-            )
-        )
+        javaArgList.addAll(JvmLaunchFlags.systemProperties(config.screenWidth, config.screenHeight, config.uiScale))
     }
 
     /**
      * 添加模块系统导出和打开指令
      *
-     * 配置Java模块系统以允许访问内部API
-     * 这些导出对于Cacio实现和AWT组件正常工作至关重要
+     * 配置Java模块系统以允许访问内部API，导出列表见[JvmLaunchFlags.MODULE_EXPORTS]
      */
     private fun addModuleExports() {
-        javaArgList.addAll(
-            listOf(
-                "--add-exports=java.desktop/java.awt=ALL-UNNAMED",
-                "--add-exports=java.desktop/java.awt.peer=ALL-UNNAMED",
-                "--add-exports=java.desktop/sun.awt.image=ALL-UNNAMED",
-                "--add-exports=java.desktop/sun.java2d=ALL-UNNAMED",
-                "--add-exports=java.desktop/java.awt.dnd.peer=ALL-UNNAMED",
-                "--add-exports=java.desktop/sun.awt=ALL-UNNAMED",
-                "--add-exports=java.desktop/sun.awt.event=ALL-UNNAMED",
-                "--add-exports=java.desktop/sun.awt.datatransfer=ALL-UNNAMED",
-                "--add-exports=java.desktop/sun.font=ALL-UNNAMED",
-                "--add-exports=java.base/sun.security.action=ALL-UNNAMED",
-                "--add-opens=java.base/java.util=ALL-UNNAMED",
-                "--add-opens=java.desktop/java.awt=ALL-UNNAMED",
-                "--add-opens=java.desktop/sun.font=ALL-UNNAMED",
-                "--add-opens=java.desktop/sun.java2d=ALL-UNNAMED",
-                "--add-opens=java.base/java.lang.reflect=ALL-UNNAMED",
-                "--add-opens=java.base/java.net=ALL-UNNAMED"
-            )
-        )
+        javaArgList.addAll(JvmLaunchFlags.MODULE_EXPORTS)
     }
 
     /**
      * 设置引导类路径
      *
-     * 扫描Cacio目录下的JAR文件并添加到引导类路径
-     * 特殊的argent JAR文件将作为Java代理加载
+     * 优先只把合并后的cacio-boot.jar加入引导类路径，argent JAR作为Java代理加载
+     * 存在cacio-boot.jar时目录中残留的其他JAR（旧版本的cacio-shared.jar、cacio-tta.jar）被忽略，避免同名类出现在两个JAR中；
+     * 运行库还是旧的打包方式、没有cacio-boot.jar时退回到把这些JAR逐个加入引导类路径
      */
     private fun setupBootClasspath() {
         val cacioDir = File(config.jrePath, "cacio")
@@ -462,20 +431,28 @@ class NativeJavaLauncher private constructor(
             file.isFile && file.name.endsWith(".jar")
         } ?: emptyArray()
 
-        if (jarFiles.isNotEmpty()) {
-            val classpath = StringBuilder().append("-Xbootclasspath/a:")
-            jarFiles.forEach { file ->
-                if (!file.name.contains("argent")) {
-                    classpath.append(file.absolutePath).append(":")
-                } else {
-                    javaArgList.add("-javaagent:${file.absolutePath}")
-                }
+        val bootJar = jarFiles.firstOrNull { it.name == BOOT_JAR_NAME }
+        val agentJar = jarFiles.firstOrNull { it.name.contains("argent") }
+        val legacyJars = jarFiles.filter { it != bootJar && it != agentJar }.sortedBy { it.name }
+
+        if (agentJar != null) {
+            // 启用追踪时把共享缓冲区的fd交给Agent，子进程通过/proc/self/fd映射
+            val agentArgs = if (Tracing.isEnabled) "=trace=${Tracing.fd}" else ""
+            javaArgList.add("-javaagent:${agentJar.absolutePath}$agentArgs")
+        }
+        when {
+            bootJar != null -> {
+                legacyJars.forEach { Log.w(TAG, "忽略Cacio目录中的多余JAR文件: ${it.name}") }
+                javaArgList.add("-Xbootclasspath/a:${bootJar.absolutePath}")
+                Log.w(TAG, "添加Cacio引导类路径: ${bootJar.name}")
+            }
+
+            legacyJars.isNotEmpty() -> {
+                javaArgList.add("-Xbootclasspath/a:" + legacyJars.joinToString(File.pathSeparator) { it.absolutePath })
+                Log.w(TAG, "未找到$BOOT_JAR_NAME，使用旧的引导JAR: ${legacyJars.joinToString { it.name }}")
             }
 
-            javaArgList.add(classpath.toString())
-            Log.w(TAG, "添加Cacio类路径，包含 ${jarFiles.size} 个JAR文件")
-        } else {
-            Log.w(TAG, "警告: 未找到Cacio JAR文件")
+            else -> Log.w(TAG, "警告: 未找到Cacio引导JAR")
         }
     }
 
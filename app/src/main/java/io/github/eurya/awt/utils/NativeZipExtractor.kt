@@ -0,0 +1,84 @@
+package io.github.eurya.awt.utils
+
+import android.content.res.AssetManager
+import android.util.Log
+import java.io.File
+import java.io.IOException
+
+/**
+ * 原生资源解压器
+ *
+ * 功能：
+ * - 通过libmy_awt中的原生实现解压assets中的ZIP归档
+ * - 未压缩存储的资源直接映射APK中的数据，由zlib原地解压并pwrite到预分配的输出文件
+ * - 与[ParallelZipExtractor]行为一致：并行解压、路径遍历检查、按归档汇报进度
+ *
+ * @author qz919
+ * @data 2025/10/03
+ */
+object NativeZipExtractor {
+
+    private const val TAG = "NativeZipExtractor"
+
+    /**
+     * 原生库是否加载成功，加载失败时调用方应退回到[ParallelZipExtractor]
+     */
+    val isAvailable: Boolean = try {
+        System.loadLibrary("my_awt")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        Log.w(TAG, "原生解压器不可用: ${e.message}")
+        false
+    }
+
+    /**
+     * 解压进度监听器，回调在调用[extract]的线程上执行
+     */
+    fun interface ProgressListener {
+        /**
+         * @param index 归档在assetPaths中的下标
+         * @param extractedBytes 已解压的未压缩字节数
+         * @param totalBytes 归档内所有条目的未压缩总字节数
+         */
+        fun onProgress(index: Int, extractedBytes: Long, totalBytes: Long)
+    }
+
+    /**
+     * 并行解压assets中的多个归档到同一目录，阻塞直到完成
+     *
+     * @param assets AssetManager实例
+     * @param assetPaths 归档在assets中的路径
+     * @param include 每个归档需要解压的条目，键为assetPaths中的路径，为null或缺少对应归档时全部解压
+     * @param targetDir 解压目标目录
+     * @param workerCount 并发解压的线程数
+     * @param listener 进度监听器
+     * @throws IOException 当归档无效、条目不安全或写入失败时抛出
+     */
+    @Throws(IOException::class)
+    fun extract(
+        assets: AssetManager,
+        assetPaths: List<String>,
+        include: Map<String, Set<String>>?,
+        targetDir: File,
+        workerCount: Int = ParallelZipExtractor.defaultWorkerCount(),
+        listener: ProgressListener? = null
+    ) {
+        val includeArrays = include?.let { map ->
+            Array(assetPaths.size) { map[assetPaths[it]]?.toTypedArray() }
+        }
+        nativeExtract(
+            assets, assetPaths.toTypedArray(), includeArrays, targetDir.absolutePath,
+            workerCount, listener
+        )
+    }
+
+    @JvmStatic
+    private external fun nativeExtract(
+        assets: AssetManager,
+        assetPaths: Array<String>,
+        include: Array<Array<String>?>?,
+        targetDir: String,
+        workerCount: Int,
+        listener: ProgressListener?
+    )
+}
@@ -0,0 +1,387 @@
+package io.github.eurya.awt.utils
+
+import java.io.Closeable
+import java.io.File
+import java.io.FileOutputStream
+import java.io.IOException
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.channels.FileChannel
+import java.util.concurrent.ExecutionException
+import java.util.concurrent.Executors
+import java.util.concurrent.Future
+import java.util.concurrent.atomic.AtomicLong
+import java.util.zip.DataFormatException
+import java.util.zip.Inflater
+import java.util.zip.ZipException
+
+/**
+ * 多归档并行解压器
+ *
+ * 功能：
+ * - 直接解析ZIP中央目录，通过FileChannel的定位读取随机访问各条目，不再依赖顺序的ZipInputStream
+ * - 所有归档的条目统一放入有界线程池中解压，大条目优先调度，小条目合并成批次以减少调度开销
+ * - 按归档汇报已解压的字节数，供界面显示每个库的解压进度
+ * - 保留路径遍历检查，拒绝解压到目标目录之外的条目
+ * - 每个文件先写入临时文件再原子重命名，中途崩溃不会留下写了一半的文件
+ *
+ * @property workerCount 并发解压的线程数，默认取CPU核心数并限制在[1, MAX_WORKERS]之间
+ *
+ * @author qz919
+ * @data 2025/10/02
+ */
+class ParallelZipExtractor(
+    private val workerCount: Int = defaultWorkerCount()
+) {
+
+    companion object {
+        /** 线程池的线程数上限，更多线程只会在存储带宽上互相争抢 */
+        const val MAX_WORKERS = 8
+
+        /** 超过该大小的条目单独作为一个任务，其余条目合并成批次 */
+        private const val LARGE_ENTRY_BYTES = 1L shl 20
+
+        /** 小条目批次的目标未压缩大小 */
+        private const val BATCH_BYTES = 2L shl 20
+
+        private const val BUFFER_SIZE = 64 * 1024
+
+        private const val EOCD_SIGNATURE = 0x06054b50
+        private const val CEN_SIGNATURE = 0x02014b50
+        private const val LOC_SIGNATURE = 0x04034b50
+        private const val EOCD_MIN_SIZE = 22
+        private const val CEN_HEADER_SIZE = 46
+        private const val LOC_HEADER_SIZE = 30
+        private const val MAX_COMMENT_SIZE = 0xffff
+
+        private const val METHOD_STORED = 0
+        private const val METHOD_DEFLATED = 8
+
+        /** 解压中的临时文件后缀，写完后重命名为最终文件名 */
+        const val TEMP_SUFFIX = ".extracting"
+
+        fun defaultWorkerCount(): Int =
+            Runtime.getRuntime().availableProcessors().coerceIn(1, MAX_WORKERS)
+    }
+
+    /**
+     * 可随机访问的ZIP数据源
+     *
+     * 归档可能是独立文件，也可能是APK中未压缩存储的一段数据，
+     * 因此除通道外还需要记录归档在通道中的起始偏移和长度
+     *
+     * @property name 归档名称，用于进度回调和错误信息
+     * @property channel 支持定位读取的文件通道，多个线程可以同时读取
+     * @property offset 归档在通道中的起始偏移
+     * @property length 归档的字节长度
+     * @property owner 关闭数据源时需要一并关闭的对象
+     */
+    class Source(
+        val name: String,
+        val channel: FileChannel,
+        val offset: Long,
+        val length: Long,
+        private val owner: Closeable
+    ) : Closeable {
+        override fun close() = owner.close()
+    }
+
+    /**
+     * 单个归档的解压进度
+     *
+     * @property name 归档名称
+     * @property extractedBytes 已解压的未压缩字节数
+     * @property totalBytes 归档内所有条目的未压缩总字节数
+     */
+    data class Progress(val name: String, val extractedBytes: Long, val totalBytes: Long) {
+        val fraction: Float
+            get() = if (totalBytes > 0) extractedBytes.toFloat() / totalBytes else 1f
+    }
+
+    /**
+     * 归档中一个条目的内容摘要，来自中央目录，读取时无需解压
+     *
+     * @property name 条目路径
+     * @property crc 条目内容的CRC32
+     * @property size 未压缩大小
+     */
+    data class EntryInfo(val name: String, val crc: Long, val size: Long) {
+        val isDirectory: Boolean get() = name.endsWith("/")
+    }
+
+    /**
+     * 中央目录中的一个条目
+     */
+    private class Entry(
+        val source: Source,
+        val name: String,
+        val method: Int,
+        val crc: Long,
+        val compressedSize: Long,
+        val size: Long,
+        val localHeaderOffset: Long
+    ) {
+        val isDirectory: Boolean get() = name.endsWith("/")
+    }
+
+    /**
+     * 只读取中央目录，列出归档中所有条目的内容摘要
+     *
+     * @param source 归档数据源
+     * @return 条目摘要列表，顺序与中央目录一致
+     * @throws IOException 当归档格式错误时抛出
+     */
+    fun listEntries(source: Source): List<EntryInfo> =
+        readCentralDirectory(source).map { EntryInfo(it.name, it.crc, it.size) }
+
+    /**
+     * 并行解压所有归档到同一个目标目录
+     *
+     * 调用方负责打开和关闭数据源；该方法阻塞直到所有条目写入完成，
+     * 任意条目失败都会取消剩余任务并抛出异常
+     *
+     * @param sources 待解压的归档数据源
+     * @param targetDir 解压目标目录
+     * @param include 每个归档需要解压的条目，未出现在映射中的归档全部解压
+     * @param onProgress 进度回调，可能在任意工作线程上调用
+     * @throws SecurityException 当检测到不安全的ZIP条目时抛出
+     * @throws IOException 当归档格式错误或写入失败时抛出
+     */
+    fun extract(
+        sources: List<Source>,
+        targetDir: File,
+        include: Map<String, Set<String>> = emptyMap(),
+        onProgress: (Progress) -> Unit = {}
+    ) {
+        val targetPath = targetDir.canonicalPath + File.separator
+        val entries = sources.associateWith { source ->
+            val all = readCentralDirectory(source)
+            val names = include[source.name]
+            if (names == null) all else all.filter { it.name in names }
+        }
+
+        // 先在当前线程创建所有目录，工作线程只需要写文件
+        entries.values.flatten().forEach { entry ->
+            val file = resolve(targetDir, targetPath, entry.name)
+            if (entry.isDirectory) file.mkdirs() else file.parentFile?.mkdirs()
+        }
+
+        val totals = entries.mapValues { (_, list) -> list.sumOf { it.size } }
+        val counters = sources.associateWith { AtomicLong() }
+        val report: (Source, Long) -> Unit = { source, bytes ->
+            val done = counters.getValue(source).addAndGet(bytes)
+            onProgress(Progress(source.name, done, totals.getValue(source)))
+        }
+
+        val pool = Executors.newFixedThreadPool(workerCount)
+        try {
+            val futures = planTasks(entries.values.flatten()).map { batch ->
+                pool.submit<Unit> {
+                    val input = ByteArray(BUFFER_SIZE)
+                    val output = ByteArray(BUFFER_SIZE)
+                    val inflater = Inflater(true)
+                    try {
+                        batch.forEach { entry ->
+                            val file = resolve(targetDir, targetPath, entry.name)
+                            extractEntry(entry, file, input, output, inflater)
+                            report(entry.source, entry.size)
+                        }
+                    } finally {
+                        inflater.end()
+                    }
+                }
+            }
+            awaitAll(futures)
+        } finally {
+            pool.shutdownNow()
+        }
+    }
+
+    /**
+     * 把条目分配成任务：大条目按大小降序单独成任务，小条目按顺序合并成批次
+     *
+     * 大条目先提交，保证耗时最长的工作最先开始，尾部只剩下小批次填补空闲线程
+     */
+    private fun planTasks(entries: List<Entry>): List<List<Entry>> {
+        val files = entries.filterNot { it.isDirectory }
+        val (large, small) = files.partition { it.size >= LARGE_ENTRY_BYTES }
+
+        val tasks = large.sortedByDescending { it.size }.mapTo(mutableListOf()) { listOf(it) }
+        var batch = mutableListOf<Entry>()
+        var batchBytes = 0L
+        small.forEach { entry ->
+            batch.add(entry)
+            batchBytes += entry.size
+            if (batchBytes >= BATCH_BYTES) {
+                tasks.add(batch)
+                batch = mutableListOf()
+                batchBytes = 0L
+            }
+        }
+        if (batch.isNotEmpty()) tasks.add(batch)
+        return tasks
+    }
+
+    private fun awaitAll(futures: List<Future<Unit>>) {
+        try {
+            futures.forEach { it.get() }
+        } catch (e: ExecutionException) {
+            futures.forEach { it.cancel(true) }
+            when (val cause = e.cause) {
+                is IOException -> throw cause
+                is RuntimeException -> throw cause
+                else -> throw IOException(cause)
+            }
+        }
+    }
+
+    private fun resolve(targetDir: File, targetPath: String, entryName: String): File {
+        val file = File(targetDir, entryName)
+        val path = file.canonicalPath
+        if (!path.startsWith(targetPath) && path + File.separator != targetPath) {
+            throw SecurityException("不安全的ZIP条目: $entryName")
+        }
+        return file
+    }
+
+    /**
+     * 解压单个条目，压缩数据通过定位读取获得，不影响其他线程对同一通道的读取
+     *
+     * 数据先写入同目录下的临时文件，完成后原子重命名替换旧文件
+     */
+    private fun extractEntry(
+        entry: Entry, file: File, buffer: ByteArray, output: ByteArray, inflater: Inflater
+    ) {
+        // 存储条目按size复制，与compressedSize不一致说明条目头被篡改或损坏，写入任何数据前拒绝
+        if (entry.method == METHOD_STORED && entry.size != entry.compressedSize) {
+            throw ZipException("存储条目大小不一致: ${entry.name}")
+        }
+        val temp = File(file.path + TEMP_SUFFIX)
+        try {
+            FileOutputStream(temp).use { fos ->
+                if (entry.method == METHOD_STORED) {
+                    copyStored(entry, fos)
+                } else {
+                    inflateEntry(entry, fos, buffer, output, inflater)
+                }
+            }
+            if (!temp.renameTo(file)) {
+                throw IOException("无法替换文件: ${file.path}")
+            }
+        } finally {
+            temp.delete()
+        }
+    }
+
+    private fun copyStored(entry: Entry, fos: FileOutputStream) {
+        val source = entry.source
+        val position = source.offset + dataOffset(entry)
+        val channel = fos.channel
+        var written = 0L
+        while (written < entry.size) {
+            val n = source.channel.transferTo(position + written, entry.size - written, channel)
+            if (n <= 0) throw ZipException("条目数据不完整: ${entry.name}")
+            written += n
+        }
+    }
+
+    private fun inflateEntry(
+        entry: Entry, fos: FileOutputStream, buffer: ByteArray, output: ByteArray, inflater: Inflater
+    ) {
+        val source = entry.source
+        var position = source.offset + dataOffset(entry)
+        var remaining = entry.compressedSize
+        val input = ByteBuffer.wrap(buffer)
+
+        inflater.reset()
+        try {
+            while (!inflater.finished()) {
+                if (inflater.needsInput()) {
+                    if (remaining <= 0) throw ZipException("条目数据不完整: ${entry.name}")
+                    input.clear()
+                    input.limit(minOf(input.capacity().toLong(), remaining).toInt())
+                    val n = source.channel.read(input, position)
+                    if (n <= 0) throw ZipException("条目数据不完整: ${entry.name}")
+                    position += n
+                    remaining -= n
+                    inflater.setInput(buffer, 0, n)
+                }
+                val n = inflater.inflate(output)
+                if (n > 0) fos.write(output, 0, n)
+            }
+        } catch (e: DataFormatException) {
+            throw ZipException("条目数据损坏: ${entry.name}").apply { initCause(e) }
+        }
+    }
+
+    /**
+     * 读取本地文件头，计算条目数据相对归档起始位置的偏移
+     */
+    private fun dataOffset(entry: Entry): Long {
+        val header = readFully(entry.source, entry.localHeaderOffset, LOC_HEADER_SIZE)
+        if (header.getInt(0) != LOC_SIGNATURE) {
+            throw ZipException("无效的本地文件头: ${entry.name}")
+        }
+        val nameLength = header.getShort(26).toInt() and 0xffff
+        val extraLength = header.getShort(28).toInt() and 0xffff
+        return entry.localHeaderOffset + LOC_HEADER_SIZE + nameLength + extraLength
+    }
+
+    /**
+     * 定位并解析中央目录；不支持ZIP64和加密条目
+     */
+    private fun readCentralDirectory(source: Source): List<Entry> {
+        val tailSize = minOf(source.length, (EOCD_MIN_SIZE + MAX_COMMENT_SIZE).toLong()).toInt()
+        val tail = readFully(source, source.length - tailSize, tailSize)
+        var eocd = tailSize - EOCD_MIN_SIZE
+        while (eocd >= 0 && tail.getInt(eocd) != EOCD_SIGNATURE) eocd--
+        if (eocd < 0) throw ZipException("未找到中央目录: ${source.name}")
+
+        val count = tail.getShort(eocd + 10).toInt() and 0xffff
+        val cenSize = tail.getInt(eocd + 12).toLong() and 0xffffffffL
+        val cenOffset = tail.getInt(eocd + 16).toLong() and 0xffffffffL
+        if (count == 0xffff || cenOffset == 0xffffffffL || cenOffset + cenSize > source.length) {
+            throw ZipException("不支持的归档格式: ${source.name}")
+        }
+
+        val cen = readFully(source, cenOffset, cenSize.toInt())
+        val entries = ArrayList<Entry>(count)
+        var pos = 0
+        repeat(count) {
+            if (cen.getInt(pos) != CEN_SIGNATURE) throw ZipException("中央目录损坏: ${source.name}")
+            val flags = cen.getShort(pos + 8).toInt() and 0xffff
+            val method = cen.getShort(pos + 10).toInt() and 0xffff
+            val crc = cen.getInt(pos + 16).toLong() and 0xffffffffL
+            val compressedSize = cen.getInt(pos + 20).toLong() and 0xffffffffL
+            val size = cen.getInt(pos + 24).toLong() and 0xffffffffL
+            val nameLength = cen.getShort(pos + 28).toInt() and 0xffff
+            val extraLength = cen.getShort(pos + 30).toInt() and 0xffff
+            val commentLength = cen.getShort(pos + 32).toInt() and 0xffff
+            val localOffset = cen.getInt(pos + 42).toLong() and 0xffffffffL
+
+            val nameBytes = ByteArray(nameLength)
+            cen.position(pos + CEN_HEADER_SIZE)
+            cen.get(nameBytes)
+            val name = String(nameBytes, Charsets.UTF_8)
+
+            if ((flags and 1) != 0 || (method != METHOD_STORED && method != METHOD_DEFLATED)) {
+                throw ZipException("不支持的条目: $name")
+            }
+            entries.add(Entry(source, name, method, crc, compressedSize, size, localOffset))
+            pos += CEN_HEADER_SIZE + nameLength + extraLength + commentLength
+        }
+        return entries
+    }
+
+    private fun readFully(source: Source, offset: Long, size: Int): ByteBuffer {
+        val buffer = ByteBuffer.allocate(size).order(ByteOrder.LITTLE_ENDIAN)
+        var position = source.offset + offset
+        while (buffer.hasRemaining()) {
+            val n = source.channel.read(buffer, position)
+            if (n < 0) throw ZipException("归档被截断: ${source.name}")
+            position += n
+        }
+        buffer.flip()
+        return buffer
+    }
+}
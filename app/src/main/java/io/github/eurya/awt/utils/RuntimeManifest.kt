@@ -0,0 +1,195 @@
+package io.github.eurya.awt.utils
+
+import java.io.File
+import java.io.FileOutputStream
+import java.io.IOException
+
+/**
+ * 运行库清单
+ *
+ * 功能：
+ * - 记录运行时目录中每个文件来自哪个归档，以及它的CRC32和大小
+ * - 清单内容直接取自归档的中央目录，无需解压或额外的构建步骤
+ * - 对比新旧清单得到增量：只有内容变化或新增的文件需要重新解压，旧版本独有的文件被删除
+ * - 写入时先写临时文件再原子重命名，清单只会在所有文件就绪之后才更新
+ *
+ * @property stamp 生成清单时安装包的更新时间，相同则说明assets没有变化
+ * @property archives 每个归档名对应的条目摘要列表
+ *
+ * @author qz919
+ * @data 2025/10/03
+ */
+class RuntimeManifest(
+    val stamp: Long,
+    val archives: Map<String, List<ParallelZipExtractor.EntryInfo>>
+) {
+
+    companion object {
+        const val FILE_NAME = ".runtime_manifest"
+
+        /** 失效的时间戳，带有该时间戳的清单总会触发一次增量解压 */
+        const val INVALID_STAMP = 0L
+
+        private const val HEADER = "# runtime manifest v1"
+        private const val STAMP_PREFIX = "stamp\t"
+        private const val ARCHIVE_PREFIX = "archive\t"
+
+        /**
+         * 读取目录中已安装的清单
+         *
+         * @param dir 运行时目录
+         * @return 清单对象，文件不存在或格式无法识别时返回null
+         */
+        fun read(dir: File): RuntimeManifest? {
+            val file = File(dir, FILE_NAME)
+            if (!file.isFile) return null
+            return try {
+                parse(file.readLines())
+            } catch (_: IOException) {
+                null
+            }
+        }
+
+        /**
+         * 只读取清单的安装包时间戳，不解析文件条目
+         *
+         * @param dir 运行时目录
+         * @return 时间戳，文件不存在或格式无法识别时返回null；解压中途的检查点为[INVALID_STAMP]
+         */
+        fun readStamp(dir: File): Long? {
+            val file = File(dir, FILE_NAME)
+            if (!file.isFile) return null
+            return try {
+                file.bufferedReader().use { reader ->
+                    if (reader.readLine() != HEADER) return null
+                    val stampLine = reader.readLine() ?: return null
+                    if (!stampLine.startsWith(STAMP_PREFIX)) return null
+                    stampLine.removePrefix(STAMP_PREFIX).toLongOrNull()
+                }
+            } catch (_: IOException) {
+                null
+            }
+        }
+
+        private fun parse(lines: List<String>): RuntimeManifest? {
+            if (lines.firstOrNull() != HEADER) return null
+            val stampLine = lines.getOrNull(1) ?: return null
+            if (!stampLine.startsWith(STAMP_PREFIX)) return null
+            val stamp = stampLine.removePrefix(STAMP_PREFIX).toLongOrNull() ?: return null
+
+            val archives = linkedMapOf<String, MutableList<ParallelZipExtractor.EntryInfo>>()
+            var current: MutableList<ParallelZipExtractor.EntryInfo>? = null
+            for (line in lines.drop(2)) {
+                if (line.isEmpty()) continue
+                if (line.startsWith(ARCHIVE_PREFIX)) {
+                    current = archives.getOrPut(line.removePrefix(ARCHIVE_PREFIX)) { mutableListOf() }
+                    continue
+                }
+                // 格式: crc(十六进制) \t 大小 \t 路径
+                val parts = line.split('\t', limit = 3)
+                if (parts.size != 3 || current == null) return null
+                val crc = parts[0].toLongOrNull(16) ?: return null
+                val size = parts[1].toLongOrNull() ?: return null
+                current.add(ParallelZipExtractor.EntryInfo(parts[2], crc, size))
+            }
+            return RuntimeManifest(stamp, archives)
+        }
+    }
+
+    /**
+     * 新旧清单之间的差异
+     *
+     * @property changed 每个归档中需要重新解压的条目
+     * @property removed 新清单中已不存在、需要删除的文件路径
+     * @property changedBytes 需要写入的未压缩字节数
+     */
+    data class Delta(
+        val changed: Map<String, Set<String>>,
+        val removed: List<String>,
+        val changedBytes: Long
+    ) {
+        val isEmpty: Boolean get() = removed.isEmpty() && changed.values.all { it.isEmpty() }
+    }
+
+    /** 所有文件条目，路径重复时以后面的归档为准 */
+    val files: Collection<ParallelZipExtractor.EntryInfo>
+        get() {
+            val result = LinkedHashMap<String, ParallelZipExtractor.EntryInfo>()
+            archives.values.forEach { list ->
+                list.forEach { if (!it.isDirectory) result[it.name] = it }
+            }
+            return result.values
+        }
+
+    /**
+     * 去掉指定文件并使时间戳失效，下次启动时这些文件会被视为缺失而重新解压
+     *
+     * @param names 需要重新解压的文件路径
+     * @return 新的清单对象
+     */
+    fun invalidate(names: Collection<String>): RuntimeManifest {
+        val set = names.toHashSet()
+        return RuntimeManifest(
+            INVALID_STAMP, archives.mapValues { (_, list) -> list.filterNot { it.name in set } }
+        )
+    }
+
+    /** 所有文件条目的总大小 */
+    val totalBytes: Long
+        get() = archives.values.sumOf { list -> list.sumOf { it.size } }
+
+    /**
+     * 计算从当前清单升级到目标清单需要做的改动
+     *
+     * 按路径比较CRC32和大小，与条目属于哪个归档无关，文件在归档之间移动且内容不变时不会重写
+     *
+     * @param target 新版本归档的清单
+     * @return 需要解压和删除的文件
+     */
+    fun diff(target: RuntimeManifest): Delta {
+        val installed = files.associateBy { it.name }
+
+        var changedBytes = 0L
+        val wanted = HashSet<String>()
+        val changed = target.archives.mapValues { (_, list) ->
+            list.filter { entry ->
+                if (entry.isDirectory) return@filter false
+                wanted.add(entry.name)
+                val old = installed[entry.name]
+                val needed = old == null || old.crc != entry.crc || old.size != entry.size
+                if (needed) changedBytes += entry.size
+                needed
+            }.mapTo(HashSet()) { it.name }
+        }
+        val removed = installed.keys.filterNot { it in wanted }
+        return Delta(changed, removed, changedBytes)
+    }
+
+    /**
+     * 把清单写入目录，先写临时文件再原子重命名
+     *
+     * @param dir 运行时目录
+     * @throws IOException 当写入或重命名失败时抛出
+     */
+    fun writeTo(dir: File) {
+        val temp = File(dir, FILE_NAME + ParallelZipExtractor.TEMP_SUFFIX)
+        FileOutputStream(temp).use { fos ->
+            val writer = fos.bufferedWriter()
+            writer.appendLine(HEADER)
+            writer.appendLine("$STAMP_PREFIX$stamp")
+            archives.forEach { (name, entries) ->
+                writer.appendLine("$ARCHIVE_PREFIX$name")
+                entries.forEach { entry ->
+                    writer.appendLine("${entry.crc.toString(16)}\t${entry.size}\t${entry.name}")
+                }
+            }
+            writer.flush()
+            // 清单是升级是否完成的唯一依据，重命名前确保内容已落盘
+            fos.fd.sync()
+        }
+        if (!temp.renameTo(File(dir, FILE_NAME))) {
+            temp.delete()
+            throw IOException("无法写入运行库清单")
+        }
+    }
+}
@@ -0,0 +1,86 @@
+package io.github.eurya.awt.utils
+
+import android.util.Log
+import java.io.File
+
+/**
+ * 运行库完整性校验器
+ *
+ * 功能：
+ * - 以运行库清单中的CRC32为期望值，由libmy_awt中的原生实现并行校验已解压的文件
+ * - 校验结果按(inode, size, mtime)缓存，元数据未变化的文件只需一次stat
+ * - 提供三种模式：只比较元数据、只校验元数据变化的文件、全部重新校验
+ *
+ * @author qz919
+ * @data 2025/10/04
+ */
+object RuntimeVerifier {
+
+    private const val TAG = "RuntimeVerifier"
+
+    /** 校验缓存文件名，以清单文件名开头以便在文件列表中一并排除 */
+    const val CACHE_FILE_NAME = RuntimeManifest.FILE_NAME + ".verify"
+
+    /**
+     * 校验模式，取值与原生实现一致
+     */
+    enum class Mode {
+        /** 只比较元数据和缓存，返回需要重新计算的文件 */
+        STAT_ONLY,
+
+        /** 只对元数据变化的文件计算CRC，返回损坏的文件 */
+        CHANGED,
+
+        /** 忽略缓存重新计算所有文件，返回损坏的文件 */
+        FULL
+    }
+
+    /**
+     * 原生库是否加载成功，不可用时跳过校验
+     */
+    val isAvailable: Boolean = try {
+        System.loadLibrary("my_awt")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        Log.w(TAG, "原生校验器不可用: ${e.message}")
+        false
+    }
+
+    /**
+     * 校验运行时目录中的文件
+     *
+     * @param runtimeDir 运行时目录
+     * @param entries 需要校验的文件及其期望的CRC32和大小，可以只传入部分文件，其余文件的缓存条目保持不变
+     * @param mode 校验模式
+     * @param workerCount 并发计算的线程数
+     * @return 未通过校验的文件路径（STAT_ONLY模式下为需要重新计算的文件）
+     */
+    fun verify(
+        runtimeDir: File,
+        entries: Collection<ParallelZipExtractor.EntryInfo>,
+        mode: Mode,
+        workerCount: Int = ParallelZipExtractor.defaultWorkerCount()
+    ): List<String> {
+        val files = entries.filterNot { it.isDirectory }
+        return nativeVerify(
+            runtimeDir.absolutePath,
+            files.map { it.name }.toTypedArray(),
+            LongArray(files.size) { files[it].crc },
+            LongArray(files.size) { files[it].size },
+            File(runtimeDir, CACHE_FILE_NAME).absolutePath,
+            workerCount,
+            mode.ordinal
+        ).toList()
+    }
+
+    @JvmStatic
+    private external fun nativeVerify(
+        runtimeDir: String,
+        names: Array<String>,
+        crcs: LongArray,
+        sizes: LongArray,
+        cachePath: String,
+        workerCount: Int,
+        mode: Int
+    ): Array<String>
+}
@@ -0,0 +1,116 @@
+package io.github.eurya.awt.utils
+
+import android.util.Log
+import java.io.File
+import java.text.SimpleDateFormat
+import java.util.Date
+import java.util.Locale
+
+/**
+ * 跨进程追踪工具
+ *
+ * 功能：
+ * - 在libmy_awt中创建共享追踪缓冲区（见trace_ring.hpp），启动器、查看器和JVM子进程中的Agent写入同一块内存
+ * - 查看器在接收、解码、绘制和发送输入时记录事件，帧和输入按序号通过流ID串联
+ * - 导出为Chrome JSON或Perfetto protobuf，可在ui.perfetto.dev中打开
+ *
+ * 时间戳使用System.nanoTime（CLOCK_MONOTONIC），与原生代码和JVM子进程一致。
+ * 名称编号需与trace_ring.hpp中的trace::Name保持一致
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+object Tracing {
+
+    private const val TAG = "Tracing"
+
+    /** 每个区域的槽位数，每个槽位40字节 */
+    private const val DEFAULT_SLOTS = 32768
+
+    const val RECEIVE = 20
+    const val DECODE = 21
+    const val DRAW = 22
+    const val INPUT = 23
+
+    private const val PHASE_COMPLETE = 'X'.code
+    private const val PHASE_INSTANT = 'i'.code
+
+    private const val FLOW_FRAME = 1L shl 56
+    private const val FLOW_INPUT = 2L shl 56
+
+    private val isAvailable: Boolean = try {
+        System.loadLibrary("my_awt")
+        true
+    } catch (e: UnsatisfiedLinkError) {
+        Log.w(TAG, "无法加载原生库: ${e.message}")
+        false
+    }
+
+    /** 共享缓冲区的fd，未启用时为-1 */
+    @Volatile
+    var fd: Int = -1
+        private set
+
+    /** 是否正在记录 */
+    val isEnabled: Boolean get() = fd >= 0
+
+    /**
+     * 开始记录，必须在启动JVM之前调用，子进程才能继承缓冲区
+     *
+     * @return 是否成功启用
+     */
+    fun start(slots: Int = DEFAULT_SLOTS): Boolean {
+        if (!isAvailable) return false
+        if (!isEnabled) fd = nativeStart(slots)
+        return isEnabled
+    }
+
+    /** 帧序号对应的流ID，服务端和查看器按同样的顺序为每个帧头计数 */
+    fun frameFlow(frameId: Long): Long = FLOW_FRAME or frameId
+
+    /** 输入序号对应的流ID，服务端按收到的行计数 */
+    fun inputFlow(inputId: Long): Long = FLOW_INPUT or inputId
+
+    /**
+     * 记录一段已完成的耗时
+     *
+     * @param name 事件名称编号
+     * @param startNs System.nanoTime得到的开始时间
+     * @param flow 流ID，0表示不关联
+     */
+    fun slice(name: Int, startNs: Long, flow: Long = 0, arg: Int = 0) {
+        if (isEnabled) nativeRecord(name, PHASE_COMPLETE, startNs, System.nanoTime() - startNs, flow, arg)
+    }
+
+    /** 记录一个瞬时事件 */
+    fun instant(name: Int, flow: Long = 0, arg: Int = 0) {
+        if (isEnabled) nativeRecord(name, PHASE_INSTANT, System.nanoTime(), 0, flow, arg)
+    }
+
+    /**
+     * 同时导出Chrome JSON和Perfetto两种格式
+     *
+     * @param directory 输出目录
+     * @return 成功写出的文件
+     */
+    fun export(directory: File): List<File> {
+        if (!isEnabled) return emptyList()
+        directory.mkdirs()
+        val stamp = SimpleDateFormat("yyyyMMdd-HHmmss", Locale.ROOT).format(Date())
+        return listOf(
+            File(directory, "trace-$stamp.json") to false,
+            File(directory, "trace-$stamp.perfetto-trace") to true
+        ).mapNotNull { (file, perfetto) ->
+            file.takeIf { nativeExport(it.absolutePath, perfetto) >= 0 }
+        }
+    }
+
+    @JvmStatic
+    private external fun nativeStart(slots: Int): Int
+
+    @JvmStatic
+    private external fun nativeRecord(name: Int, phase: Int, tsNs: Long, durNs: Long, flow: Long, arg: Int)
+
+    @JvmStatic
+    private external fun nativeExport(path: String, perfetto: Boolean): Long
+}
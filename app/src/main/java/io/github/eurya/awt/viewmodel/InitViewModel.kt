@@ -76,6 +76,7 @@ class InitViewModel @Inject constructor(
                     val existingLibraries = libraryManager.getExtractedLibraries()
                     _libraries.value = existingLibraries
                     _initState.value = InitState.Success
+                    libraryManager.verifyInBackground()
                 }
             } catch (e: Exception) {
                 _initState.value = InitState.Error("检查运行库失败: ${e.message}")
@@ -86,18 +87,24 @@ class InitViewModel @Inject constructor(
     /**
      * 解压运行库
      *
-     * 从应用程序资源中提取运行库文件到设备存储
-     * 更新运行库列表并在完成后通知初始化状态
+     * 从应用程序资源中提取运行库文件到设备存储；后台预解压任务正在进行时会等待同一次解压完成。
+     * 解压过程中跟随管理器的进度状态更新每个库的进度，完成后通知初始化状态
      */
     private suspend fun extractLibraries() {
+        val progressJob = viewModelScope.launch {
+            libraryManager.extractionProgress.collect { progress ->
+                if (progress.isNotEmpty()) _libraries.value = progress
+            }
+        }
         try {
-            val extractedLibraries = libraryManager.extractLibraries()
-
-            _libraries.value = extractedLibraries
+            _libraries.value = libraryManager.getExpectedLibraries()
+            _libraries.value = libraryManager.extractLibraries()
             _initState.value = InitState.Success
 
         } catch (e: Exception) {
             _initState.value = InitState.Error("解压运行库失败: ${e.message}")
+        } finally {
+            progressJob.cancel()
         }
     }
 
@@ -0,0 +1,72 @@
+plugins {
+    alias(libs.plugins.jetbrains.kotlin.jvm)
+    application
+}
+
+java {
+    toolchain {
+        languageVersion.set(JavaLanguageVersion.of(17))
+    }
+}
+
+kotlin {
+    compilerOptions {
+        jvmTarget = org.jetbrains.kotlin.gradle.dsl.JvmTarget.JVM_17
+    }
+}
+
+/**
+ * 被测进程使用的Cacio jar：argent作为-javaagent，shared和tta合并成cacio-boot.jar后放在-Xbootclasspath/a上，
+ * 与设备上的启动方式一致；只取各模块自身的jar，不带传递依赖
+ */
+fun cacioJars(name: String) = configurations.create(name) {
+    isCanBeConsumed = false
+    isCanBeResolved = true
+    isTransitive = false
+    attributes {
+        attribute(Usage.USAGE_ATTRIBUTE, objects.named(Usage.JAVA_RUNTIME))
+        attribute(LibraryElements.LIBRARY_ELEMENTS_ATTRIBUTE, objects.named(LibraryElements.JAR))
+    }
+}
+
+val agentJar = cacioJars("agentJar")
+val cacioBoot = cacioJars("cacioBoot")
+
+dependencies {
+    implementation(project(":awt-codec"))
+
+    agentJar(project(":cacio-argent"))
+    cacioBoot(project(":cacio-shared"))
+    cacioBoot(project(":cacio-tta"))
+}
+
+/**
+ * 与app的buildRuntime生成的cacio-boot.jar相同：合并shared和tta，条目不压缩存储、按路径排序、固定时间戳
+ */
+val cacioBootJar = tasks.register<Jar>("cacioBootJar") {
+    archiveFileName.set("cacio-boot.jar")
+    destinationDirectory.set(layout.buildDirectory.dir("cacio"))
+    entryCompression = ZipEntryCompression.STORED
+    isPreserveFileTimestamps = false
+    isReproducibleFileOrder = true
+    duplicatesStrategy = DuplicatesStrategy.EXCLUDE
+    from({ cacioBoot.map { zipTree(it) } }) {
+        exclude("META-INF/MANIFEST.MF")
+    }
+}
+
+application {
+    mainClass.set("io.github.eurya.bench.LoopbackBenchmarkKt")
+}
+
+// 用法: ./gradlew :awt-bench:run --args="--scenarios table-scroll,idle --duration 10 --json build/loopback.json"
+tasks.named<JavaExec>("run") {
+    val runtimeClasspath = sourceSets.main.get().runtimeClasspath
+    inputs.files(agentJar, cacioBootJar)
+    workingDir = rootDir
+    doFirst {
+        systemProperty("bench.agentJar", agentJar.singleFile.absolutePath)
+        systemProperty("bench.bootJars", cacioBootJar.get().archiveFile.get().asFile.absolutePath)
+        systemProperty("bench.classpath", runtimeClasspath.asPath)
+    }
+}
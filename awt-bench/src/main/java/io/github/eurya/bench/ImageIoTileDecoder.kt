@@ -0,0 +1,26 @@
+package io.github.eurya.bench
+
+import io.github.eurya.awt.codec.TileImageDecoder
+import java.io.ByteArrayInputStream
+import java.io.IOException
+import javax.imageio.ImageIO
+
+/**
+ * 主机端的JPEG分块解码器
+ *
+ * 功能：
+ * - 用ImageIO解码照片类分块，代替应用中基于BitmapFactory的实现
+ *
+ * @author qz919
+ * @data 2025/10/07
+ */
+class ImageIoTileDecoder : TileImageDecoder {
+
+    override fun decode(data: ByteArray, offset: Int, length: Int, width: Int, height: Int, out: IntArray) {
+        val image = ImageIO.read(ByteArrayInputStream(data, offset, length)) ?: throw IOException("无法解码JPEG块")
+        if (image.width != width || image.height != height) {
+            throw IOException("JPEG块尺寸不匹配: ${image.width}x${image.height}")
+        }
+        image.getRGB(0, 0, width, height, out, 0, width)
+    }
+}
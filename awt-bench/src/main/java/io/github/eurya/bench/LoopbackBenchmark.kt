@@ -0,0 +1,270 @@
+package io.github.eurya.bench
+
+import java.io.File
+import java.net.ServerSocket
+import java.util.Locale
+import java.util.concurrent.TimeUnit
+import kotlin.system.exitProcess
+
+/** 命令行选项 */
+private class Options {
+    var scenarios = StreamWorkload.SCENARIOS
+    var durationSec = 10
+    var warmupSec = 3
+    var width = 1280
+    var height = 720
+    var uiScale = 1f
+    var fps = 60
+    var cacheMb = 16
+    var jpeg = true
+    var deflateLevels = listOf(-1)
+    var viewers = 1
+    var mux = true
+    var textChars = false
+    var jsonPath: String? = null
+    var verbose = false
+}
+
+/** 单个场景的结果，键的顺序即JSON和表格中的顺序 */
+private typealias ScenarioResult = LinkedHashMap<String, Number>
+
+/**
+ * 端到端回环基准测试
+ *
+ * 功能：
+ * - 对每个场景启动一个带Cacio和屏幕流Agent的目标JVM，再用[SyntheticViewer]通过回环连接接收画面
+ * - 预热后在固定时长内同时采集查看器和服务端的数据，输出帧率、带宽、帧间隔、输入延迟和CPU/GC开销
+ * - 结果打印为表格，并可写成JSON供不同提交之间对比
+ *
+ * 用法：./gradlew :awt-bench:run --args="--scenarios table-scroll,idle --duration 10 --json build/loopback.json"
+ *
+ * 分块缓存的带宽收益用navigation场景对比：分别以--cache-mb 16和--cache-mb 0运行，比较mb_per_s；
+ * 照片类分块的有损压缩用image-pan场景对比：分别以默认参数和--lossless运行；
+ * 跨帧deflate的压缩率和CPU开销用--deflate -1,1,6,9对比，关注mb_per_s、deflate_ratio和server_deflate_mean_ms；
+ * 渐进细化的效果看table-scroll场景的tiles_degraded、tiles_refined与latency_p90_ms；
+ * 关键帧传输期间的输入确认延迟用image-pan --lossless分别以默认参数和--no-mux运行，对比input_ack_p99_ms；
+ * 多查看器的扩展性分别以--viewers 1、10、50运行，对比server_threads和server_ctx_switches_per_s，两者不应随查看器数增长；
+ * 文本提交到显示的延迟用text-commit场景对比：分别以默认参数（整段TEXT_COMMIT）和--text-chars（逐字符）运行，比较latency_p50_ms；
+ * 启动开销看startup_main_ms（进入main时JVM的运行时长，包含Agent premain）和startup_first_frame_ms（启动进程到查看器收到第一帧）
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+fun main(args: Array<String>) {
+    val options = parseOptions(args)
+    val results = LinkedHashMap<String, ScenarioResult>()
+
+    for (scenario in options.scenarios) {
+        for (level in options.deflateLevels) {
+            // 多个压缩等级时每个等级单独成一行结果，便于对比压缩率和CPU开销
+            val name = if (level < 0) scenario else "$scenario+deflate$level"
+            println("▶️  场景 $name: ${options.width}x${options.height} @${options.uiScale}x, " +
+                    "目标 ${options.fps} FPS, 预热 ${options.warmupSec}s, 测量 ${options.durationSec}s")
+            val result = try {
+                runScenario(scenario, options, level)
+            } catch (e: Exception) {
+                System.err.println("❌ 场景 $name 失败: ${e.message}")
+                exitProcess(1)
+            }
+            results[name] = result
+            printResult(result)
+        }
+    }
+
+    options.jsonPath?.let { path ->
+        File(path).apply {
+            parentFile?.mkdirs()
+            writeText(toJson(options, results))
+        }
+        println("💾 结果已写入 $path")
+    }
+}
+
+private fun runScenario(scenario: String, options: Options, deflateLevel: Int): ScenarioResult {
+    val port = ServerSocket(0).use { it.localPort }
+    TargetProcess(scenario, options.width, options.height, options.uiScale, port, options.fps, options.verbose)
+        .use { target ->
+            // 被测查看器在目标进程启动后立即开始连接，用于测量启动到第一帧的时间
+            SyntheticViewer(port, options.cacheMb * 1024L * 1024L, options.jpeg, deflateLevel, options.mux).use { viewer ->
+                val (probeX, probeY) = target.probe.get(60, TimeUnit.SECONDS)
+                val startup = Startup(
+                    target.mainUptimeMs.get(30, TimeUnit.SECONDS),
+                    (viewer.firstFrameAtNs - target.launchedAtNs).coerceAtLeast(0)
+                )
+                // 额外的查看器只接收和解码，不参与测量，用于给服务端施加多连接负载
+                val others = List(options.viewers - 1) {
+                    SyntheticViewer(port, options.cacheMb * 1024L * 1024L, options.jpeg, deflateLevel, options.mux)
+                }
+                Thread.sleep(options.warmupSec * 1000L)
+
+                target.beginMeasure()
+                val text = StreamWorkload.TEXT_SAMPLE.takeIf { scenario == "text-commit" }
+                viewer.beginMeasure(probeX, probeY, text = text, perChar = options.textChars)
+                val start = System.nanoTime()
+                Thread.sleep(options.durationSec * 1000L)
+                val report = viewer.endMeasure()
+                val elapsedNs = System.nanoTime() - start
+                target.endMeasure()
+
+                others.forEach { it.close() }
+
+                val server = target.stats.get(30, TimeUnit.SECONDS)
+                return summarize(report, server, elapsedNs, options.viewers, startup)
+            }
+        }
+}
+
+/**
+ * 目标进程的启动耗时
+ *
+ * @property mainUptimeMs 进入main时JVM已运行的毫秒数
+ * @property firstFrameNs 启动进程到查看器收到第一帧像素的耗时，探针就绪前还没有收到时为0
+ */
+private class Startup(val mainUptimeMs: Long, val firstFrameNs: Long)
+
+private fun summarize(
+    report: SyntheticViewer.Report,
+    server: Map<String, Long>,
+    elapsedNs: Long,
+    viewers: Int,
+    startup: Startup
+): ScenarioResult {
+    val seconds = elapsedNs / 1e9
+    val frames = report.frameBytes.size
+    val intervals = Stats.intervals(report.frameArrivalNs)
+    val serverFrames = (server["server_frames"] ?: 0L).coerceAtLeast(1L)
+    val ms = 1e6
+
+    return ScenarioResult().apply {
+        put("viewers", viewers)
+        put("startup_main_ms", startup.mainUptimeMs)
+        put("startup_first_frame_ms", startup.firstFrameNs / ms)
+        put("fps", frames / seconds)
+        put("unchanged_frames", report.unchangedFrames)
+        put("bytes_per_frame_mean", Stats.mean(report.frameBytes))
+        put("bytes_per_frame_p50", Stats.percentile(report.frameBytes, 0.5))
+        put("bytes_per_frame_p95", Stats.percentile(report.frameBytes, 0.95))
+        put("mb_per_s", report.frameBytes.sum() / (1024.0 * 1024.0) / seconds)
+        put("tiles_pixels", report.pixelTiles)
+        put("tiles_cache_hits", report.cacheHits)
+        put("tiles_fill", report.fillTiles)
+        put("tiles_photo", report.photoTiles)
+        put("tiles_palette", report.paletteTiles)
+        put("tiles_degraded", report.degradedTiles)
+        put("tiles_refined", server["server_tiles_refined"] ?: 0L)
+        put("cache_hit_pct", report.cacheHits * 100.0 /
+                (report.pixelTiles + report.paletteTiles + report.cacheHits).coerceAtLeast(1))
+        put("frame_interval_p50_ms", Stats.percentile(intervals, 0.5) / ms)
+        put("frame_interval_p95_ms", Stats.percentile(intervals, 0.95) / ms)
+        put("frame_interval_p99_ms", Stats.percentile(intervals, 0.99) / ms)
+        put("latency_samples", report.latencyNs.size)
+        put("latency_p50_ms", Stats.percentile(report.latencyNs, 0.5) / ms)
+        put("latency_p90_ms", Stats.percentile(report.latencyNs, 0.9) / ms)
+        put("latency_p99_ms", Stats.percentile(report.latencyNs, 0.99) / ms)
+        put("latency_max_ms", Stats.max(report.latencyNs) / ms)
+        put("latency_timeouts", report.probeTimeouts)
+        put("input_ack_samples", report.ackNs.size)
+        put("input_ack_p50_ms", Stats.percentile(report.ackNs, 0.5) / ms)
+        put("input_ack_p99_ms", Stats.percentile(report.ackNs, 0.99) / ms)
+        put("input_ack_max_ms", Stats.max(report.ackNs) / ms)
+        put("viewer_read_p50_ms", Stats.percentile(report.readNs, 0.5) / ms)
+        put("viewer_decode_p50_ms", Stats.percentile(report.decodeNs, 0.5) / ms)
+        put("viewer_decode_p95_ms", Stats.percentile(report.decodeNs, 0.95) / ms)
+        put("viewer_cpu_pct", report.cpuNs * 100.0 / elapsedNs)
+        put("viewer_inflate_mean_ms", report.inflateNs / ms / frames.coerceAtLeast(1))
+        put("server_capture_mean_ms", (server["server_capture_ns"] ?: 0L) / ms / serverFrames)
+        put("server_encode_mean_ms", (server["server_encode_ns"] ?: 0L) / ms / serverFrames)
+        put("server_send_mean_ms", (server["server_send_ns"] ?: 0L) / ms / serverFrames)
+        put("server_deflate_mean_ms", (server["server_deflate_ns"] ?: 0L) / ms / serverFrames)
+        put("deflate_ratio", (server["server_deflate_out"] ?: 0L).toDouble() /
+                (server["server_deflate_in"] ?: 0L).coerceAtLeast(1L))
+        put("server_cpu_pct", (server["cpu_ns"] ?: 0L) * 100.0 / (server["wall_ns"] ?: elapsedNs))
+        put("server_gc_count", server["gc_count"] ?: 0L)
+        put("server_gc_ms", (server["gc_ns"] ?: 0L) / ms)
+        put("server_threads", server["threads"] ?: 0L)
+        put("server_ctx_switches_per_s", (server["ctx_switches"] ?: 0L) / seconds)
+    }
+}
+
+private fun printResult(result: ScenarioResult) {
+    result.forEach { (key, value) ->
+        val text = if (value is Double) String.format(Locale.ROOT, "%.2f", value) else value.toString()
+        println("    %-26s %12s".format(key, text))
+    }
+}
+
+private fun toJson(options: Options, results: Map<String, ScenarioResult>): String = buildString {
+    append("{\n  \"schema\": 1,\n")
+    append("  \"config\": {\"width\": ${options.width}, \"height\": ${options.height}, ")
+    append("\"ui_scale\": ${options.uiScale}, \"fps\": ${options.fps}, \"cache_mb\": ${options.cacheMb}, \"jpeg\": ${options.jpeg}, \"mux\": ${options.mux}, \"text_chars\": ${options.textChars}, ")
+    append("\"warmup_s\": ${options.warmupSec}, \"duration_s\": ${options.durationSec}, ")
+    append("\"java\": \"${System.getProperty("java.version")}\", ")
+    append("\"cores\": ${Runtime.getRuntime().availableProcessors()}},\n")
+    append("  \"scenarios\": {\n")
+    results.entries.forEachIndexed { index, (scenario, result) ->
+        // 每个场景占一行，便于在评审中对比
+        val fields = result.entries.joinToString(", ") { (key, value) ->
+            val number = if (value is Double) String.format(Locale.ROOT, "%.3f", value) else value.toString()
+            "\"$key\": $number"
+        }
+        append("    \"$scenario\": {$fields}")
+        append(if (index + 1 < results.size) ",\n" else "\n")
+    }
+    append("  }\n}\n")
+}
+
+private fun parseOptions(args: Array<String>): Options {
+    val options = Options()
+    var i = 0
+    fun next(): String = args.getOrNull(++i) ?: usage("缺少 ${args[i - 1]} 的值")
+
+    while (i < args.size) {
+        when (val arg = args[i]) {
+            "--scenarios" -> options.scenarios = next().split(',').map { it.trim() }.filter { it.isNotEmpty() }
+                .onEach { if (it !in StreamWorkload.SCENARIOS) usage("未知场景: $it") }
+            "--duration" -> options.durationSec = next().toInt().coerceAtLeast(1)
+            "--warmup" -> options.warmupSec = next().toInt().coerceAtLeast(0)
+            "--size" -> next().split('x').let {
+                options.width = it[0].toInt()
+                options.height = it[1].toInt()
+            }
+            "--scale" -> options.uiScale = next().toFloat()
+            "--fps" -> options.fps = next().toInt().coerceAtLeast(1)
+            "--cache-mb" -> options.cacheMb = next().toInt().coerceAtLeast(0)
+            "--lossless" -> options.jpeg = false
+            "--deflate" -> options.deflateLevels = next().split(',').map { it.trim().toInt().coerceIn(-1, 9) }
+            "--viewers" -> options.viewers = next().toInt().coerceIn(1, 200)
+            "--no-mux" -> options.mux = false
+            "--text-chars" -> options.textChars = true
+            "--json" -> options.jsonPath = next()
+            "--verbose" -> options.verbose = true
+            else -> usage(if (arg == "--help") null else "未知参数: $arg")
+        }
+        i++
+    }
+    return options
+}
+
+private fun usage(error: String?): Nothing {
+    error?.let { System.err.println("❌ $it") }
+    println(
+        """
+        |用法: ./gradlew :awt-bench:run --args="[选项]"
+        |  --scenarios <a,b>   运行的场景，可选 ${StreamWorkload.SCENARIOS.joinToString(",")}
+        |  --duration <秒>     每个场景的测量时长（默认10）
+        |  --warmup <秒>       查看器连接后的预热时长（默认3）
+        |  --size <宽x高>      屏幕尺寸（默认1280x720）
+        |  --scale <比例>      UI缩放（默认1）
+        |  --fps <帧率>        服务端目标帧率（默认60）
+        |  --cache-mb <MB>     查看器的分块缓存预算，0表示不发送HELLO、接收整帧（默认16）
+        |  --lossless          不声明JPEG能力，照片类分块也无损发送
+        |  --deflate <a,b>     依次以这些等级启用跨帧deflate压缩（0-9，-1表示不压缩），每个等级单独报告
+        |  --no-mux            不请求通道复用，输入确认排在整帧之后
+        |  --text-chars        text-commit场景逐字符发送CHAR_INPUT，而不是整段TEXT_COMMIT
+        |  --viewers <数量>    同时连接的查看器数，只测量第一个，其余只接收（默认1）
+        |  --json <路径>       把结果写成JSON
+        |  --verbose           转发目标进程的输出
+        """.trimMargin()
+    )
+    exitProcess(if (error == null) 0 else 1)
+}
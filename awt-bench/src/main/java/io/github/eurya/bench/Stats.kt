@@ -0,0 +1,46 @@
+package io.github.eurya.bench
+
+/**
+ * 可增长的long样本数组，避免测量期间装箱
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+class LongSamples {
+    private var values = LongArray(1024)
+    private var size = 0
+
+    fun add(value: Long) {
+        if (size == values.size) values = values.copyOf(size * 2)
+        values[size++] = value
+    }
+
+    fun toArray(): LongArray = values.copyOf(size)
+}
+
+/**
+ * 样本统计工具
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+object Stats {
+
+    /** 线性插值的百分位数，空样本返回0 */
+    fun percentile(samples: LongArray, p: Double): Double {
+        if (samples.isEmpty()) return 0.0
+        val sorted = samples.sortedArray()
+        val rank = p * (sorted.size - 1)
+        val low = rank.toInt()
+        val high = minOf(low + 1, sorted.size - 1)
+        return sorted[low] + (sorted[high] - sorted[low]) * (rank - low)
+    }
+
+    fun mean(samples: LongArray): Double = if (samples.isEmpty()) 0.0 else samples.average()
+
+    fun max(samples: LongArray): Long = samples.maxOrNull() ?: 0L
+
+    /** 相邻元素的差值，用于由到达时间得到帧间隔 */
+    fun intervals(timestamps: LongArray): LongArray =
+        LongArray(maxOf(0, timestamps.size - 1)) { timestamps[it + 1] - timestamps[it] }
+}
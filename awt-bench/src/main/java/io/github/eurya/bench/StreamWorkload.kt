@@ -0,0 +1,432 @@
+package io.github.eurya.bench
+
+import java.awt.BorderLayout
+import java.awt.Color
+import java.awt.Dimension
+import java.awt.GradientPaint
+import java.awt.Graphics
+import java.awt.Graphics2D
+import java.awt.GridLayout
+import java.awt.RenderingHints
+import java.awt.event.MouseAdapter
+import java.awt.event.MouseEvent
+import java.awt.image.BufferedImage
+import java.io.File
+import java.io.IOException
+import java.lang.management.ManagementFactory
+import java.util.Random
+import javax.swing.JButton
+import javax.swing.JDesktopPane
+import javax.swing.JFrame
+import javax.swing.JInternalFrame
+import javax.swing.JLabel
+import javax.swing.JLayeredPane
+import javax.swing.JList
+import javax.swing.JPanel
+import javax.swing.JScrollPane
+import javax.swing.JTabbedPane
+import javax.swing.JTable
+import javax.swing.JTextArea
+import javax.swing.JTextField
+import javax.swing.JToolBar
+import javax.swing.SwingUtilities
+import javax.swing.Timer
+import javax.swing.event.DocumentEvent
+import javax.swing.event.DocumentListener
+import javax.swing.table.AbstractTableModel
+import kotlin.math.cos
+import kotlin.math.sin
+import kotlin.system.exitProcess
+
+/**
+ * 回环基准测试的被测程序
+ *
+ * 功能：
+ * - 在Cacio + 屏幕流Agent下运行一个全屏Swing窗口，按场景持续产生画面变化
+ * - 顶部的探针条在鼠标按下时切换颜色，供查看器测量输入到像素的延迟；
+ *   text-commit场景中改为文本框收到完整的[TEXT_SAMPLE]时切换，测量文本提交到显示的延迟
+ * - 通过标准输入接收驱动程序的阶段指令，通过标准输出回报探针位置和测量结果
+ *
+ * 标准输出协议（每行一条）：
+ * - BENCH_MAIN ms：进入main时JVM已运行的毫秒数，包含Agent premain的耗时
+ * - BENCH_PROBE x y：探针中心的设备像素坐标，表示界面已就绪
+ * - BENCH_STATS k=v ...：测量区间内的CPU、GC和StreamStats差值
+ *
+ * 标准输入指令：MEASURE开始测量，STOP结束测量并退出
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+object StreamWorkload {
+
+    /** 场景刷新间隔，约60Hz */
+    private const val TICK_MS = 16
+
+    /** 探针条高度（逻辑像素） */
+    private const val PROBE_HEIGHT = 32
+
+    private val PROBE_COLORS = arrayOf(Color(0x20, 0x40, 0x80), Color(0xE0, 0x80, 0x20))
+
+    /** 导航场景每步之间的间隔，接近人工操作的节奏 */
+    private const val NAVIGATION_STEP_MS = 250
+
+    val SCENARIOS = listOf(
+        "table-scroll", "text-typing", "text-commit", "internal-frames", "animation", "navigation", "image-pan", "idle"
+    )
+
+    /** text-commit场景中查看器每次提交的文本，以[TEXT_END]结尾 */
+    const val TEXT_SAMPLE = "敏捷的棕色狐狸跳过了懒狗 The quick brown fox jumps over the lazy dog#"
+
+    /** 文本提交的结束标记，文本框内容以它结尾时表示整段文本已插入 */
+    private const val TEXT_END = '#'
+
+    @JvmStatic
+    fun main(args: Array<String>) {
+        println("BENCH_MAIN ${ManagementFactory.getRuntimeMXBean().uptime}")
+        val scenario = args.firstOrNull() ?: SCENARIOS.first()
+        require(scenario in SCENARIOS) { "未知场景: $scenario，可选: $SCENARIOS" }
+
+        val uiScale = System.getProperty("cacio.managed.uiscale")?.toDoubleOrNull() ?: 1.0
+        SwingUtilities.invokeAndWait { createWindow(scenario, uiScale) }
+
+        var start = Snapshot.take()
+        while (true) {
+            when (readLine()?.trim()) {
+                "MEASURE" -> start = Snapshot.take()
+                "STOP", null -> break
+            }
+        }
+        val end = Snapshot.take()
+        println("BENCH_STATS " + end.minus(start).entries.joinToString(" ") { "${it.key}=${it.value}" })
+        System.out.flush()
+        exitProcess(0)
+    }
+
+    private fun createWindow(scenario: String, uiScale: Double) {
+        val frame = JFrame("Loopback Benchmark - $scenario")
+        frame.isUndecorated = true
+        frame.defaultCloseOperation = JFrame.EXIT_ON_CLOSE
+
+        val probe = JPanel()
+        probe.preferredSize = Dimension(0, PROBE_HEIGHT)
+        probe.background = PROBE_COLORS[0]
+        var state = 0
+        val toggleProbe = {
+            state = state xor 1
+            probe.background = PROBE_COLORS[state]
+            probe.repaint()
+        }
+        probe.addMouseListener(object : MouseAdapter() {
+            override fun mousePressed(e: MouseEvent) = toggleProbe()
+        })
+
+        frame.contentPane.add(probe, BorderLayout.NORTH)
+        frame.contentPane.add(createScenario(scenario, toggleProbe), BorderLayout.CENTER)
+        frame.bounds = frame.graphicsConfiguration.bounds
+        frame.isVisible = true
+        frame.validate()
+
+        val origin = probe.locationOnScreen
+        val x = ((origin.x + probe.width / 2) * uiScale).toInt()
+        val y = ((origin.y + probe.height / 2) * uiScale).toInt()
+        println("BENCH_PROBE $x $y")
+        System.out.flush()
+    }
+
+    private fun createScenario(scenario: String, toggleProbe: () -> Unit): JPanel = when (scenario) {
+        "table-scroll" -> tableScroll()
+        "text-typing" -> textTyping()
+        "text-commit" -> textCommit(toggleProbe)
+        "internal-frames" -> internalFrames()
+        "animation" -> animation()
+        "navigation" -> navigation()
+        "image-pan" -> imagePan()
+        else -> idle()
+    }
+
+    /** 大表格匀速滚动：整屏文本内容按行平移，典型的滚动重绘 */
+    private fun tableScroll(): JPanel {
+        val model = object : AbstractTableModel() {
+            override fun getRowCount() = 5000
+            override fun getColumnCount() = 6
+            override fun getColumnName(column: Int) = "列 $column"
+            override fun getValueAt(row: Int, column: Int): Any = "R$row C$column ${(row * 31 + column) % 997}"
+        }
+        val table = JTable(model)
+        val scroll = JScrollPane(table)
+        val panel = JPanel(BorderLayout()).apply { add(scroll) }
+
+        Timer(TICK_MS) {
+            val bar = scroll.verticalScrollBar
+            val next = bar.value + table.rowHeight
+            bar.value = if (next + bar.visibleAmount >= bar.maximum) 0 else next
+        }.start()
+        return panel
+    }
+
+    /** 逐字输入：每帧只有光标附近的一小块区域变化 */
+    private fun textTyping(): JPanel {
+        val text = "The quick brown fox jumps over the lazy dog. 敏捷的棕色狐狸跳过了懒狗。 "
+        val area = JTextArea()
+        var index = 0
+        Timer(TICK_MS) {
+            area.append(text[index % text.length].toString())
+            index++
+            if (index % 80 == 0) area.append("\n")
+            if (area.lineCount > 40) area.text = ""
+        }.start()
+        return JPanel(BorderLayout()).apply { add(JScrollPane(area)) }
+    }
+
+    /**
+     * 文本提交：查看器反复向获得焦点的文本框提交[TEXT_SAMPLE]
+     *
+     * 文本框内容以[TEXT_END]结尾时切换探针颜色并清空，查看器据此测量从发送到整段文本显示的延迟，
+     * 对比TEXT_COMMIT一次插入与逐字符CHAR_INPUT
+     */
+    private fun textCommit(toggleProbe: () -> Unit): JPanel {
+        val field = JTextField()
+        field.font = field.font.deriveFont(24f)
+        field.document.addDocumentListener(object : DocumentListener {
+            override fun insertUpdate(e: DocumentEvent) {
+                if (!field.text.endsWith(TEXT_END)) return
+                // 不能在通知中修改文档
+                SwingUtilities.invokeLater {
+                    toggleProbe()
+                    field.text = ""
+                }
+            }
+
+            override fun removeUpdate(e: DocumentEvent) {}
+
+            override fun changedUpdate(e: DocumentEvent) {}
+        })
+        // 窗口显示后再请求焦点
+        SwingUtilities.invokeLater { field.requestFocusInWindow() }
+        return JPanel(BorderLayout()).apply { add(field, BorderLayout.NORTH) }
+    }
+
+    /** 拖动内部窗口：中等面积的矩形移动，同时露出下层窗口 */
+    private fun internalFrames(): JPanel {
+        val desktop = JDesktopPane()
+        val frames = (0 until 4).map { i ->
+            JInternalFrame("窗口 $i", true, true, true, true).apply {
+                contentPane.add(JScrollPane(JTextArea("内部窗口 $i\n".repeat(20))))
+                setBounds(40 + i * 60, 40 + i * 40, 360, 240)
+                isVisible = true
+                desktop.add(this)
+            }
+        }
+        var tick = 0
+        Timer(TICK_MS) {
+            tick++
+            val moving = frames[(tick / 120) % frames.size]
+            val t = tick / 30.0
+            val x = (desktop.width - moving.width) / 2 * (1 + sin(t))
+            val y = (desktop.height - moving.height) / 2 * (1 + cos(t * 0.7))
+            moving.setLocation(x.toInt(), y.toInt())
+        }.start()
+        return JPanel(BorderLayout()).apply { add(desktop) }
+    }
+
+    /** 全屏动画：每帧整屏变化，代表视频或游戏类内容的最坏情况 */
+    private fun animation(): JPanel {
+        var phase = 0.0
+        val canvas = object : JPanel() {
+            override fun paintComponent(g: Graphics) {
+                val g2 = g as Graphics2D
+                g2.setRenderingHint(RenderingHints.KEY_ANTIALIASING, RenderingHints.VALUE_ANTIALIAS_ON)
+                g2.paint = GradientPaint(0f, 0f, Color(0x10, 0x20, (128 + 127 * sin(phase)).toInt()),
+                    width.toFloat(), height.toFloat(), Color((128 + 127 * cos(phase)).toInt(), 0x30, 0x40))
+                g2.fillRect(0, 0, width, height)
+                for (i in 0 until 24) {
+                    val angle = phase + i * Math.PI / 12
+                    val x = width / 2 + (width / 3 * cos(angle * 1.3)).toInt()
+                    val y = height / 2 + (height / 3 * sin(angle)).toInt()
+                    g2.color = Color.getHSBColor((i / 24f + phase.toFloat() / 10) % 1f, 0.8f, 0.9f)
+                    g2.fillOval(x - 20, y - 20, 40, 40)
+                }
+            }
+        }
+        Timer(TICK_MS) {
+            phase += 0.05
+            canvas.repaint()
+        }.start()
+        return canvas
+    }
+
+    /**
+     * 录制的导航流程：切换标签页、反复打开同一个对话框、列表向下翻页再翻回
+     *
+     * 步骤固定且循环执行，每轮画面都会回到之前出现过的状态，用于衡量分块缓存节省的带宽
+     */
+    private fun navigation(): JPanel {
+        val toolbar = JToolBar().apply {
+            isFloatable = false
+            repeat(10) { add(JButton("工具 $it")) }
+        }
+        val list = JList(Array(2000) { "列表项 $it - 数量 ${(it * 37) % 101}" })
+        val listScroll = JScrollPane(list)
+        val form = JPanel(GridLayout(12, 2, 8, 8)).apply {
+            repeat(12) {
+                add(JLabel("字段 $it"))
+                add(JTextField("值 $it"))
+            }
+        }
+        val tabs = JTabbedPane().apply {
+            addTab("列表", listScroll)
+            addTab("表单", form)
+            addTab("说明", JScrollPane(JTextArea("这是一段说明文字，用于填充标签页。\n".repeat(60))))
+        }
+        val dialog = JInternalFrame("属性", false, true).apply {
+            contentPane.add(JPanel(GridLayout(4, 2, 8, 8)).apply {
+                repeat(3) {
+                    add(JLabel("属性 $it"))
+                    add(JTextField("默认值 $it"))
+                }
+                add(JButton("确定"))
+                add(JButton("取消"))
+            })
+            setSize(420, 220)
+        }
+        val panel = JPanel(BorderLayout()).apply {
+            add(toolbar, BorderLayout.NORTH)
+            add(tabs, BorderLayout.CENTER)
+        }
+
+        fun scrollPages(pages: Int) {
+            val bar = listScroll.verticalScrollBar
+            bar.value += pages * bar.visibleAmount
+        }
+
+        fun showDialog(visible: Boolean) {
+            val layers = panel.rootPane?.layeredPane ?: return
+            if (dialog.parent == null) layers.add(dialog, JLayeredPane.MODAL_LAYER)
+            dialog.setLocation((layers.width - dialog.width) / 2, (layers.height - dialog.height) / 2)
+            dialog.isVisible = visible
+        }
+
+        val steps = listOf(
+            { tabs.selectedIndex = 1 },
+            { tabs.selectedIndex = 2 },
+            { showDialog(true) },
+            { showDialog(false) },
+            { tabs.selectedIndex = 0 },
+            { scrollPages(1) },
+            { scrollPages(1) },
+            { scrollPages(1) },
+            { scrollPages(-1) },
+            { scrollPages(-1) },
+            { scrollPages(-1) },
+            { showDialog(true) },
+            { showDialog(false) },
+        )
+        var step = 0
+        Timer(NAVIGATION_STEP_MS) { steps[step++ % steps.size]() }.start()
+        return panel
+    }
+
+    /**
+     * 图片平移：左侧是缓慢平移的照片类图像（平滑渐变叠加细噪声，类似地图底图或照片），右侧是文字说明
+     *
+     * 用于衡量区域分类后的混合编码：图像区域走有损压缩，文字区域保持无损
+     */
+    private fun imagePan(): JPanel {
+        val size = 2048
+        val random = Random(42)
+        val image = BufferedImage(size, size, BufferedImage.TYPE_INT_RGB)
+        for (y in 0 until size) {
+            for (x in 0 until size) {
+                val r = 128 + 100 * sin(x / 97.0) * cos(y / 131.0)
+                val g = 128 + 90 * sin((x + y) / 173.0)
+                val b = 128 + 80 * cos(x / 59.0 - y / 83.0)
+                val noise = random.nextInt(17) - 8
+                image.setRGB(x, y, Color(
+                    (r + noise).toInt().coerceIn(0, 255),
+                    (g + noise).toInt().coerceIn(0, 255),
+                    (b + noise).toInt().coerceIn(0, 255)
+                ).rgb)
+            }
+        }
+
+        var offset = 0
+        val canvas = object : JPanel() {
+            override fun paintComponent(g: Graphics) {
+                val x = offset % (size - width).coerceAtLeast(1)
+                val y = offset / 2 % (size - height).coerceAtLeast(1)
+                g.drawImage(image, -x, -y, null)
+            }
+        }
+        val caption = JTextArea("图片说明：左侧为平移中的照片类内容，这段文字应当保持像素级清晰。\n".repeat(30)).apply {
+            lineWrap = true
+            isEditable = false
+        }
+        Timer(TICK_MS) {
+            offset += 2
+            canvas.repaint()
+        }.start()
+        return JPanel(GridLayout(1, 2)).apply {
+            add(canvas)
+            add(JScrollPane(caption))
+        }
+    }
+
+    /** 静止画面：衡量没有变化时的空转开销 */
+    private fun idle(): JPanel = JPanel(GridLayout(8, 4, 8, 8)).apply {
+        repeat(32) { add(JLabel("静态标签 $it")) }
+    }
+
+    /**
+     * 进程级计数器快照
+     *
+     * StreamStats由Agent加载到系统类加载器中，这里通过反射读取，
+     * 不可用时（例如Agent未加载）只输出进程自身的计数。threads是结束时的线程数，不做差值
+     */
+    private class Snapshot(private val values: Map<String, Long>) {
+
+        fun minus(start: Snapshot): Map<String, Long> =
+            values.mapValues { (key, value) -> if (key == "threads") value else value - (start.values[key] ?: 0L) }
+
+        companion object {
+            fun take(): Snapshot {
+                val values = LinkedHashMap<String, Long>()
+                values["wall_ns"] = System.nanoTime()
+                values["cpu_ns"] = processCpuNanos()
+                val gcs = ManagementFactory.getGarbageCollectorMXBeans()
+                values["gc_count"] = gcs.sumOf { it.collectionCount.coerceAtLeast(0) }
+                values["gc_ns"] = gcs.sumOf { it.collectionTime.coerceAtLeast(0) } * 1_000_000
+                values["threads"] = ManagementFactory.getThreadMXBean().threadCount.toLong()
+                values["ctx_switches"] = contextSwitches()
+                streamStats()?.forEach { (key, value) -> values["server_$key"] = value }
+                return Snapshot(values)
+            }
+
+            private fun processCpuNanos(): Long {
+                val os = ManagementFactory.getOperatingSystemMXBean()
+                return (os as? com.sun.management.OperatingSystemMXBean)?.processCpuTime ?: -1L
+            }
+
+            /** 所有线程的自愿和非自愿上下文切换次数之和，非Linux系统返回0 */
+            private fun contextSwitches(): Long =
+                File("/proc/self/task").listFiles().orEmpty().sumOf { task ->
+                    try {
+                        File(task, "status").readLines()
+                            .filter { it.startsWith("voluntary_ctxt_switches") || it.startsWith("nonvoluntary_ctxt_switches") }
+                            .sumOf { it.substringAfter(':').trim().toLong() }
+                    } catch (_: IOException) {
+                        0L // 线程已退出
+                    }
+                }
+
+            @Suppress("UNCHECKED_CAST")
+            private fun streamStats(): Map<String, Long>? = try {
+                ClassLoader.getSystemClassLoader()
+                    .loadClass("io.github.eurya.cacio.StreamStats")
+                    .getMethod("snapshot")
+                    .invoke(null) as Map<String, Long>
+            } catch (_: ReflectiveOperationException) {
+                null
+            }
+        }
+    }
+}
@@ -0,0 +1,309 @@
+package io.github.eurya.bench
+
+import io.github.eurya.awt.codec.FrameDecoder
+import io.github.eurya.awt.codec.FrameStreamReader
+import io.github.eurya.awt.codec.InputMessages
+import io.github.eurya.awt.codec.TileFrameDecoder
+import java.io.BufferedInputStream
+import java.io.DataInputStream
+import java.io.IOException
+import java.io.PrintWriter
+import java.lang.management.ManagementFactory
+import java.net.InetSocketAddress
+import java.net.Socket
+import java.util.concurrent.ConcurrentHashMap
+import java.util.concurrent.atomic.AtomicLong
+
+/**
+ * 合成查看器
+ *
+ * 功能：
+ * - 按应用中AwtViewModel的方式连接屏幕流服务器，读取并解码每一帧，但不做任何显示
+ * - 记录每帧的到达时间、数据量、读取和解码耗时，以及查看器线程的CPU时间
+ * - 周期性在探针位置发送鼠标点击，测量从发送输入到画面中探针像素变化的延迟；
+ *   指定文本时改为提交文本（整段TEXT_COMMIT或逐字符CHAR_INPUT），测量文本显示的延迟
+ *
+ * - cacheBytes大于0或请求deflate时发送HELLO启用分块编码，jpeg和deflateLevel对应HELLO中的可选能力，与应用的行为一致
+ * - 发送HELLO时同时请求输入确认，记录每条输入消息从发送到收到确认的往返时间；mux决定确认是否走复用的输入通道
+ *
+ * 同一时刻只有一个探针在途，超时未观察到变化的探针计入[Report.probeTimeouts]
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+class SyntheticViewer(
+    private val port: Int,
+    private val cacheBytes: Long = 0,
+    private val jpeg: Boolean = false,
+    private val deflateLevel: Int = -1,
+    private val mux: Boolean = true
+) : AutoCloseable {
+
+    /**
+     * 测量区间内的原始样本
+     *
+     * @property frameArrivalNs 每帧读取完成的时间点（纳秒）
+     * @property frameBytes 每帧的数据量
+     * @property readNs 每帧阻塞读取耗时
+     * @property decodeNs 每帧解码耗时
+     * @property latencyNs 每个探针的输入到像素延迟
+     * @property ackNs 每条输入消息从发送到收到服务端确认的往返时间
+     * @property probeTimeouts 超时未观察到变化的探针数
+     * @property unchangedFrames 服务端标记为未变化的帧数
+     * @property pixelTiles 分块帧中以像素接收的块数
+     * @property cacheHits 分块帧中命中缓存的块数
+     * @property fillTiles 分块帧中以纯色或渐变命令接收的块数
+     * @property photoTiles 分块帧中以JPEG接收的块数
+     * @property paletteTiles 分块帧中以调色板接收的块数
+     * @property degradedTiles 分块帧中以RGB565降级接收的块数
+     * @property inflateNs 解压压缩帧的累计耗时
+     * @property cpuNs 查看器接收线程消耗的CPU时间
+     */
+    class Report(
+        val frameArrivalNs: LongArray,
+        val frameBytes: LongArray,
+        val readNs: LongArray,
+        val decodeNs: LongArray,
+        val latencyNs: LongArray,
+        val ackNs: LongArray,
+        val probeTimeouts: Int,
+        val unchangedFrames: Int,
+        val pixelTiles: Long,
+        val cacheHits: Long,
+        val fillTiles: Long,
+        val photoTiles: Long,
+        val paletteTiles: Long,
+        val degradedTiles: Long,
+        val inflateNs: Long,
+        val cpuNs: Long
+    )
+
+    private val socket = connect()
+    private val reader = FrameStreamReader(DataInputStream(BufferedInputStream(socket.getInputStream(), 1 shl 16)))
+    private val input = PrintWriter(socket.getOutputStream(), true)
+    private val info = reader.readScreenInfo()
+    private val pixels = IntArray(info.width * info.height)
+    private val tileDecoder = if (cacheBytes > 0 || deflateLevel >= 0) {
+        TileFrameDecoder(info.width, info.height, cacheBytes, if (jpeg) ImageIoTileDecoder() else null)
+    } else {
+        null
+    }
+
+    @Volatile
+    private var measuring = false
+
+    @Volatile
+    private var running = true
+
+    private val frameArrivalNs = LongSamples()
+    private val frameBytes = LongSamples()
+    private val readNs = LongSamples()
+    private val decodeNs = LongSamples()
+    private val latencyNs = LongSamples()
+    private val ackNs = LongSamples()
+    private var probeTimeouts = 0
+    private var unchangedFrames = 0
+    private var pixelTiles = 0L
+    private var cacheHits = 0L
+    private var fillTiles = 0L
+    private var photoTiles = 0L
+    private var paletteTiles = 0L
+    private var degradedTiles = 0L
+    private var inflateStartNs = 0L
+    private var cpuStartNs = 0L
+    private var cpuEndNs = 0L
+
+    /** 在途探针的发送时间，0表示没有在途探针 */
+    private val probeSentAt = AtomicLong(0)
+
+    /** 探针发出前探针位置的像素值 */
+    @Volatile
+    private var probeBaseline = 0
+
+    private var probeIndex = -1
+    private val lock = Object()
+
+    /** 已发送的输入行数，即下一行的输入序号，与服务端的计数一致 */
+    private var inputSeq = 0L
+
+    /** 尚未确认的输入消息的发送时间，键为输入序号 */
+    private val inputSentAt = ConcurrentHashMap<Long, Long>()
+
+    init {
+        reader.onInputAck = { seq ->
+            val sentAt = inputSentAt.remove(seq)
+            if (sentAt != null) {
+                val rtt = System.nanoTime() - sentAt
+                synchronized(lock) { if (measuring) ackNs.add(rtt) }
+            }
+        }
+        if (tileDecoder != null) {
+            send(InputMessages.hello(cacheBytes, tileDecoder.supportsJpeg, deflateLevel, ack = true, mux = mux))
+        }
+    }
+
+    private val receiver = Thread({ receiveLoop() }, "Viewer-Receiver").apply { start() }
+
+    /** 收到第一帧像素的时间点（纳秒），尚未收到时为0 */
+    @Volatile
+    var firstFrameAtNs = 0L
+        private set
+
+    /** 握手得到的屏幕信息 */
+    val screenInfo: FrameStreamReader.ScreenInfo get() = info
+
+    /**
+     * 开始测量，同时启动探针线程
+     *
+     * @param probeX 探针的设备像素横坐标
+     * @param probeY 探针的设备像素纵坐标
+     * @param intervalMs 两次探针之间的最小间隔
+     * @param text 不为null时每个探针提交这段文本而不是点击，见[StreamWorkload.TEXT_SAMPLE]
+     * @param perChar 文本逐字符以CHAR_INPUT发送，而不是一条TEXT_COMMIT
+     */
+    fun beginMeasure(probeX: Int, probeY: Int, intervalMs: Long = 250, text: String? = null, perChar: Boolean = false) {
+        probeIndex = probeY * info.width + probeX
+        require(probeIndex in pixels.indices) { "探针位置超出屏幕: ($probeX, $probeY)" }
+        synchronized(lock) {
+            cpuStartNs = -1
+            inflateStartNs = reader.inflateNanos
+            measuring = true
+        }
+        Thread({ probeLoop(probeX, probeY, intervalMs, text, perChar) }, "Viewer-Probe").apply {
+            isDaemon = true
+            start()
+        }
+    }
+
+    /** 结束测量并返回样本 */
+    fun endMeasure(): Report = synchronized(lock) {
+        measuring = false
+        Report(
+            frameArrivalNs.toArray(), frameBytes.toArray(), readNs.toArray(), decodeNs.toArray(),
+            latencyNs.toArray(), ackNs.toArray(), probeTimeouts, unchangedFrames, pixelTiles, cacheHits, fillTiles, photoTiles,
+            paletteTiles, degradedTiles, reader.inflateNanos - inflateStartNs,
+            if (cpuStartNs < 0) 0 else cpuEndNs - cpuStartNs
+        )
+    }
+
+    private fun receiveLoop() {
+        val threadMx = ManagementFactory.getThreadMXBean()
+        try {
+            while (running) {
+                val readStart = System.nanoTime()
+                val frame = reader.readFrame()
+                val arrival = System.nanoTime()
+
+                var decode = 0L
+                if (frame.hasPixels) {
+                    if (frame.isTiled) {
+                        val decoder = tileDecoder ?: throw IOException("未声明分块缓存却收到分块帧")
+                        decoder.decode(frame.data, frame.length, pixels)
+                    } else {
+                        val format = frame.format ?: throw IOException("未知的像素格式: ${frame.formatName}")
+                        FrameDecoder.decode(frame.data, format, pixels)
+                    }
+                    decode = System.nanoTime() - arrival
+                    if (firstFrameAtNs == 0L) firstFrameAtNs = arrival
+                    checkProbe(arrival)
+                }
+
+                synchronized(lock) {
+                    if (!measuring) return@synchronized
+                    if (cpuStartNs < 0) cpuStartNs = threadMx.currentThreadCpuTime
+                    if (frame.length == -1) unchangedFrames++
+                    if (frame.length < 0) return@synchronized
+                    if (frame.isTiled && frame.hasPixels && tileDecoder != null) {
+                        pixelTiles += tileDecoder.pixelTiles
+                        cacheHits += tileDecoder.cacheHits
+                        fillTiles += tileDecoder.fillTiles
+                        photoTiles += tileDecoder.photoTiles
+                        paletteTiles += tileDecoder.paletteTiles
+                        degradedTiles += tileDecoder.degradedTiles
+                    }
+                    frameArrivalNs.add(arrival)
+                    frameBytes.add(frame.wireLength.toLong())
+                    readNs.add(arrival - readStart)
+                    decodeNs.add(decode)
+                    cpuEndNs = threadMx.currentThreadCpuTime
+                }
+            }
+        } catch (e: IOException) {
+            if (running) System.err.println("❌ 查看器接收失败: ${e.message}")
+        }
+    }
+
+    /** 探针像素与发送前不同即视为该输入已反映到画面上 */
+    private fun checkProbe(arrival: Long) {
+        val sentAt = probeSentAt.get()
+        if (sentAt == 0L || pixels[probeIndex] == probeBaseline) return
+        if (probeSentAt.compareAndSet(sentAt, 0)) {
+            synchronized(lock) { if (measuring) latencyNs.add(arrival - sentAt) }
+        }
+    }
+
+    private fun probeLoop(x: Int, y: Int, intervalMs: Long, text: String?, perChar: Boolean) {
+        send(InputMessages.mouseMove(x, y))
+        while (running && measuring) {
+            Thread.sleep(intervalMs)
+            probeBaseline = pixels[probeIndex]
+            val sentAt = System.nanoTime()
+            probeSentAt.set(sentAt)
+            when {
+                text == null -> {
+                    send(InputMessages.mousePress(1))
+                    send(InputMessages.mouseRelease(1))
+                }
+
+                perChar -> text.forEach { send(InputMessages.charInput(it)) }
+                else -> send(InputMessages.textCommit(text))
+            }
+
+            val deadline = sentAt + PROBE_TIMEOUT_NS
+            while (probeSentAt.get() == sentAt && System.nanoTime() < deadline && running) {
+                Thread.sleep(1)
+            }
+            if (probeSentAt.compareAndSet(sentAt, 0)) {
+                synchronized(lock) { if (measuring) probeTimeouts++ }
+            }
+        }
+    }
+
+    /** 发送一行输入消息并记录发送时间，序号分配与写出在同一把锁内，保证与服务端的计数顺序一致 */
+    private fun send(line: String) = synchronized(input) {
+        inputSentAt[inputSeq++] = System.nanoTime()
+        input.println(line)
+    }
+
+    private fun connect(): Socket {
+        val deadline = System.currentTimeMillis() + CONNECT_TIMEOUT_MS
+        while (true) {
+            try {
+                return Socket().apply {
+                    tcpNoDelay = true
+                    connect(InetSocketAddress("127.0.0.1", port), 1000)
+                }
+            } catch (e: IOException) {
+                if (System.currentTimeMillis() > deadline) {
+                    throw IOException("连接屏幕流服务器超时: ${e.message}", e)
+                }
+                Thread.sleep(100)
+            }
+        }
+    }
+
+    override fun close() {
+        running = false
+        try {
+            socket.close()
+        } catch (_: IOException) {
+        }
+        receiver.join(2000)
+        reader.close()
+    }
+
+    private companion object {
+        const val CONNECT_TIMEOUT_MS = 30_000L
+        const val PROBE_TIMEOUT_NS = 1_000_000_000L
+    }
+}
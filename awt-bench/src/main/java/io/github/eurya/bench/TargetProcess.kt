@@ -0,0 +1,113 @@
+package io.github.eurya.bench
+
+import io.github.eurya.awt.codec.JvmLaunchFlags
+import java.io.BufferedReader
+import java.io.File
+import java.io.IOException
+import java.io.InputStreamReader
+import java.io.PrintWriter
+import java.util.concurrent.CompletableFuture
+import java.util.concurrent.TimeUnit
+
+/**
+ * 被测JVM进程
+ *
+ * 功能：
+ * - 以与设备上相同的方式启动目标JVM：合并后的cacio-boot.jar在-Xbootclasspath/a上，argent作为-javaagent
+ * - 转发并解析目标进程的标准输出，提取[StreamWorkload]输出的main进入时间、探针位置和统计结果
+ * - 通过标准输入控制测量区间
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+class TargetProcess(
+    scenario: String,
+    width: Int,
+    height: Int,
+    uiScale: Float,
+    port: Int,
+    fps: Int,
+    private val verbose: Boolean
+) : AutoCloseable {
+
+    /** 进入main时JVM已运行的毫秒数 */
+    val mainUptimeMs = CompletableFuture<Long>()
+
+    /** 启动目标进程的时间点（纳秒） */
+    val launchedAtNs: Long
+
+    /** 探针中心的设备像素坐标 */
+    val probe = CompletableFuture<Pair<Int, Int>>()
+
+    /** 测量区间内的统计差值 */
+    val stats = CompletableFuture<Map<String, Long>>()
+
+    private val process: Process
+    private val control: PrintWriter
+
+    init {
+        val command = mutableListOf(File(System.getProperty("java.home"), "bin/java").path)
+        command += JvmLaunchFlags.systemProperties(width, height, uiScale)
+        command += JvmLaunchFlags.MODULE_EXPORTS
+        command += "-Xbootclasspath/a:" + requiredProperty("bench.bootJars")
+        // 开启Cacio类加载探针，统计合并引导jar后的类加载开销
+        command += "-javaagent:" + requiredProperty("bench.agentJar") + "=port=$port,fps=$fps,classprobe=true"
+        command += listOf("-cp", requiredProperty("bench.classpath"))
+        command += listOf(StreamWorkload::class.java.name, scenario)
+
+        launchedAtNs = System.nanoTime()
+        process = ProcessBuilder(command).redirectErrorStream(true).start()
+        control = PrintWriter(process.outputStream, true)
+
+        Thread({ pumpOutput() }, "Target-Output").apply {
+            isDaemon = true
+            start()
+        }
+    }
+
+    /** 开始测量区间 */
+    fun beginMeasure() = control.println("MEASURE")
+
+    /** 结束测量区间，目标进程输出统计后退出 */
+    fun endMeasure() = control.println("STOP")
+
+    private fun pumpOutput() {
+        try {
+            BufferedReader(InputStreamReader(process.inputStream)).useLines { lines ->
+                lines.forEach { line ->
+                    when {
+                        line.startsWith("BENCH_MAIN ") -> mainUptimeMs.complete(line.removePrefix("BENCH_MAIN ").trim().toLong())
+
+                        line.startsWith("BENCH_PROBE ") -> {
+                            val parts = line.split(' ')
+                            probe.complete(parts[1].toInt() to parts[2].toInt())
+                        }
+
+                        line.startsWith("BENCH_STATS ") -> stats.complete(
+                            line.removePrefix("BENCH_STATS ").split(' ').filter { it.isNotEmpty() }
+                                .associate { it.substringBefore('=') to it.substringAfter('=').toLong() }
+                        )
+
+                        verbose -> println("  [target] $line")
+                    }
+                }
+            }
+        } catch (_: IOException) {
+        }
+        val error = IOException("目标进程已退出")
+        mainUptimeMs.completeExceptionally(error)
+        probe.completeExceptionally(error)
+        stats.completeExceptionally(error)
+    }
+
+    override fun close() {
+        if (process.waitFor(5, TimeUnit.SECONDS)) return
+        process.destroy()
+        if (!process.waitFor(5, TimeUnit.SECONDS)) process.destroyForcibly()
+    }
+
+    private companion object {
+        fun requiredProperty(name: String): String = System.getProperty(name)
+            ?: throw IllegalStateException("缺少系统属性 $name，请通过 ./gradlew :awt-bench:run 运行")
+    }
+}
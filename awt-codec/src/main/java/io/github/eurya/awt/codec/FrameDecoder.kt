@@ -0,0 +1,74 @@
+package io.github.eurya.awt.codec
+
+/**
+ * 帧像素解码器
+ *
+ * 功能：
+ * - 把服务端发送的各种像素格式还原为ARGB_8888整型像素，供Android Bitmap或主机端查看器使用
+ * - 不依赖Android API，应用和基准测试中的查看器共用同一份解码逻辑
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+object FrameDecoder {
+
+    private const val OPAQUE = 0xFF000000.toInt()
+
+    /**
+     * 解码一帧像素数据
+     *
+     * @param data 帧数据
+     * @param format 像素格式
+     * @param pixels 输出的ARGB像素，长度即为像素数
+     * @throws IllegalArgumentException 当数据长度不足以填满pixels时抛出
+     */
+    @JvmStatic
+    fun decode(data: ByteArray, format: PixelFormat, pixels: IntArray) {
+        require(data.size >= pixels.size * format.bytesPerPixel) {
+            "帧数据长度不足: ${data.size} < ${pixels.size * format.bytesPerPixel}"
+        }
+        when (format) {
+            PixelFormat.ARGB -> {
+                for (i in pixels.indices) {
+                    val offset = i * 4
+                    val a = (data[offset].toInt() and 0xFF) shl 24       // Alpha通道
+                    val r = (data[offset + 1].toInt() and 0xFF) shl 16   // Red通道
+                    val g = (data[offset + 2].toInt() and 0xFF) shl 8    // Green通道
+                    val b = (data[offset + 3].toInt() and 0xFF)          // Blue通道
+                    pixels[i] = a or r or g or b
+                }
+            }
+
+            PixelFormat.RGB -> {
+                for (i in pixels.indices) {
+                    val offset = i * 3
+                    val r = (data[offset].toInt() and 0xFF) shl 16       // Red通道
+                    val g = (data[offset + 1].toInt() and 0xFF) shl 8    // Green通道
+                    val b = (data[offset + 2].toInt() and 0xFF)          // Blue通道
+                    pixels[i] = OPAQUE or r or g or b                    // 固定Alpha为255
+                }
+            }
+
+            PixelFormat.RGB565 -> {
+                for (i in pixels.indices) {
+                    val offset = i * 2
+                    val rgb565 =
+                        ((data[offset].toInt() and 0xFF) shl 8) or (data[offset + 1].toInt() and 0xFF)
+
+                    val r = ((rgb565 shr 11) and 0x1F) * 255 / 31
+                    val g = ((rgb565 shr 5) and 0x3F) * 255 / 63
+                    val b = (rgb565 and 0x1F) * 255 / 31
+
+                    pixels[i] = OPAQUE or (r shl 16) or (g shl 8) or b
+                }
+            }
+
+            PixelFormat.GRAYSCALE -> {
+                for (i in pixels.indices) {
+                    val gray = data[i].toInt() and 0xFF
+                    pixels[i] = OPAQUE or (gray shl 16) or (gray shl 8) or gray
+                }
+            }
+        }
+    }
+}
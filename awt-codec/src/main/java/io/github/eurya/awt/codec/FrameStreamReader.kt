@@ -0,0 +1,181 @@
+package io.github.eurya.awt.codec
+
+import java.io.DataInputStream
+import java.io.IOException
+import java.util.zip.DataFormatException
+import java.util.zip.Inflater
+
+/**
+ * 屏幕流读取器
+ *
+ * 功能：
+ * - 解析服务端的握手信息和帧序列，对应ScreenCaptureTask的发送格式
+ * - 帧数据读入可复用的缓冲区，避免每帧分配
+ * - 压缩帧用连接内唯一的Inflater解压，LZ77窗口跨帧保留，与服务端的FrameDeflater对应
+ * - 处理输入确认、通道复用切换和会话消息，这些消息不作为帧返回
+ *
+ * 握手：宽度int、高度int、是否真实数据boolean、UI缩放float；
+ * 帧：格式名UTF、长度int、数据，长度0表示空帧，-1表示画面未变化；
+ * 查看器发送HELLO后格式名变为[TileFrameDecoder.FORMAT]，数据只包含变化的块；
+ * HELLO中请求deflate时格式名带"Z:"前缀，长度之后多一个解压后长度int，数据来自整个连接共用的deflate流；
+ * HELLO中请求ack时每条输入消息会收到确认：未复用时为格式名"ACK"、长度8、输入序号long的消息；
+ * 请求mux时服务端先发送格式名"MUX"、长度0的切换消息，之后的数据由[MultiplexedInputStream]解复用，确认走输入通道；
+ * 请求resume时服务端在第一个分块帧之前发送格式名"SESSION"、长度16、会话令牌long、下一帧序号long的消息，见[ResumePoint]
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+class FrameStreamReader(private var input: DataInputStream) {
+
+    /**
+     * 握手信息
+     *
+     * @property width 屏幕宽度（设备像素）
+     * @property height 屏幕高度（设备像素）
+     * @property isCacio 是否来自真实的CTCScreen
+     * @property uiScale UI缩放比例
+     */
+    data class ScreenInfo(val width: Int, val height: Int, val isCacio: Boolean, val uiScale: Float)
+
+    /**
+     * 一帧数据，data只在下一次[readFrame]之前有效
+     *
+     * @property formatName 服务端发送的格式名
+     * @property data 帧数据缓冲区，有效部分为前length字节
+     * @property length 数据长度，0表示空帧，-1表示画面未变化
+     * @property wireLength 实际传输的数据长度，压缩帧为压缩后的长度
+     */
+    class Frame(val formatName: String, val data: ByteArray, val length: Int, val wireLength: Int = length) {
+        /** 帧中是否带有像素数据 */
+        val hasPixels: Boolean get() = length > 0
+
+        /** 是否为分块帧，需要交给[TileFrameDecoder]解码 */
+        val isTiled: Boolean get() = formatName == TileFrameDecoder.FORMAT
+
+        /** 像素格式，格式名无法识别时为null */
+        val format: PixelFormat? get() = PixelFormat.entries.firstOrNull { it.name == formatName }
+    }
+
+    /**
+     * 会话恢复点
+     *
+     * 服务端在SESSION消息中发送会话令牌和下一帧的序号；查看器断线后在HELLO中带回令牌和已应用的帧数，
+     * 帧数与服务端已编码的帧数一致时服务端接管原来的编码状态，只发送之后变化的块
+     *
+     * @property token 会话令牌
+     * @property frames 帧数，即下一帧的帧序号
+     */
+    data class ResumePoint(val token: Long, val frames: Long)
+
+    private var buffer = ByteArray(0)
+    private var compressed = ByteArray(0)
+    private var inflater: Inflater? = null
+
+    /** 收到输入确认时的回调，参数为输入序号（连接上发送的第几行，从0开始），在读取线程调用 */
+    var onInputAck: ((Long) -> Unit)? = null
+
+    /** 收到会话消息时的回调，在读取线程调用，之后的帧序号从[ResumePoint.frames]开始 */
+    var onSession: ((ResumePoint) -> Unit)? = null
+
+    /** 累计解压耗时（纳秒） */
+    var inflateNanos = 0L
+        private set
+
+    /**
+     * 读取握手信息，必须在读取帧之前调用一次
+     *
+     * @throws IOException 当连接中断时抛出
+     */
+    fun readScreenInfo(): ScreenInfo {
+        val width = input.readInt()
+        val height = input.readInt()
+        val isCacio = input.readBoolean()
+        val uiScale = input.readFloat()
+        return ScreenInfo(width, height, isCacio, uiScale)
+    }
+
+    /**
+     * 阻塞读取下一帧
+     *
+     * @throws IOException 当连接中断或数据长度非法时抛出
+     */
+    fun readFrame(): Frame {
+        var formatName = input.readUTF()
+        var length = input.readInt()
+        while (formatName == MUX_MARKER || formatName == ACK_MESSAGE || formatName == SESSION_MESSAGE) {
+            when (formatName) {
+                MUX_MARKER -> input = DataInputStream(MultiplexedInputStream(input) { onInputAck?.invoke(it) })
+                ACK_MESSAGE -> {
+                    if (length != 8) throw IOException("非法的输入确认长度: $length")
+                    onInputAck?.invoke(input.readLong())
+                }
+                else -> {
+                    if (length != 16) throw IOException("非法的会话消息长度: $length")
+                    val token = input.readLong()
+                    onSession?.invoke(ResumePoint(token, input.readLong()))
+                }
+            }
+            formatName = input.readUTF()
+            length = input.readInt()
+        }
+        if (formatName.startsWith(DEFLATE_PREFIX)) {
+            return readDeflatedFrame(formatName.substring(DEFLATE_PREFIX.length), length)
+        }
+        if (length <= 0) return Frame(formatName, buffer, length)
+
+        if (buffer.size < length) buffer = ByteArray(length)
+        input.readFully(buffer, 0, length)
+        return Frame(formatName, buffer, length)
+    }
+
+    /**
+     * 读取并解压一个压缩帧，每帧以SYNC_FLUSH结束，因此压缩数据读完即可得到完整的帧
+     */
+    private fun readDeflatedFrame(formatName: String, length: Int): Frame {
+        if (length <= 0) return Frame(formatName, buffer, length)
+        val rawLength = input.readInt()
+        if (rawLength < 0) throw IOException("非法的解压后长度: $rawLength")
+
+        if (compressed.size < length) compressed = ByteArray(length)
+        input.readFully(compressed, 0, length)
+        if (buffer.size < rawLength) buffer = ByteArray(rawLength)
+
+        val start = System.nanoTime()
+        val stream = inflater ?: Inflater().also { inflater = it }
+        stream.setInput(compressed, 0, length)
+        var produced = 0
+        try {
+            while (produced < rawLength) {
+                val count = stream.inflate(buffer, produced, rawLength - produced)
+                if (count == 0 && (stream.needsInput() || stream.needsDictionary() || stream.finished())) {
+                    throw IOException("压缩帧数据不完整: $produced/$rawLength")
+                }
+                produced += count
+            }
+        } catch (e: DataFormatException) {
+            throw IOException("压缩帧数据损坏: ${e.message}", e)
+        }
+        inflateNanos += System.nanoTime() - start
+        return Frame(formatName, buffer, rawLength, length)
+    }
+
+    /** 释放解压器的本地内存，连接关闭后调用 */
+    fun close() {
+        inflater?.end()
+        inflater = null
+    }
+
+    private companion object {
+        /** 压缩帧格式名的前缀，与服务端FrameDeflater.PREFIX一致 */
+        const val DEFLATE_PREFIX = "Z:"
+
+        /** 切换到通道复用的消息格式名 */
+        const val MUX_MARKER = "MUX"
+
+        /** 未复用时输入确认的消息格式名 */
+        const val ACK_MESSAGE = "ACK"
+
+        /** 会话令牌的消息格式名 */
+        const val SESSION_MESSAGE = "SESSION"
+    }
+}
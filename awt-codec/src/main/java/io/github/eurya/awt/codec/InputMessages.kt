@@ -0,0 +1,79 @@
+package io.github.eurya.awt.codec
+
+import java.util.Base64
+
+/**
+ * 输入事件消息
+ *
+ * 功能：
+ * - 生成客户端发往ClientEventTask的文本消息，格式为"类型|参数1|参数2"，每条一行
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+object InputMessages {
+
+    /**
+     * 查看器能力声明，读取握手信息后发送一次
+     *
+     * @param cacheBytes 分块缓存预算（字节），服务端据此分配槽位，见[TileFrameDecoder]
+     * @param jpeg 是否能解码照片类的JPEG块
+     * @param deflateLevel 跨帧deflate压缩等级0-9，-1表示不压缩
+     * @param ack 是否请求服务端确认每条输入消息，见[FrameStreamReader.onInputAck]
+     * @param mux 是否请求通道复用，输入确认不再排在整帧之后，见[MultiplexedInputStream]
+     * @param resume 是否请求会话令牌，断线后可以凭令牌恢复编码状态，见[FrameStreamReader.onSession]
+     * @param resumeFrom 上一个会话的恢复点，不为null时请求服务端接管该会话，只发送之后变化的块
+     */
+    @JvmStatic
+    @JvmOverloads
+    fun hello(
+        cacheBytes: Long,
+        jpeg: Boolean = false,
+        deflateLevel: Int = -1,
+        ack: Boolean = false,
+        mux: Boolean = false,
+        resume: Boolean = false,
+        resumeFrom: FrameStreamReader.ResumePoint? = null
+    ): String {
+        val features = listOfNotNull(
+            "jpeg".takeIf { jpeg },
+            "deflate=$deflateLevel".takeIf { deflateLevel >= 0 },
+            "ack".takeIf { ack },
+            "mux".takeIf { mux },
+            when {
+                resumeFrom != null -> "resume=${resumeFrom.token}:${resumeFrom.frames}"
+                resume -> "resume"
+                else -> null
+            }
+        )
+        return "HELLO|$cacheBytes" + if (features.isEmpty()) "" else "|" + features.joinToString(",")
+    }
+
+    @JvmStatic
+    fun mouseMove(x: Int, y: Int): String = "MOUSE_MOVE|$x|$y"
+
+    @JvmStatic
+    fun mousePress(button: Int): String = "MOUSE_PRESS|$button"
+
+    @JvmStatic
+    fun mouseRelease(button: Int): String = "MOUSE_RELEASE|$button"
+
+    /** 单个字符输入，服务端转换为一次KEY_TYPED */
+    @JvmStatic
+    fun charInput(c: Char): String = "CHAR_INPUT|${c.code}"
+
+    /**
+     * 整段文本提交，UTF-16BE + Base64：保留任意Unicode字符，且不会与分隔符或换行冲突
+     */
+    @JvmStatic
+    fun textCommit(text: String): String =
+        "TEXT_COMMIT|" + Base64.getEncoder().encodeToString(text.toByteArray(Charsets.UTF_16BE))
+
+    /**
+     * 查看器键盘的区域，服务端据此切换按键映射的键盘布局
+     *
+     * @param languageTag IETF语言标签，如de-DE
+     */
+    @JvmStatic
+    fun keyboardLocale(languageTag: String): String = "KEYBOARD_LOCALE|$languageTag"
+}
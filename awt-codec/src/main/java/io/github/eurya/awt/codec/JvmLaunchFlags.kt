@@ -0,0 +1,67 @@
+package io.github.eurya.awt.codec
+
+/**
+ * 目标JVM的启动参数
+ *
+ * 功能：
+ * - 设备上的NativeJavaLauncher和主机端回环基准测试（awt-bench的TargetProcess）共用同一份系统属性和模块导出，
+ *   基准测试启动的JVM与设备上的启动方式一致
+ * - 引导类路径和Java代理参数依赖各自的文件布局，由调用方添加
+ *
+ * @author qz919
+ * @data 2025/10/18
+ */
+object JvmLaunchFlags {
+
+    /**
+     * 模块系统导出和打开指令
+     *
+     * Cacio实现和AWT组件需要访问java.desktop和java.base的内部API
+     */
+    @JvmField
+    val MODULE_EXPORTS: List<String> = listOf(
+        "--add-exports=java.desktop/java.awt=ALL-UNNAMED",
+        "--add-exports=java.desktop/java.awt.peer=ALL-UNNAMED",
+        "--add-exports=java.desktop/sun.awt.image=ALL-UNNAMED",
+        "--add-exports=java.desktop/sun.java2d=ALL-UNNAMED",
+        "--add-exports=java.desktop/java.awt.dnd.peer=ALL-UNNAMED",
+        "--add-exports=java.desktop/sun.awt=ALL-UNNAMED",
+        "--add-exports=java.desktop/sun.awt.event=ALL-UNNAMED",
+        "--add-exports=java.desktop/sun.awt.datatransfer=ALL-UNNAMED",
+        "--add-exports=java.desktop/sun.font=ALL-UNNAMED",
+        "--add-exports=java.base/sun.security.action=ALL-UNNAMED",
+        "--add-opens=java.base/java.util=ALL-UNNAMED",
+        "--add-opens=java.desktop/java.awt=ALL-UNNAMED",
+        "--add-opens=java.desktop/sun.font=ALL-UNNAMED",
+        "--add-opens=java.desktop/sun.java2d=ALL-UNNAMED",
+        "--add-opens=java.base/java.lang.reflect=ALL-UNNAMED",
+        "--add-opens=java.base/java.net=ALL-UNNAMED"
+    )
+
+    /**
+     * AWT、图形环境和字体管理相关的系统属性
+     *
+     * 使用Cacio作为AWT工具包以在headless环境中提供图形支持
+     *
+     * @param width 屏幕宽度（逻辑像素）
+     * @param height 屏幕高度（逻辑像素）
+     * @param uiScale 界面缩放比例，渲染分辨率 = 屏幕尺寸 × uiScale
+     */
+    @JvmStatic
+    fun systemProperties(width: Int, height: Int, uiScale: Float): List<String> = listOf(
+        "-Djava.awt.headless=false",
+        // 开启抗锯齿
+        "-Dawt.useSystemAAFontSettings=on",
+        "-Dswing.aatext=true",
+
+        "-Dcacio.managed.screensize=${width}x${height}",
+        // HiDPI: 以逻辑尺寸布局，按缩放比例渲染设备像素
+        "-Dcacio.managed.uiscale=$uiScale",
+        "-Dcacio.font.fontmanager=sun.awt.X11FontManager",
+        "-Dcacio.font.fontscaler=sun.font.FreetypeFontScaler",
+        "-Dswing.defaultlaf=javax.swing.plaf.metal.MetalLookAndFeel",
+        "-Dawt.toolkit=com.github.caciocavallosilano.cacio.ctc.CTCToolkit",
+        "-Djava.awt.graphicsenv=com.github.caciocavallosilano.cacio.ctc.CTCGraphicsEnvironment",
+        "-Djava.system.class.loader=com.github.caciocavallosilano.cacio.ctc.CTCPreloadClassLoader"
+    )
+}
@@ -0,0 +1,91 @@
+package io.github.eurya.awt.codec
+
+import java.io.DataInputStream
+import java.io.IOException
+import java.io.InputStream
+
+/**
+ * 通道复用的解复用输入流
+ *
+ * 功能：
+ * - 服务端切换到通道复用后，数据按"通道号byte、长度int、数据"分块到达，对应服务端StreamConnection
+ * - 帧通道的分块数据拼接成连续的字节流，上层的[FrameStreamReader]照常解析帧格式，感知不到分块边界
+ * - 输入确认通道的分块在读到时立即回调，不必等待正在传输的关键帧读完
+ * - 未知通道的分块整块跳过，便于服务端以后增加新通道
+ *
+ * @param source 切换消息之后的原始数据流
+ * @param onInputAck 收到输入确认时的回调，参数为输入序号
+ *
+ * @author qz919
+ * @data 2025/10/11
+ */
+class MultiplexedInputStream(
+    private val source: DataInputStream,
+    private val onInputAck: (Long) -> Unit
+) : InputStream() {
+
+    companion object {
+        /** 输入确认通道，与服务端一致 */
+        const val CHANNEL_INPUT = 0
+
+        /** 帧通道，与服务端一致 */
+        const val CHANNEL_FRAME = 1
+    }
+
+    /** 当前帧通道分块中尚未读取的字节数 */
+    private var remaining = 0
+
+    private val skipBuffer = ByteArray(4096)
+
+    override fun read(): Int {
+        if (!awaitFrameBytes()) return -1
+        val value = source.read()
+        if (value >= 0) remaining--
+        return value
+    }
+
+    override fun read(b: ByteArray, off: Int, len: Int): Int {
+        if (len == 0) return 0
+        if (!awaitFrameBytes()) return -1
+        val count = source.read(b, off, minOf(len, remaining))
+        if (count > 0) remaining -= count
+        return count
+    }
+
+    override fun available(): Int = minOf(remaining, source.available())
+
+    override fun close() = source.close()
+
+    /**
+     * 处理非帧通道的分块，直到帧通道有数据可读
+     *
+     * @return 连接已结束时返回false
+     */
+    private fun awaitFrameBytes(): Boolean {
+        while (remaining == 0) {
+            val channel = source.read()
+            if (channel < 0) return false
+            val length = source.readInt()
+            if (length < 0) throw IOException("非法的分块长度: $length")
+
+            when (channel) {
+                CHANNEL_FRAME -> remaining = length
+                CHANNEL_INPUT -> {
+                    if (length != 8) throw IOException("非法的输入确认长度: $length")
+                    onInputAck(source.readLong())
+                }
+                else -> skip(length)
+            }
+        }
+        return true
+    }
+
+    private fun skip(length: Int) {
+        var left = length
+        while (left > 0) {
+            val count = minOf(left, skipBuffer.size)
+            source.readFully(skipBuffer, 0, count)
+            left -= count
+        }
+    }
+}
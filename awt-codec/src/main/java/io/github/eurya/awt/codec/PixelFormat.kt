@@ -0,0 +1,18 @@
+package io.github.eurya.awt.codec
+
+/**
+ * 帧数据的像素格式，名称与服务端ScreenCaptureTask.PixelFormat一致，随帧以writeUTF发送
+ *
+ * - ARGB: 带透明通道的32位颜色格式
+ * - RGB:  24位RGB颜色格式
+ * - RGB565: 16位RGB颜色格式
+ * - GRAYSCALE: 8位灰度格式
+ *
+ * @property bytesPerPixel 每个像素占用的字节数
+ *
+ * @author qz919
+ * @data 2025/10/06
+ */
+enum class PixelFormat(val bytesPerPixel: Int) {
+    ARGB(4), RGB(3), RGB565(2), GRAYSCALE(1)
+}
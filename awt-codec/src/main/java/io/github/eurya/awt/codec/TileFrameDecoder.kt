@@ -0,0 +1,261 @@
+package io.github.eurya.awt.codec
+
+import java.io.IOException
+import java.util.Arrays
+
+/**
+ * 分块帧解码器
+ *
+ * 功能：
+ * - 解码服务端TileFrameEncoder发送的TILES帧，把变化的块写入整屏像素缓冲区
+ * - 按服务端指定的槽位缓存解码后的块，CACHE_HIT时直接从槽位复制，不再传输像素
+ * - 缓存总量受HELLO中声明的预算限制，槽位的分配和淘汰完全由服务端决定，两端始终一致
+ * - 照片类块为JPEG，交给平台提供的[TileImageDecoder]解码，解码结果同样可以存入槽位
+ * - 纯色和渐变块只携带颜色，按行用Arrays.fill/System.arraycopy展开，两者在JIT和ART上都是向量化的内建实现
+ * - 界面块多以块内调色板发送，按1/2/4/8位索引查表展开，同样可以存入槽位
+ * - 服务端负载高时块以RGB565降级发送，不进缓存，稳定后服务端会再发一次完整内容覆盖
+ *
+ * 分块帧只描述变化的块，因此同一个解码器和像素缓冲区需要在整个连接中复用
+ *
+ * @param width 屏幕宽度（设备像素）
+ * @param height 屏幕高度（设备像素）
+ * @param cacheBytes 缓存预算（字节），需与HELLO中发送的值一致
+ * @param imageDecoder JPEG块的解码器，为null时不能在HELLO中声明jpeg能力
+ *
+ * @author qz919
+ * @data 2025/10/07
+ */
+class TileFrameDecoder(
+    private val width: Int,
+    private val height: Int,
+    val cacheBytes: Long,
+    private val imageDecoder: TileImageDecoder? = null
+) {
+
+    companion object {
+        /** 分块帧的格式名 */
+        const val FORMAT = "TILES"
+
+        /** 块边长，与服务端一致 */
+        const val TILE_SIZE = 64
+
+        private const val OP_PIXELS = 0
+        private const val OP_CACHE_HIT = 1
+        private const val OP_FILL = 2
+        private const val OP_GRADIENT_VERTICAL = 3
+        private const val OP_GRADIENT_HORIZONTAL = 4
+        private const val OP_JPEG = 5
+        private const val OP_RGB565 = 6
+        private const val OP_PALETTE = 7
+
+        /** 按预算计算槽位数，每个槽位可容纳一个完整的块 */
+        @JvmStatic
+        fun slotCount(cacheBytes: Long): Int =
+            (cacheBytes.coerceAtLeast(0) / (TILE_SIZE * TILE_SIZE * 4)).coerceAtMost(Int.MAX_VALUE.toLong()).toInt()
+    }
+
+    private val columns = (width + TILE_SIZE - 1) / TILE_SIZE
+
+    /** 槽位中的块像素，首次写入时分配 */
+    private val slots = arrayOfNulls<IntArray>(slotCount(cacheBytes))
+
+    /** JPEG块的解码缓冲区 */
+    private val tilePixels = IntArray(TILE_SIZE * TILE_SIZE)
+
+    /** 调色板块的颜色表 */
+    private val palette = IntArray(256)
+
+    /** 是否能解码照片类块，即HELLO中是否可以声明jpeg */
+    val supportsJpeg: Boolean get() = imageDecoder != null
+
+    /** 最近一帧以像素接收的块数 */
+    var pixelTiles = 0
+        private set
+
+    /** 最近一帧命中缓存的块数 */
+    var cacheHits = 0
+        private set
+
+    /** 最近一帧以纯色或渐变命令接收的块数 */
+    var fillTiles = 0
+        private set
+
+    /** 最近一帧以JPEG接收的块数 */
+    var photoTiles = 0
+        private set
+
+    /** 最近一帧以调色板接收的块数 */
+    var paletteTiles = 0
+        private set
+
+    /** 最近一帧以RGB565降级接收的块数 */
+    var degradedTiles = 0
+        private set
+
+    /**
+     * 把一帧分块数据应用到像素缓冲区
+     *
+     * @param data 帧数据
+     * @param length 数据长度
+     * @param pixels 整屏ARGB像素，长度为宽x高，保存上一帧的画面
+     * @throws IOException 当数据不完整或引用了不存在的槽位时抛出
+     */
+    fun decode(data: ByteArray, length: Int, pixels: IntArray) {
+        require(pixels.size == width * height) { "像素缓冲区尺寸不匹配: ${pixels.size}" }
+        var position = 0
+
+        fun readInt(): Int {
+            if (position + 4 > length) throw IOException("分块帧数据不完整")
+            val value = ((data[position].toInt() and 0xFF) shl 24) or
+                    ((data[position + 1].toInt() and 0xFF) shl 16) or
+                    ((data[position + 2].toInt() and 0xFF) shl 8) or
+                    (data[position + 3].toInt() and 0xFF)
+            position += 4
+            return value
+        }
+
+        val tileSize = readInt()
+        if (tileSize != TILE_SIZE) throw IOException("不支持的块大小: $tileSize")
+        val operations = readInt()
+        pixelTiles = 0
+        cacheHits = 0
+        fillTiles = 0
+        photoTiles = 0
+        paletteTiles = 0
+        degradedTiles = 0
+
+        repeat(operations) {
+            if (position >= length) throw IOException("分块帧数据不完整")
+            val op = data[position++].toInt()
+            val index = readInt()
+            val slot = readInt()
+
+            val x = index % columns * TILE_SIZE
+            val y = index / columns * TILE_SIZE
+            if (index < 0 || y >= height) throw IOException("块序号越界: $index")
+            val w = minOf(TILE_SIZE, width - x)
+            val h = minOf(TILE_SIZE, height - y)
+
+            when (op) {
+                OP_PIXELS -> {
+                    if (position + w * h * 4 > length) throw IOException("分块帧数据不完整")
+                    for (row in 0 until h) {
+                        val offset = (y + row) * width + x
+                        for (i in 0 until w) {
+                            val a = (data[position].toInt() and 0xFF) shl 24       // Alpha通道
+                            val r = (data[position + 1].toInt() and 0xFF) shl 16   // Red通道
+                            val g = (data[position + 2].toInt() and 0xFF) shl 8    // Green通道
+                            val b = (data[position + 3].toInt() and 0xFF)          // Blue通道
+                            pixels[offset + i] = a or r or g or b
+                            position += 4
+                        }
+                    }
+                    if (slot >= 0) store(slot, pixels, x, y, w, h)
+                    pixelTiles++
+                }
+
+                OP_CACHE_HIT -> {
+                    val tile = slots.getOrNull(slot) ?: throw IOException("缓存槽位不存在: $slot")
+                    for (row in 0 until h) {
+                        System.arraycopy(tile, row * w, pixels, (y + row) * width + x, w)
+                    }
+                    cacheHits++
+                }
+
+                OP_FILL -> {
+                    val color = readInt()
+                    for (row in 0 until h) {
+                        val offset = (y + row) * width + x
+                        Arrays.fill(pixels, offset, offset + w, color)
+                    }
+                    fillTiles++
+                }
+
+                OP_GRADIENT_VERTICAL -> {
+                    for (row in 0 until h) {
+                        val offset = (y + row) * width + x
+                        Arrays.fill(pixels, offset, offset + w, readInt())
+                    }
+                    fillTiles++
+                }
+
+                OP_GRADIENT_HORIZONTAL -> {
+                    val first = y * width + x
+                    for (i in 0 until w) pixels[first + i] = readInt()
+                    for (row in 1 until h) {
+                        System.arraycopy(pixels, first, pixels, first + row * width, w)
+                    }
+                    fillTiles++
+                }
+
+                OP_JPEG -> {
+                    val decoder = imageDecoder ?: throw IOException("未声明JPEG能力却收到JPEG块")
+                    val size = readInt()
+                    if (size < 0 || position + size > length) throw IOException("分块帧数据不完整")
+                    decoder.decode(data, position, size, w, h, tilePixels)
+                    position += size
+                    for (row in 0 until h) {
+                        System.arraycopy(tilePixels, row * w, pixels, (y + row) * width + x, w)
+                    }
+                    if (slot >= 0) store(slot, pixels, x, y, w, h)
+                    photoTiles++
+                }
+
+                OP_RGB565 -> {
+                    if (position + w * h * 2 > length) throw IOException("分块帧数据不完整")
+                    for (row in 0 until h) {
+                        val offset = (y + row) * width + x
+                        for (i in 0 until w) {
+                            val rgb565 = ((data[position].toInt() and 0xFF) shl 8) or (data[position + 1].toInt() and 0xFF)
+                            val r = ((rgb565 shr 11) and 0x1F) * 255 / 31
+                            val g = ((rgb565 shr 5) and 0x3F) * 255 / 63
+                            val b = (rgb565 and 0x1F) * 255 / 31
+                            pixels[offset + i] = (0xFF shl 24) or (r shl 16) or (g shl 8) or b
+                            position += 2
+                        }
+                    }
+                    degradedTiles++
+                }
+
+                OP_PALETTE -> {
+                    if (position >= length) throw IOException("分块帧数据不完整")
+                    val colors = (data[position++].toInt() and 0xFF) + 1
+                    for (i in 0 until colors) palette[i] = readInt()
+                    val bits = when {
+                        colors <= 2 -> 1
+                        colors <= 4 -> 2
+                        colors <= 16 -> 4
+                        else -> 8
+                    }
+                    val mask = (1 shl bits) - 1
+                    val rowBytes = (w * bits + 7) / 8
+                    if (position + rowBytes * h > length) throw IOException("分块帧数据不完整")
+                    for (row in 0 until h) {
+                        val offset = (y + row) * width + x
+                        for (i in 0 until w) {
+                            val bit = i * bits
+                            val packed = data[position + (bit ushr 3)].toInt() and 0xFF
+                            val color = (packed ushr (8 - bits - (bit and 7))) and mask
+                            if (color >= colors) throw IOException("调色板索引越界: $color")
+                            pixels[offset + i] = palette[color]
+                        }
+                        position += rowBytes
+                    }
+                    if (slot >= 0) store(slot, pixels, x, y, w, h)
+                    paletteTiles++
+                }
+
+                else -> throw IOException("未知的分块操作: $op")
+            }
+        }
+    }
+
+    /** 把刚写入的块复制到槽位，覆盖服务端淘汰的旧内容 */
+    private fun store(slot: Int, pixels: IntArray, x: Int, y: Int, w: Int, h: Int) {
+        if (slot >= slots.size) throw IOException("缓存槽位超出预算: $slot")
+        val tile = slots[slot] ?: IntArray(TILE_SIZE * TILE_SIZE).also { slots[slot] = it }
+        for (row in 0 until h) {
+            System.arraycopy(pixels, (y + row) * width + x, tile, row * w, w)
+        }
+    }
+}
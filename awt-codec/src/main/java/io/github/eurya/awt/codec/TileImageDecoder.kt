@@ -0,0 +1,27 @@
+package io.github.eurya.awt.codec
+
+/**
+ * 照片类分块的图像解码器
+ *
+ * 功能：
+ * - 把服务端JpegTileEncoder生成的JPEG块解码为ARGB像素
+ * - 由平台提供实现：应用使用BitmapFactory（libjpeg-turbo），主机端基准测试使用ImageIO
+ *
+ * @author qz919
+ * @data 2025/10/07
+ */
+fun interface TileImageDecoder {
+
+    /**
+     * 解码一个JPEG块
+     *
+     * @param data 数据缓冲区
+     * @param offset JPEG数据的起始位置
+     * @param length JPEG数据长度
+     * @param width 块宽度
+     * @param height 块高度
+     * @param out 输出的ARGB像素，按行排列，行宽为width
+     * @throws java.io.IOException 当数据无法解码或尺寸不符时抛出
+     */
+    fun decode(data: ByteArray, offset: Int, length: Int, width: Int, height: Int, out: IntArray)
+}
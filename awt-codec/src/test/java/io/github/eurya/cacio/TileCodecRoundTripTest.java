@@ -0,0 +1,233 @@
+package io.github.eurya.cacio;
+
+import io.github.eurya.awt.codec.TileFrameDecoder;
+import io.github.eurya.awt.codec.TileImageDecoder;
+import org.junit.Test;
+
+import javax.imageio.ImageIO;
+import java.awt.image.BufferedImage;
+import java.io.ByteArrayInputStream;
+import java.io.DataInputStream;
+import java.io.IOException;
+import java.io.UncheckedIOException;
+import java.nio.ByteBuffer;
+import java.util.Arrays;
+
+import static org.junit.Assert.assertArrayEquals;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNull;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * 分块帧编解码的往返测试
+ * <p>
+ * 服务端的{@link TileFrameEncoder}编码，查看器的{@link TileFrameDecoder}解码，无损路径上解码结果必须与原始像素完全一致。
+ * 覆盖边缘块、各索引位宽的调色板、缓存槽位淘汰、会话恢复和低质量JPEG块的细化
+ */
+public class TileCodecRoundTripTest {
+
+    private static final int TILE = TileFrameEncoder.TILE_SIZE;
+
+    private static final long SLOT_BYTES = TILE * TILE * 4L;
+
+    /** 用ImageIO解码JPEG块，代替应用中的BitmapFactory */
+    private static final TileImageDecoder IMAGE_IO = (data, offset, length, width, height, out) -> {
+        BufferedImage image;
+        try {
+            image = ImageIO.read(new ByteArrayInputStream(data, offset, length));
+        } catch (IOException e) {
+            throw new UncheckedIOException(e);
+        }
+        if (image == null) throw new UncheckedIOException(new IOException("无法解码JPEG块"));
+        image.getRGB(0, 0, width, height, out, 0, width);
+    };
+
+    @Test
+    public void edgeTilesRoundTrip() throws IOException {
+        // 宽高都不是块大小的整数倍，右侧块宽5、底部块高3
+        int width = 2 * TILE + 5;
+        int height = TILE + 3;
+        int[] screen = new int[width * height];
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                // 每个块远超256色，走完整像素路径
+                screen[y * width + x] = 0xFF000000 | (x * 0x10305 + y * 0x1030) & 0xFFFFFF;
+            }
+        }
+
+        TileFrameEncoder encoder = new TileFrameEncoder(width, height, 8 * SLOT_BYTES, null, new QualityController(30));
+        TileFrameDecoder decoder = new TileFrameDecoder(width, height, 8 * SLOT_BYTES, null);
+        int[] pixels = new int[width * height];
+        apply(decoder, encoder.encode(screen), pixels);
+        assertArrayEquals(screen, pixels);
+
+        // 只改变右下角的边缘块
+        screen[width * height - 1] ^= 0x00FFFFFF;
+        byte[] frame = encoder.encode(screen);
+        apply(decoder, frame, pixels);
+        assertArrayEquals(screen, pixels);
+        assertEquals(1, readInt(frame, 4));
+    }
+
+    @Test
+    public void paletteRoundTripAtEveryIndexWidth() throws IOException {
+        int width = 2 * TILE + 9;
+        int height = TILE + 7;
+        for (int colors : new int[]{2, 3, 4, 5, 16, 17, 256}) {
+            int[] screen = paletteScreen(width, height, colors, 0);
+            TileFrameEncoder encoder = new TileFrameEncoder(width, height, 8 * SLOT_BYTES, null, new QualityController(30));
+            TileFrameDecoder decoder = new TileFrameDecoder(width, height, 8 * SLOT_BYTES, null);
+            int[] pixels = new int[width * height];
+            apply(decoder, encoder.encode(screen), pixels);
+
+            assertArrayEquals("颜色数 " + colors, screen, pixels);
+            assertTrue("颜色数 " + colors + " 应以调色板发送", encoder.getPaletteTiles() >= 2);
+            assertEquals(encoder.getPaletteTiles(), decoder.getPaletteTiles());
+        }
+    }
+
+    @Test
+    public void cacheEvictionKeepsSlotsInSync() throws IOException {
+        // 两个槽位，A、B、C轮流出现在同一个块位置
+        int[] a = paletteScreen(TILE, TILE, 5, 0);
+        int[] b = paletteScreen(TILE, TILE, 5, 1);
+        int[] c = paletteScreen(TILE, TILE, 5, 2);
+        TileFrameEncoder encoder = new TileFrameEncoder(TILE, TILE, 2 * SLOT_BYTES, null, new QualityController(30));
+        TileFrameDecoder decoder = new TileFrameDecoder(TILE, TILE, 2 * SLOT_BYTES, null);
+        int[] pixels = new int[TILE * TILE];
+
+        int[][] sequence = {a, b, c, a, c, b};
+        // C淘汰A，A再淘汰B，只有第二次出现的C还在缓存中，最后的B已被淘汰
+        int[] expectedHits = {0, 0, 0, 0, 1, 0};
+        for (int i = 0; i < sequence.length; i++) {
+            apply(decoder, encoder.encode(sequence[i]), pixels);
+            assertArrayEquals("第" + i + "帧", sequence[i], pixels);
+            assertEquals("第" + i + "帧", expectedHits[i], encoder.getCacheHits());
+            assertEquals(expectedHits[i], decoder.getCacheHits());
+        }
+    }
+
+    @Test
+    public void resumeWithMismatchedFrameCountResendsAllTiles() throws IOException {
+        int width = 3 * TILE;
+        int height = 2 * TILE;
+        int[] first = paletteScreen(width, height, 4, 0);
+        int[] second = first.clone();
+        second[0] ^= 0x00FFFFFF;
+
+        CTCScreenWrapper wrapper = new CTCScreenWrapper();
+        wrapper.setScreenSize(width, height);
+        ScreenCaptureTask task = new ScreenCaptureTask("test", wrapper, 30);
+        task.enableTileCache(8 * SLOT_BYTES, false, -1);
+        TileFrameDecoder decoder = new TileFrameDecoder(width, height, 8 * SLOT_BYTES, null);
+        int[] pixels = new int[width * height];
+
+        applyMessage(decoder, task.encodeFrame(first, 0), pixels);
+        task.encodeFrame(second, 0); // 断开时还没有送达查看器
+        assertEquals(2, task.getFrameCount());
+
+        // 查看器只应用了1帧，编码状态作废，下一帧包含所有块
+        task.resume(8 * SLOT_BYTES, false, -1, 1);
+        byte[] frame = applyMessage(decoder, task.encodeFrame(second, 0), pixels);
+        assertEquals(6, readInt(frame, 4));
+        assertArrayEquals(second, pixels);
+
+        // 帧数一致时继续使用原来的编码状态，画面没有变化就不发送块
+        task.resume(8 * SLOT_BYTES, false, -1, task.getFrameCount());
+        assertNull(applyMessage(decoder, task.encodeFrame(second, 0), pixels));
+        assertArrayEquals(second, pixels);
+        task.close();
+    }
+
+    @Test
+    public void lowQualityJpegTilesAreRefinedAndNotCached() throws Exception {
+        JpegTileEncoder jpeg = JpegTileEncoder.create();
+        if (jpeg == null) return; // 没有JPEG编码器的JRE上照片块走无损路径
+
+        int width = 2 * TILE;
+        int height = TILE;
+        int[] photo = new int[TILE * TILE];
+        for (int y = 0; y < TILE; y++) {
+            for (int x = 0; x < TILE; x++) {
+                photo[y * TILE + x] = 0xFF000000 | (x * 3) << 16 | (y * 3) << 8 | (x + y) * 2;
+            }
+        }
+        int[] fill = new int[TILE * TILE];
+        Arrays.fill(fill, 0xFF336699);
+
+        QualityController controller = new QualityController(30);
+        assertTrue(controller.getQuality() < QualityController.MAX_QUALITY);
+        TileFrameEncoder encoder = new TileFrameEncoder(width, height, 8 * SLOT_BYTES, jpeg, controller);
+        TileFrameDecoder decoder = new TileFrameDecoder(width, height, 8 * SLOT_BYTES, IMAGE_IO);
+        int[] pixels = new int[width * height];
+
+        apply(decoder, encoder.encode(tiles(photo, fill)), pixels);
+        assertEquals(1, encoder.getPhotoTiles());
+
+        // 低质量版本不进缓存，同样的内容出现在另一个位置时重新编码
+        apply(decoder, encoder.encode(tiles(photo, photo)), pixels);
+        assertEquals(0, encoder.getCacheHits());
+        assertEquals(1, encoder.getPhotoTiles());
+
+        // 稳定后以最高质量细化，细化后的版本写入缓存
+        Thread.sleep(QualityController.REFINE_DELAY_NANOS / 1_000_000 + 50);
+        apply(decoder, encoder.encode(tiles(photo, photo)), pixels);
+        assertEquals(2, encoder.getRefinedTiles());
+
+        apply(decoder, encoder.encode(tiles(fill, fill)), pixels);
+        apply(decoder, encoder.encode(tiles(photo, fill)), pixels);
+        assertEquals(1, encoder.getCacheHits());
+        assertEquals(0, encoder.getPhotoTiles());
+    }
+
+    /**
+     * 每个块恰好用到{@code colors}种颜色，且没有整行或整列同色，不会被当作填充块
+     *
+     * @param shift 颜色序号的偏移，用于生成内容不同但颜色数相同的画面
+     */
+    private static int[] paletteScreen(int width, int height, int colors, int shift) {
+        int[] screen = new int[width * height];
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int index = ((y % TILE) * (TILE + 1) + x % TILE + shift) % colors;
+                screen[y * width + x] = 0xFF000000 | index * 0x010101 ^ shift << 22;
+            }
+        }
+        return screen;
+    }
+
+    /** 左右两个块拼成的画面 */
+    private static int[] tiles(int[] left, int[] right) {
+        int[] screen = new int[2 * TILE * TILE];
+        for (int row = 0; row < TILE; row++) {
+            System.arraycopy(left, row * TILE, screen, row * 2 * TILE, TILE);
+            System.arraycopy(right, row * TILE, screen, row * 2 * TILE + TILE, TILE);
+        }
+        return screen;
+    }
+
+    private static void apply(TileFrameDecoder decoder, byte[] frame, int[] pixels) throws IOException {
+        if (frame != null) decoder.decode(frame, frame.length, pixels);
+    }
+
+    /**
+     * 解析{@link ScreenCaptureTask#encodeFrame}的消息（未启用deflate）并应用分块帧
+     *
+     * @return 分块帧数据，没有块变化时返回null
+     */
+    private static byte[] applyMessage(TileFrameDecoder decoder, ByteBuffer message, int[] pixels) throws IOException {
+        DataInputStream in = new DataInputStream(
+                new ByteArrayInputStream(message.array(), message.arrayOffset() + message.position(), message.remaining()));
+        assertEquals(TileFrameEncoder.FORMAT, in.readUTF());
+        int length = in.readInt();
+        if (length < 0) return null;
+        byte[] frame = new byte[length];
+        in.readFully(frame);
+        apply(decoder, frame, pixels);
+        return frame;
+    }
+
+    private static int readInt(byte[] data, int offset) {
+        return ByteBuffer.wrap(data, offset, 4).getInt();
+    }
+}
@@ -22,16 +22,16 @@ public class AgentConfig {
     public int frameRate = 60;
 
     /**
-     * 虚拟屏幕显示宽度，单位为像素
-     * 默认值1280像素，定义远程桌面的水平分辨率
+     * 虚拟屏幕显示宽度，单位为设备像素
+     * 默认值0，表示跟随Cacio的屏幕尺寸（cacio.managed.screensize × cacio.managed.uiscale）
      */
-    public int screenWidth = 1280;
+    public int screenWidth = 0;
 
     /**
-     * 虚拟屏幕显示高度，单位为像素
-     * 默认值720像素，定义远程桌面的垂直分辨率
+     * 虚拟屏幕显示高度，单位为设备像素
+     * 默认值0，表示跟随Cacio的屏幕尺寸（cacio.managed.screensize × cacio.managed.uiscale）
      */
-    public int screenHeight = 720;
+    public int screenHeight = 0;
 
     /**
      * 服务器启动后是否自动开始服务
@@ -39,18 +39,30 @@ public class AgentConfig {
      */
     public boolean autoStart = true;
 
+    /**
+     * 从应用进程继承的追踪缓冲区fd
+     * 默认-1表示不记录追踪事件，见{@link TraceRing}
+     */
+    public int traceFd = -1;
+
+    /**
+     * 是否统计Cacio类加载，见{@link BootClassLoadProbe}
+     * 默认false，注册的类文件转换器会拖慢每个类的加载，只在基准测试中开启
+     */
+    public boolean classLoadProbe = false;
+
     /**
      * 生成配置信息的格式化字符串表示
      *
      * 用于调试日志和配置验证，显示所有关键配置参数的当前值。
-     * 格式：AgentConfig{port=8888, fps=60, screen=1280x720, autoStart=true}
+     * 格式：AgentConfig{port=8888, fps=60, screen=1280x720, autoStart=true, traceFd=-1, classProbe=false}
      *
      * @return 包含所有配置参数的格式化字符串
      */
     @SuppressWarnings("DefaultLocale")
     @Override
     public String toString() {
-        return String.format("AgentConfig{port=%d, fps=%d, screen=%dx%d, autoStart=%s}",
-                port, frameRate, screenWidth, screenHeight, autoStart);
+        return String.format("AgentConfig{port=%d, fps=%d, screen=%dx%d, autoStart=%s, traceFd=%d, classProbe=%s}",
+                port, frameRate, screenWidth, screenHeight, autoStart, traceFd, classLoadProbe);
     }
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+package io.github.eurya.cacio;
+
+import java.awt.Toolkit;
+import java.lang.instrument.ClassFileTransformer;
+import java.lang.instrument.Instrumentation;
+import java.lang.reflect.Field;
+import java.security.ProtectionDomain;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicInteger;
+
+/**
+ * Cacio类加载探针
+ * <p>
+ * 只观察应用程序自身触发的类加载，不主动加载或初始化任何类：通过Instrumentation注册一个不修改字节码的转换器，
+ * 统计引导类加载器定义的Cacio类数量，并在应用程序加载CTCToolkit后等待Toolkit初始化完成，
+ * 输出从premain到Toolkit可用的耗时和此时已加载的Cacio类数量，用于衡量合并引导jar前后的类加载开销
+ * <p>
+ * 转换器会让每个类的加载都经过一次回调，因此探针默认关闭，只在Agent参数classprobe=true时安装，
+ * 由主机端基准测试开启。Toolkit是否就绪通过读取{@link Toolkit}的静态字段判断，不调用
+ * {@link Toolkit#getDefaultToolkit()}；应用程序在{@link #TIMEOUT_SECONDS}秒内没有加载CTCToolkit时同样移除转换器。
+ * 需要逐个类的明细时改用JVM参数-Xlog:class+load
+ */
+final class BootClassLoadProbe implements ClassFileTransformer {
+
+    /** Cacio类的包名前缀（内部名称形式） */
+    private static final String CACIO_PREFIX = "com/github/caciocavallosilano/";
+
+    /** 应用程序通过awt.toolkit属性加载的工具包类 */
+    private static final String TOOLKIT_CLASS = "com/github/caciocavallosilano/cacio/ctc/CTCToolkit";
+
+    /** 等待CTCToolkit加载和初始化的最长时间 */
+    private static final long TIMEOUT_SECONDS = 60;
+
+    /** 轮询Toolkit是否就绪的间隔 */
+    private static final long POLL_MILLIS = 1;
+
+    private final Instrumentation inst;
+
+    private final long startNanos = System.nanoTime();
+
+    private final AtomicInteger cacioClasses = new AtomicInteger();
+
+    private final CountDownLatch toolkitLoaded = new CountDownLatch(1);
+
+    private volatile long toolkitLoadedAt;
+
+    private BootClassLoadProbe(Instrumentation inst) {
+        this.inst = inst;
+    }
+
+    /**
+     * 注册转换器并启动等待Toolkit初始化的守护线程
+     *
+     * @param inst premain收到的Instrumentation实例
+     */
+    static void install(Instrumentation inst) {
+        BootClassLoadProbe probe = new BootClassLoadProbe(inst);
+        inst.addTransformer(probe);
+
+        Thread thread = new Thread(probe::awaitToolkit, "Cacio-Class-Load-Probe");
+        thread.setDaemon(true);
+        thread.start();
+    }
+
+    @Override
+    public byte[] transform(ClassLoader loader, String className, Class<?> classBeingRedefined,
+                            ProtectionDomain protectionDomain, byte[] classfileBuffer) {
+        if (loader == null && classBeingRedefined == null && className != null && className.startsWith(CACIO_PREFIX)) {
+            cacioClasses.incrementAndGet();
+            if (className.equals(TOOLKIT_CLASS)) {
+                toolkitLoadedAt = System.nanoTime();
+                toolkitLoaded.countDown();
+            }
+        }
+        // 不修改字节码
+        return null;
+    }
+
+    /** 等待应用程序完成Toolkit初始化，输出统计后移除转换器 */
+    private void awaitToolkit() {
+        long deadline = startNanos + TimeUnit.SECONDS.toNanos(TIMEOUT_SECONDS);
+        try {
+            if (!toolkitLoaded.await(TIMEOUT_SECONDS, TimeUnit.SECONDS)) {
+                System.err.println("⚠️  " + TIMEOUT_SECONDS + "s内未加载CTCToolkit，停止统计Cacio类加载");
+                return;
+            }
+            // 加载CTCToolkit时应用程序已经进入Toolkit.getDefaultToolkit()，Toolkit类本身已初始化
+            Field instance = Toolkit.class.getDeclaredField("toolkit");
+            instance.setAccessible(true);
+            while (instance.get(null) == null) {
+                if (System.nanoTime() > deadline) {
+                    System.err.println("⚠️  Toolkit未在" + TIMEOUT_SECONDS + "s内完成初始化，停止统计Cacio类加载");
+                    return;
+                }
+                Thread.sleep(POLL_MILLIS);
+            }
+        } catch (InterruptedException e) {
+            Thread.currentThread().interrupt();
+            return;
+        } catch (ReflectiveOperationException | RuntimeException e) {
+            System.err.println("⚠️  无法读取Toolkit状态，停止统计Cacio类加载: " + e);
+            return;
+        } finally {
+            inst.removeTransformer(this);
+        }
+        long readyAt = System.nanoTime();
+
+        System.out.println("📦 Toolkit已初始化: premain后 " + ((readyAt - startNanos) / 1_000_000) + "ms，" +
+                "加载CTCToolkit后 " + ((readyAt - toolkitLoadedAt) / 1_000_000) + "ms，" +
+                "已加载 " + cacioClasses.get() + " 个Cacio类");
+    }
+}
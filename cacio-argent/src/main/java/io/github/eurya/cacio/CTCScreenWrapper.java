@@ -20,9 +20,12 @@ import java.lang.reflect.Method;
  */
 public class CTCScreenWrapper {
 
-    /** 当前屏幕尺寸信息，包含宽度和高度 */
+    /** 当前屏幕尺寸信息（设备像素），包含宽度和高度 */
     private Dimension screenSize;
 
+    /** UI缩放比例，即每个逻辑像素对应的设备像素数 */
+    private double uiScale = 1;
+
     /** CTCScreen实例的反射对象引用 */
     private Object ctcscreen;
 
@@ -38,7 +41,7 @@ public class CTCScreenWrapper {
     /** getCurrentScreenRGB方法的反射Method对象 */
     private Method getCurrentScreenRGBMethod;
 
-    /** getScreenDimension方法的反射Method对象 */
+    /** getDeviceScreenDimension方法的反射Method对象 */
     private Method getScreenDimensionMethod;
 
     /**
@@ -72,17 +75,18 @@ public class CTCScreenWrapper {
             getInstanceMethod.setAccessible(true);
             ctcscreen = getInstanceMethod.invoke(null);
 
-            // 获取屏幕尺寸信息
-            getScreenDimensionMethod = fullScreenWindowFactoryClass.getDeclaredMethod("getScreenDimension");
+            // 获取屏幕尺寸信息，捕获的像素数据以设备像素为单位
+            getScreenDimensionMethod = fullScreenWindowFactoryClass.getDeclaredMethod("getDeviceScreenDimension");
             Dimension d = (Dimension) getScreenDimensionMethod.invoke(null);
             this.screenSize = new Dimension(d.width, d.height);
+            this.uiScale = (Double) fullScreenWindowFactoryClass.getDeclaredMethod("getUIScale").invoke(null);
 
             // 获取屏幕数据捕获方法
             getCurrentScreenRGBMethod = ctcscreenClass.getDeclaredMethod("getCurrentScreenRGB");
 
             cacioAvailable = true;
             System.out.println("✅ CTCScreen包装器初始化成功（反射模式）");
-            System.out.println("📐 屏幕尺寸: " + screenSize.width + "x" + screenSize.height);
+            System.out.println("📐 屏幕尺寸: " + screenSize.width + "x" + screenSize.height + ", 缩放: " + uiScale);
 
         } catch (ClassNotFoundException e) {
             System.err.println("❌ 未找到Cacio相关类，请确保Cacio库在类路径中");
@@ -103,6 +107,7 @@ public class CTCScreenWrapper {
      */
     private void initializeFallback() {
         this.screenSize = new Dimension(800, 600);
+        this.uiScale = 1;
         cacioAvailable = false;
         ctcscreenClass = null;
         fullScreenWindowFactoryClass = null;
@@ -217,6 +222,17 @@ public class CTCScreenWrapper {
         return image;
     }
 
+    /**
+     * 获取UI缩放比例
+     * <p>
+     * 捕获的帧以设备像素为单位，逻辑尺寸 = 设备尺寸 / 缩放比例
+     *
+     * @return 每个逻辑像素对应的设备像素数
+     */
+    public double getUIScale() {
+        return uiScale;
+    }
+
     /**
      * 获取屏幕宽度
      *
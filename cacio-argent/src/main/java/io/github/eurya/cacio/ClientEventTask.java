@@ -1,10 +1,10 @@
 package io.github.eurya.cacio;
 
-import java.io.BufferedReader;
-import java.io.IOException;
-import java.io.InputStreamReader;
 import java.lang.reflect.Method;
-import java.net.Socket;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.util.Arrays;
+import java.util.Base64;
 
 /**
  * 客户端事件处理任务 - 使用CTCAndroidInput和反射机制
@@ -16,24 +16,41 @@ import java.net.Socket;
  * - 鼠标移动、点击、释放、滚轮
  * - 键盘按键按下、释放
  * - 字符输入
+ * - 整段文本提交（粘贴、输入法整句上屏）
+ * - 键盘区域切换（查看器输入法语言变化时切换按键映射）
+ * - 查看器能力声明（HELLO），编码能力和会话恢复转交连接的屏幕传输任务，传输能力（输入确认、通道复用）转交连接
  * <p>
  * 使用反射机制动态加载CTCAndroidInput类，避免编译时依赖，提高代码灵活性
+ * <p>
+ * 不持有线程：{@link ScreenStreamServer}的选择器线程读到数据后调用{@link #onInput}，这里按行切分并分发事件
  */
-public class ClientEventTask implements Runnable {
-    /** 客户端Socket连接，用于接收事件数据 */
-    private final Socket clientSocket;
+public class ClientEventTask {
+    /** 尚未收到换行符的半行数据 */
+    private byte[] lineBuffer = new byte[256];
+
+    /** 半行数据的长度 */
+    private int lineLength;
 
-    /** 任务运行状态标志，用于优雅停止事件处理 */
-    private volatile boolean running;
+    /** 输入序号按收到的行计数，与查看器发送的顺序一致 */
+    private long inputSeq;
 
     /** 客户端地址信息，用于日志和调试 */
     private final String clientAddress;
 
+    /** 所属连接，接收HELLO中声明的查看器能力并发送输入确认 */
+    private final StreamConnection connection;
+
     // CTCAndroidInput 反射相关字段
 
     /** receiveData方法反射对象，核心的输入事件分发方法 */
     private Method receiveDataMethod;
 
+    /** receiveText方法反射对象，用于整段文本一次性注入 */
+    private Method receiveTextMethod;
+
+    /** keyboardLocaleChanged方法反射对象，用于切换按键映射的键盘布局 */
+    private Method keyboardLocaleMethod;
+
     /** CTCAndroidInput是否可用的标志，初始化失败时禁用事件处理 */
     private boolean ctcAvailable = false;
 
@@ -59,15 +76,21 @@ public class ClientEventTask implements Runnable {
      * 初始化客户端连接信息并尝试加载CTCAndroidInput类
      * 如果CTCAndroidInput初始化失败，任务仍会运行但不会处理输入事件
      *
-     * @param clientSocket 客户端Socket连接，必须为非空且已连接的Socket
+     * @param clientAddress 客户端地址，用于日志输出
+     * @param connection 所属连接
      */
-    public ClientEventTask(Socket clientSocket) {
-        this.clientSocket = clientSocket;
-        this.clientAddress = clientSocket.getInetAddress().getHostAddress();
-        this.running = true;
+    ClientEventTask(String clientAddress, StreamConnection connection) {
+        this.connection = connection;
+        this.clientAddress = clientAddress;
 
         // 初始化CTCAndroidInput反射机制
         initializeCTCAndroidInput();
+
+        System.out.println("🎯 开始处理客户端事件: " + clientAddress);
+        System.out.println("📊 CTCAndroidInput 可用: " + ctcAvailable);
+        if (!ctcAvailable) {
+            System.err.println("⚠️  CTCAndroidInput不可用，事件处理将不会生效");
+        }
     }
 
     /**
@@ -87,6 +110,22 @@ public class ClientEventTask implements Runnable {
             receiveDataMethod = ctcAndroidInputClass.getMethod("receiveData",
                     int.class, int.class, int.class, int.class, int.class);
 
+            // 获取receiveText静态方法，旧版本Cacio没有该方法时退化为逐字符输入
+            try {
+                receiveTextMethod = ctcAndroidInputClass.getMethod("receiveText", String.class);
+            } catch (NoSuchMethodException e) {
+                System.err.println("⚠️  CTCAndroidInput.receiveText 方法未找到，文本提交将逐字符发送");
+                receiveTextMethod = null;
+            }
+
+            // 获取keyboardLocaleChanged静态方法，旧版本Cacio没有该方法时保持默认键盘布局
+            try {
+                keyboardLocaleMethod = ctcAndroidInputClass.getMethod("keyboardLocaleChanged", String.class);
+            } catch (NoSuchMethodException e) {
+                System.err.println("⚠️  CTCAndroidInput.keyboardLocaleChanged 方法未找到，键盘布局不随查看器切换");
+                keyboardLocaleMethod = null;
+            }
+
             ctcAvailable = true;
             System.out.println("✅ CTCAndroidInput 反射初始化成功");
 
@@ -103,39 +142,43 @@ public class ClientEventTask implements Runnable {
     }
 
     /**
-     * 事件处理任务主运行方法
+     * 处理从Socket读到的一段数据
      * <p>
-     * 创建输入流监听客户端发送的事件消息，持续处理直到连接断开或任务被停止
-     * 使用BufferedReader按行读取事件数据，确保事件处理的实时性和顺序性
-     * 自动管理资源释放，在任务结束时关闭输入流和Socket连接
+     * 数据可能在任意位置截断，按换行符切分出完整的事件消息依次处理，剩余的半行留到下一次读取
+     * 与BufferedReader.readLine一致，行尾的\r会被去掉
+     *
+     * @param data 刚读到的数据，处理后position移动到limit
      */
-    @Override
-    public void run() {
-        System.out.println("🎯 开始处理客户端事件: " + clientAddress);
-        System.out.println("📊 CTCAndroidInput 可用: " + ctcAvailable);
-
-        if (!ctcAvailable) {
-            System.err.println("⚠️  CTCAndroidInput不可用，事件处理将不会生效");
-        }
-
-        try (BufferedReader reader = new BufferedReader(
-                new InputStreamReader(clientSocket.getInputStream()))) {
-
-            String message;
-            // 持续读取事件消息，直到连接关闭或任务停止
-            while (running && (message = reader.readLine()) != null) {
-                processEvent(message);
+    void onInput(ByteBuffer data) {
+        while (data.hasRemaining()) {
+            byte b = data.get();
+            if (b != '\n') {
+                if (lineLength == lineBuffer.length) {
+                    lineBuffer = Arrays.copyOf(lineBuffer, lineBuffer.length * 2);
+                }
+                lineBuffer[lineLength++] = b;
+                continue;
             }
 
-        } catch (IOException e) {
-            if (running) {
-                System.err.println("❌ 读取客户端事件时出错: " + e.getMessage());
-            }
-        } finally {
-            System.out.println("🔌 客户端事件处理结束: " + clientAddress);
+            int length = lineLength > 0 && lineBuffer[lineLength - 1] == '\r' ? lineLength - 1 : lineLength;
+            String message = new String(lineBuffer, 0, length, StandardCharsets.UTF_8);
+            lineLength = 0;
+
+            long dispatchStart = System.nanoTime();
+            processEvent(message);
+            TraceRing.slice(TraceRing.AGENT_DISPATCH, dispatchStart,
+                    System.nanoTime() - dispatchStart, TraceRing.inputFlow(inputSeq));
+            connection.acknowledgeInput(inputSeq++);
         }
     }
 
+    /**
+     * 连接关闭时调用
+     */
+    void close() {
+        System.out.println("🔌 客户端事件处理结束: " + clientAddress);
+    }
+
     /**
      * 处理客户端发送的单个事件消息
      * <p>
@@ -146,6 +189,11 @@ public class ClientEventTask implements Runnable {
      * @param message 客户端发送的原始事件消息字符串
      */
     private void processEvent(String message) {
+        if (message.startsWith("HELLO|")) {
+            handleHello(message.split("\\|"));
+            return;
+        }
+
         if (!ctcAvailable) {
             // CTC不可用时只打印日志，不处理事件
             System.out.println("📝 收到事件(CTC不可用): " + message);
@@ -185,6 +233,12 @@ public class ClientEventTask implements Runnable {
                 case "CHAR_INPUT":
                     handleCharInput(parts);
                     break;
+                case "TEXT_COMMIT":
+                    handleTextCommit(parts);
+                    break;
+                case "KEYBOARD_LOCALE":
+                    handleKeyboardLocale(parts);
+                    break;
                 default:
                     System.err.println("⚠️  未知事件类型: " + eventType);
             }
@@ -194,6 +248,61 @@ public class ClientEventTask implements Runnable {
         }
     }
 
+    /**
+     * 处理查看器的能力声明
+     * <p>
+     * 事件格式: HELLO|cacheBytes[|features]
+     * 查看器读取握手信息后发送，声明分块缓存的内存预算，旧版查看器不发送，服务端继续发送整帧。
+     * features为逗号分隔的可选能力：jpeg（能解码照片类分块）、deflate=等级（跨帧deflate压缩）、
+     * ack（每条输入消息回复确认）、mux（通道复用，见{@link StreamConnection}）
+     *
+     * @param parts 分割后的事件参数数组，包含缓存预算
+     */
+    private void handleHello(String[] parts) {
+        if (parts.length < 2) {
+            System.err.println("⚠️  无效的HELLO格式");
+            return;
+        }
+
+        try {
+            long cacheBytes = Long.parseLong(parts[1]);
+            boolean jpeg = false;
+            int deflate = -1;
+            boolean ack = false;
+            boolean mux = false;
+            boolean resume = false;
+            long resumeToken = 0;
+            long resumeFrames = 0;
+            for (String feature : parts.length > 2 ? parts[2].split(",") : new String[0]) {
+                if (feature.equals("jpeg")) {
+                    jpeg = true;
+                } else if (feature.startsWith("deflate=")) {
+                    deflate = Integer.parseInt(feature.substring("deflate=".length()));
+                } else if (feature.equals("ack")) {
+                    ack = true;
+                } else if (feature.equals("mux")) {
+                    mux = true;
+                } else if (feature.equals("resume")) {
+                    resume = true;
+                } else if (feature.startsWith("resume=")) {
+                    // resume=令牌:已应用的帧数
+                    String[] point = feature.substring("resume=".length()).split(":");
+                    resume = true;
+                    resumeToken = Long.parseLong(point[0]);
+                    resumeFrames = point.length > 1 ? Long.parseLong(point[1]) : -1;
+                }
+            }
+            boolean resumed = connection.startSession(cacheBytes, jpeg, deflate, resume, resumeToken, resumeFrames);
+            connection.configureTransport(ack, mux);
+            System.out.println("🤝 查看器声明分块缓存: " + (cacheBytes / 1024) + " KB, JPEG: " + jpeg +
+                    ", deflate: " + (deflate < 0 ? "关闭" : String.valueOf(deflate)) +
+                    ", 输入确认: " + ack + ", 通道复用: " + mux +
+                    ", 会话: " + (resumed ? "已恢复" : resumeToken != 0 ? "令牌已过期，新建" : resume ? "新建" : "关闭"));
+        } catch (NumberFormatException e) {
+            System.err.println("❌ 缓存预算格式错误: " + e.getMessage());
+        }
+    }
+
     /**
      * 处理鼠标移动事件
      * <p>
@@ -374,6 +483,72 @@ public class ClientEventTask implements Runnable {
         }
     }
 
+    /**
+     * 处理整段文本提交事件
+     * <p>
+     * 事件格式: TEXT_COMMIT|base64(UTF-16BE文本)
+     * 整段文本通过一次receiveText调用注入焦点组件，避免逐字符的反射调用和按键模拟
+     * 日志中记录字符数和插入耗时，便于评估粘贴大段文本的响应时间
+     *
+     * @param parts 分割后的事件参数数组，包含编码后的文本
+     */
+    private void handleTextCommit(String[] parts) {
+        if (parts.length != 2) {
+            System.err.println("⚠️  无效的文本提交事件格式");
+            return;
+        }
+
+        String text;
+        try {
+            text = new String(Base64.getDecoder().decode(parts[1]), StandardCharsets.UTF_16BE);
+        } catch (IllegalArgumentException e) {
+            System.err.println("❌ 文本提交内容解码失败: " + e.getMessage());
+            return;
+        }
+
+        long startNanos = System.nanoTime();
+        if (receiveTextMethod != null) {
+            try {
+                receiveTextMethod.invoke(null, text);
+            } catch (Exception e) {
+                System.err.println("❌ 调用CTCAndroidInput.receiveText时出错: " + e.getMessage());
+                receiveTextMethod = null;
+                return;
+            }
+        } else {
+            for (int i = 0; i < text.length(); i++) {
+                invokeCTCReceiveData(EVENT_TYPE_CHAR, text.charAt(i), 0, 0, 0);
+            }
+        }
+        long elapsedMicros = (System.nanoTime() - startNanos) / 1000;
+        System.out.println("⌨️  文本提交: " + text.length() + " 个字符, 耗时 " + elapsedMicros + "μs");
+    }
+
+    /**
+     * 处理键盘区域切换事件
+     * <p>
+     * 事件格式: KEYBOARD_LOCALE|languageTag
+     * 查看器连接后和输入法语言变化时发送，服务端据此切换按键码到字符的映射（如德语键盘的Y/Z互换），
+     * 不发送时使用JVM默认区域对应的布局
+     *
+     * @param parts 分割后的事件参数数组，包含IETF语言标签
+     */
+    private void handleKeyboardLocale(String[] parts) {
+        if (parts.length != 2 || parts[1].isEmpty()) {
+            System.err.println("⚠️  无效的键盘区域事件格式");
+            return;
+        }
+        if (keyboardLocaleMethod == null) return;
+
+        try {
+            keyboardLocaleMethod.invoke(null, parts[1]);
+            System.out.println("🌐 键盘区域: " + parts[1]);
+        } catch (Exception e) {
+            System.err.println("❌ 调用CTCAndroidInput.keyboardLocaleChanged时出错: " + e.getMessage());
+            keyboardLocaleMethod = null;
+        }
+    }
+
     /**
      * 将标准鼠标按钮编号转换为CTC按钮编号
      * <p>
@@ -423,32 +598,6 @@ public class ClientEventTask implements Runnable {
         }
     }
 
-    /**
-     * 停止事件处理任务
-     * <p>
-     * 设置运行标志为false并关闭客户端Socket连接
-     * 用于优雅停止事件处理，确保资源正确释放
-     */
-    public void stop() {
-        running = false;
-        try {
-            if (!clientSocket.isClosed()) {
-                clientSocket.close();
-            }
-        } catch (IOException e) {
-            System.err.println("❌ 关闭客户端socket时出错: " + e.getMessage());
-        }
-    }
-
-    /**
-     * 检查任务是否正在运行
-     *
-     * @return true表示任务正在运行，false表示任务已停止
-     */
-    public boolean isRunning() {
-        return running;
-    }
-
     /**
      * 检查CTCAndroidInput功能是否可用
      *
@@ -0,0 +1,68 @@
+package io.github.eurya.cacio;
+
+import java.util.Arrays;
+import java.util.zip.Deflater;
+
+/**
+ * 跨帧的持久化deflate压缩
+ * <p>
+ * 每个连接使用一个长期存在的Deflater，每帧以SYNC_FLUSH结束：查看器收到整帧后即可完整解压，
+ * 而LZ77窗口（32KB）和Huffman统计跨帧保留，重复出现的内容可以引用之前帧中的数据
+ * <p>
+ * 压缩作用于编码后的帧数据，与分块、填充、缓存等编码叠加使用。压缩帧的格式名加{@link #PREFIX}前缀，
+ * 长度int之后多一个解压后长度int，查看器端的FrameStreamReader据此用同一个Inflater解压
+ */
+final class FrameDeflater {
+
+    /** 压缩帧格式名的前缀 */
+    static final String PREFIX = "Z:";
+
+    private final Deflater deflater;
+
+    private byte[] buffer = new byte[64 * 1024];
+
+    private long inputBytes;
+    private long outputBytes;
+
+    /**
+     * @param level 压缩等级，0-9
+     */
+    FrameDeflater(int level) {
+        this.deflater = new Deflater(Math.max(Deflater.NO_COMPRESSION, Math.min(Deflater.BEST_COMPRESSION, level)));
+    }
+
+    /**
+     * 压缩一帧数据
+     *
+     * @param data 编码后的帧数据
+     * @return 压缩后的长度，数据在{@link #getBuffer()}的前若干字节，下一次调用前有效
+     */
+    int compress(byte[] data) {
+        deflater.setInput(data);
+        int size = 0;
+        while (true) {
+            size += deflater.deflate(buffer, size, buffer.length - size, Deflater.SYNC_FLUSH);
+            // 输出缓冲区没有写满说明本次刷新已经完成
+            if (size < buffer.length) break;
+            buffer = Arrays.copyOf(buffer, buffer.length * 2);
+        }
+        inputBytes += data.length;
+        outputBytes += size;
+        return size;
+    }
+
+    /** 压缩结果缓冲区 */
+    byte[] getBuffer() {
+        return buffer;
+    }
+
+    /** 压缩率（输出/输入），尚无数据时为1 */
+    double getRatio() {
+        return inputBytes == 0 ? 1.0 : outputBytes / (double) inputBytes;
+    }
+
+    /** 释放本地压缩状态 */
+    void end() {
+        deflater.end();
+    }
+}
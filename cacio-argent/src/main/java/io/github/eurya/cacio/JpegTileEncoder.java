@@ -0,0 +1,86 @@
+package io.github.eurya.cacio;
+
+import javax.imageio.IIOImage;
+import javax.imageio.ImageIO;
+import javax.imageio.ImageWriteParam;
+import javax.imageio.ImageWriter;
+import javax.imageio.stream.ImageOutputStream;
+import javax.imageio.stream.MemoryCacheImageOutputStream;
+import java.awt.image.BufferedImage;
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.util.Iterator;
+
+/**
+ * 照片类分块的有损编码器
+ * <p>
+ * 使用JRE自带的ImageIO JPEG编码器（原生libjpeg实现的8x8 DCT、量化和Huffman编码）压缩单个块，
+ * 查看器端由Android BitmapFactory（libjpeg-turbo，带NEON加速）或主机端ImageIO解码
+ * <p>
+ * 块的颜色数和边缘统计由{@link TileFrameEncoder}判断，只有照片类内容才会走到这里，文本和界面元素始终无损。
+ * JPEG不保存透明通道，因此只接受完全不透明的块
+ */
+final class JpegTileEncoder {
+
+    private final ImageWriter writer;
+    private final ImageWriteParam param;
+    private final ByteArrayOutputStream output = new ByteArrayOutputStream(8 * 1024);
+
+    /** 完整块复用的图像，边缘块按实际尺寸临时创建 */
+    private final BufferedImage tileImage =
+            new BufferedImage(TileFrameEncoder.TILE_SIZE, TileFrameEncoder.TILE_SIZE, BufferedImage.TYPE_INT_RGB);
+
+    private JpegTileEncoder(ImageWriter writer) {
+        this.writer = writer;
+        this.param = writer.getDefaultWriteParam();
+        this.param.setCompressionMode(ImageWriteParam.MODE_EXPLICIT);
+    }
+
+    /**
+     * 创建编码器
+     *
+     * @return 编码器，当前JRE没有JPEG编码器时返回null，此时所有块都按无损方式发送
+     */
+    static JpegTileEncoder create() {
+        try {
+            Iterator<ImageWriter> writers = ImageIO.getImageWritersByFormatName("jpeg");
+            if (writers.hasNext()) {
+                return new JpegTileEncoder(writers.next());
+            }
+            System.err.println("⚠️  未找到JPEG编码器，照片类分块将按无损方式发送");
+        } catch (Throwable e) {
+            System.err.println("⚠️  初始化JPEG编码器失败: " + e.getMessage());
+        }
+        return null;
+    }
+
+    /**
+     * 编码一个块
+     *
+     * @param rgbData 整屏ARGB像素
+     * @param stride 整屏宽度
+     * @param x 块左上角横坐标
+     * @param y 块左上角纵坐标
+     * @param w 块宽度
+     * @param h 块高度
+     * @param quality JPEG质量，1-100
+     * @return JPEG数据
+     * @throws IOException 当编码失败时抛出
+     */
+    byte[] encode(int[] rgbData, int stride, int x, int y, int w, int h, int quality) throws IOException {
+        BufferedImage image = w == tileImage.getWidth() && h == tileImage.getHeight()
+                ? tileImage
+                : new BufferedImage(w, h, BufferedImage.TYPE_INT_RGB);
+        image.setRGB(0, 0, w, h, rgbData, y * stride + x, stride);
+
+        param.setCompressionQuality(quality / 100f);
+        output.reset();
+        try (ImageOutputStream stream = new MemoryCacheImageOutputStream(output)) {
+            writer.setOutput(stream);
+            writer.write(null, new IIOImage(image, null, null), param);
+        } finally {
+            writer.setOutput(null);
+        }
+        return output.toByteArray();
+    }
+}
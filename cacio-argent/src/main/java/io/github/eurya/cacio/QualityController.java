@@ -0,0 +1,98 @@
+package io.github.eurya.cacio;
+
+/**
+ * 有损编码质量的自适应控制器
+ * <p>
+ * 以每帧写入并刷新Socket的耗时作为带宽信号：发送缓冲区写满时write会阻塞，
+ * 发送耗时超过帧间隔的一半说明链路跟不上，立即降低质量；连续一段时间发送耗时都很短时再逐步提高质量。
+ * 快降慢升，避免在带宽边界上来回振荡
+ * <p>
+ * 控制照片类分块的JPEG质量，以及渐进模式下是否把其余块降级为RGB565：
+ * 大面积变化（拖动、滚动）或质量已被压低时先发降级内容，画面稳定后由编码器补发完整内容
+ * <p>
+ * 低于{@link #MAX_QUALITY}的JPEG块也是降级内容：画面稳定后编码器以{@link #MAX_QUALITY}重新发送，并且只缓存最高质量的版本
+ */
+final class QualityController {
+
+    /** 最低质量，再低时块效应过于明显 */
+    static final int MIN_QUALITY = 30;
+
+    /** 最高质量，更高的质量对观感提升很小但数据量增长很快 */
+    static final int MAX_QUALITY = 85;
+
+    /** 初始质量 */
+    static final int INITIAL_QUALITY = 70;
+
+    /** 每次降低的幅度 */
+    private static final int DECREASE_STEP = 10;
+
+    /** 每次提高的幅度 */
+    private static final int INCREASE_STEP = 5;
+
+    /** 连续多少帧发送顺畅后提高一次质量 */
+    private static final int CALM_FRAMES = 30;
+
+    /** 变化块占比达到此比例（分母）时视为大面积变化 */
+    private static final int HEAVY_DAMAGE_DIVISOR = 4;
+
+    /** 降级块稳定多久后补发完整内容（纳秒） */
+    static final long REFINE_DELAY_NANOS = 150_000_000L;
+
+    /** 每帧最多细化的块数，避免细化本身占满链路 */
+    static final int REFINE_TILES_PER_FRAME = 32;
+
+    /** 每帧的时间预算（纳秒） */
+    private final long frameBudgetNanos;
+
+    private int quality = INITIAL_QUALITY;
+
+    private int calmFrames;
+
+    /**
+     * @param frameRate 目标帧率
+     */
+    QualityController(int frameRate) {
+        this.frameBudgetNanos = 1_000_000_000L / Math.max(1, frameRate);
+    }
+
+    /**
+     * 当前的JPEG质量
+     *
+     * @return 质量，范围[{@link #MIN_QUALITY}, {@link #MAX_QUALITY}]
+     */
+    int getQuality() {
+        return quality;
+    }
+
+    /**
+     * 根据一帧的发送耗时调整质量
+     *
+     * @param sendNanos 写入并刷新Socket的耗时（纳秒）
+     */
+    void onFrameSent(long sendNanos) {
+        if (sendNanos > frameBudgetNanos / 2) {
+            quality = Math.max(MIN_QUALITY, quality - DECREASE_STEP);
+            calmFrames = 0;
+        } else if (sendNanos < frameBudgetNanos / 5) {
+            if (++calmFrames >= CALM_FRAMES) {
+                quality = Math.min(MAX_QUALITY, quality + INCREASE_STEP);
+                calmFrames = 0;
+            }
+        } else {
+            calmFrames = 0;
+        }
+    }
+
+    /**
+     * 根据一帧的变化面积判断是否降级发送
+     * <p>
+     * 变化块达到总数的1/{@link #HEAVY_DAMAGE_DIVISOR}，或链路拥塞使质量低于初始值时降级
+     *
+     * @param changedTiles 本帧变化的块数
+     * @param totalTiles 总块数
+     * @return 本帧是否降级
+     */
+    boolean onDamage(int changedTiles, int totalTiles) {
+        return changedTiles * HEAVY_DAMAGE_DIVISOR >= totalTiles || quality < INITIAL_QUALITY;
+    }
+}
@@ -1,194 +1,265 @@
 package io.github.eurya.cacio;
 
+import java.io.ByteArrayOutputStream;
 import java.io.DataOutputStream;
 import java.io.IOException;
-import java.net.Socket;
-import java.util.concurrent.atomic.AtomicBoolean;
+import java.nio.ByteBuffer;
 
 /**
- * 屏幕捕获和传输任务
- * <p> <p>
- * 负责从CTCScreen捕获屏幕数据并通过网络传输给远程客户端
- * 支持多种像素格式转换、帧率控制、数据压缩和实时性能统计
- * 使用原子布尔值确保线程安全的启停控制，提供完整的传输生命周期管理
+ * 单个客户端的屏幕帧编码任务
+ * <p>
+ * 保存一个连接的编码状态（像素格式、分块缓存、deflate窗口、质量控制），把共享的屏幕捕获结果编码为该连接的帧消息。
+ * 捕获、编码和发送不再由每个连接的独立线程完成：{@link ScreenStreamServer}的帧线程每帧只捕获一次，
+ * 依次为各连接调用{@link #encodeFrame}，编码结果交给{@link StreamConnection}的写队列，由选择器线程非阻塞写出
  * <p>
  * 主要功能：
- * - 实时屏幕数据捕获和格式转换
- * - 自适应帧率控制和带宽管理
- * - 多格式像素编码支持
+ * - 握手信息和帧消息的编码
+ * - 多格式像素编码和分块缓存编码
+ * - 按发送耗时调整有损编码质量
  * - 传输统计和性能监控
- * - 优雅的连接管理和错误处理
  */
-public class ScreenCaptureTask implements Runnable {
-    /** 客户端Socket连接，用于数据传输 */
-    private final Socket clientSocket;
+public class ScreenCaptureTask {
+    /** 客户端标识，用于日志输出 */
+    private final String clientInfo;
 
-    /** 屏幕数据包装器，提供屏幕捕获功能 */
+    /** 屏幕数据包装器，提供屏幕尺寸和缩放信息 */
     private final CTCScreenWrapper screenWrapper;
 
-    /** 线程安全的运行状态控制标志 */
-    private final AtomicBoolean running;
-
-    /** 目标传输帧率，控制数据更新频率 */
-    private final int frameRate;
-
-    /** 累计传输帧数统计 */
+    /** 累计传输帧数统计，同时是下一帧的帧序号 */
     private long frameCount = 0;
 
     /** 累计传输数据量统计（字节） */
     private long totalDataBytes = 0;
 
+    /** 查看器在HELLO中声明的分块缓存预算（字节），-1表示尚未声明，仍发送整帧 */
+    private volatile long tileCacheBytes = -1;
+
+    /** 查看器是否能解码JPEG分块 */
+    private volatile boolean photoCodec;
+
+    /** 查看器请求的deflate压缩等级，-1表示不压缩 */
+    private volatile int deflateLevel = -1;
+
+    /** 分块编码器，收到HELLO后的第一帧创建 */
+    private TileFrameEncoder tileEncoder;
+
+    /** 跨帧的deflate压缩器，收到HELLO后的第一帧创建 */
+    private FrameDeflater frameDeflater;
+
+    /** 照片类分块的质量控制器 */
+    private final QualityController qualityController;
+
     /** 传输开始时间戳，用于性能计算 */
     private final long startTime = System.currentTimeMillis();
 
     /**
-     * 屏幕捕获任务构造函数
+     * 屏幕帧编码任务构造函数
      *
-     * @param clientSocket 客户端Socket连接，必须为非空且已连接的Socket
-     * @param screenWrapper 屏幕数据包装器实例，负责屏幕数据捕获
-     * @param frameRate 目标传输帧率，控制数据更新频率（帧/秒）
+     * @param clientInfo 客户端标识，用于日志输出
+     * @param screenWrapper 屏幕数据包装器实例
+     * @param frameRate 目标传输帧率，质量控制器据此计算每帧的时间预算（帧/秒）
      */
-    public ScreenCaptureTask(Socket clientSocket, CTCScreenWrapper screenWrapper, int frameRate) {
-        this.clientSocket = clientSocket;
+    public ScreenCaptureTask(String clientInfo, CTCScreenWrapper screenWrapper, int frameRate) {
+        this.clientInfo = clientInfo;
         this.screenWrapper = screenWrapper;
-        this.running = new AtomicBoolean(true);
-        this.frameRate = frameRate;
-    }
-
-    /**
-     * 屏幕捕获和传输任务主运行方法
-     * <p>
-     * 建立数据传输流，发送屏幕信息头，然后进入连续的帧捕获和传输循环
-     * 自动管理帧率控制、错误处理和资源释放，确保传输的稳定性和可靠性
-     * 提供详细的运行日志和性能统计信息
-     */
-    @Override
-    public void run() {
-        String clientInfo = clientSocket.getInetAddress() + ":" + clientSocket.getPort();
+        this.qualityController = new QualityController(frameRate);
         System.out.println("🎬 开始为客户端 " + clientInfo + " 传输屏幕数据");
         System.out.println("📊 数据源: " + (screenWrapper.isCacioAvailable() ? "真实CTCScreen" : "模拟数据"));
-
-        try (DataOutputStream dos = new DataOutputStream(clientSocket.getOutputStream())) {
-            sendScreenInfo(dos);
-
-            while (running.get() && !clientSocket.isClosed()) {
-                long frameStartTime = System.currentTimeMillis();
-
-                if (captureAndSendFrame(dos)) {
-                    frameCount++;
-                }
-
-                controlFrameRate(frameStartTime);
-
-                printStatistics(clientInfo);
-            }
-        } catch (IOException e) {
-            System.err.println("❌ 客户端 " + clientInfo + " 连接错误: " + e.getMessage());
-        } finally {
-            stop();
-            printFinalStatistics(clientInfo);
-        }
     }
 
     /**
-     * 发送屏幕基本信息到客户端
+     * 编码屏幕基本信息
      * <p>
-     * 传输屏幕尺寸、数据源类型等元数据，客户端使用这些信息初始化显示环境
-     * 这是数据传输开始前的握手过程，确保双方对传输参数达成一致
+     * 传输屏幕尺寸（设备像素）、数据源类型和UI缩放比例等元数据，客户端使用这些信息初始化显示环境
+     * 这是数据传输开始前的握手过程，连接建立后第一个进入写队列
      *
-     * @param dos 数据输出流，用于向客户端发送数据
-     * @throws IOException 当网络传输失败时抛出
+     * @return 握手消息
      */
-    private void sendScreenInfo(DataOutputStream dos) throws IOException {
-        dos.writeInt(screenWrapper.getScreenWidth());
-        dos.writeInt(screenWrapper.getScreenHeight());
-        dos.writeBoolean(screenWrapper.isCacioAvailable());
-        dos.flush();
+    ByteBuffer encodeScreenInfo() {
+        MessageBuffer buffer = new MessageBuffer(16);
+        try (DataOutputStream dos = new DataOutputStream(buffer)) {
+            dos.writeInt(screenWrapper.getScreenWidth());
+            dos.writeInt(screenWrapper.getScreenHeight());
+            dos.writeBoolean(screenWrapper.isCacioAvailable());
+            dos.writeFloat((float) screenWrapper.getUIScale());
+        } catch (IOException e) {
+            throw new IllegalStateException(e); // 内存流不会抛出
+        }
         System.out.println("📤 发送屏幕信息: " + screenWrapper.getScreenWidth() +
                 "x" + screenWrapper.getScreenHeight() +
+                ", 缩放: " + screenWrapper.getUIScale() +
                 ", 数据源: " + (screenWrapper.isCacioAvailable() ? "真实" : "模拟"));
+        return buffer.toByteBuffer();
     }
 
     /**
-     * 捕获并发送单帧屏幕数据
+     * 编码一帧
      * <p>
-     * 从屏幕包装器获取当前屏幕数据，验证数据完整性，转换为指定格式后传输
-     * 自动处理数据尺寸不匹配等异常情况，确保传输的连续性
+     * 查看器声明分块缓存能力后发送分块帧，否则按ARGB发送整帧。
+     * 返回的消息包含格式名、长度和帧数据，可直接写入Socket
      *
-     * @param dos 数据输出流，用于发送帧数据
-     * @return true表示成功发送一帧，false表示发送失败
-     * @throws IOException 当数据传输失败时抛出
+     * @param rgbData 本帧共享的屏幕像素，长度为宽x高，调用方不得在编码期间修改
+     * @param captureNanos 本帧的捕获耗时（纳秒），计入统计和追踪
+     * @return 帧消息
      */
-    private boolean captureAndSendFrame(DataOutputStream dos) throws IOException {
-        return captureAndSendFrame(dos, PixelFormat.ARGB);
+    ByteBuffer encodeFrame(int[] rgbData, long captureNanos) {
+        return encodeFrame(rgbData, captureNanos, PixelFormat.ARGB);
     }
 
     /**
-     * 捕获并发送指定格式的单帧屏幕数据
+     * 编码指定格式的一帧
      * <p>
      * 支持多种像素格式选择，根据网络条件和客户端能力选择最优格式
-     * 包含完整的数据验证、格式转换和错误处理机制
+     * 查看器声明分块缓存能力后改为发送分块帧，此时format不再使用
      *
-     * @param dos 数据输出流，用于发送帧数据
+     * @param rgbData 本帧共享的屏幕像素
+     * @param captureNanos 本帧的捕获耗时（纳秒）
      * @param format 像素格式枚举，指定数据编码方式
-     * @return true表示成功发送一帧，false表示发送失败
-     * @throws IOException 当数据传输失败时抛出
+     * @return 帧消息
      */
-    private boolean captureAndSendFrame(DataOutputStream dos, PixelFormat format) throws IOException {
-        int[] rgbData = screenWrapper.getScreenRGBData();
-
-        if (rgbData == null || rgbData.length == 0) {
-            System.err.println("⚠️  获取到空的屏幕数据");
-            dos.writeInt(0); // 发送空数据标记
-            dos.flush();
-            return false;
+    private ByteBuffer encodeFrame(int[] rgbData, long captureNanos, PixelFormat format) {
+        long encodeStart = System.nanoTime();
+        TileFrameEncoder encoder = tileEncoder();
+        String formatName;
+        byte[] pixelBytes;
+        if (encoder != null) {
+            formatName = TileFrameEncoder.FORMAT;
+            pixelBytes = encoder.encode(rgbData);
+            StreamStats.recordTiles(encoder);
+        } else {
+            formatName = format.name();
+            pixelBytes = convertRGBToBytes(rgbData, format);
         }
 
-        int expectedSize = screenWrapper.getScreenWidth() * screenWrapper.getScreenHeight();
-        if (rgbData.length != expectedSize) {
-            System.err.println("⚠️  屏幕数据尺寸不匹配: 期望=" + expectedSize + ", 实际=" + rgbData.length);
-            int[] correctedData = new int[expectedSize];
-            System.arraycopy(rgbData, 0, correctedData, 0, Math.min(rgbData.length, expectedSize));
-            rgbData = correctedData;
+        FrameDeflater deflater = encoder != null ? frameDeflater() : null;
+        int frameBytes = pixelBytes == null ? 0 : pixelBytes.length;
+        if (deflater != null && pixelBytes != null) {
+            long deflateStart = System.nanoTime();
+            frameBytes = deflater.compress(pixelBytes);
+            StreamStats.recordDeflate(pixelBytes.length, frameBytes, System.nanoTime() - deflateStart);
         }
 
-        try {
-            byte[] pixelBytes = convertRGBToBytes(rgbData, format);
-
-            dos.writeUTF(format.name());
-            dos.writeInt(pixelBytes.length);
-            dos.write(pixelBytes);
-            dos.flush();
+        MessageBuffer buffer = new MessageBuffer(frameBytes + 32);
+        try (DataOutputStream dos = new DataOutputStream(buffer)) {
+            if (pixelBytes == null) {
+                dos.writeUTF(formatName);
+                dos.writeInt(-1); // 没有块变化
+            } else if (deflater != null) {
+                dos.writeUTF(FrameDeflater.PREFIX + formatName);
+                dos.writeInt(frameBytes);
+                dos.writeInt(pixelBytes.length);
+                dos.write(deflater.getBuffer(), 0, frameBytes);
+            } else {
+                dos.writeUTF(formatName);
+                dos.writeInt(pixelBytes.length);
+                dos.write(pixelBytes);
+            }
+        } catch (IOException e) {
+            throw new IllegalStateException(e); // 内存流不会抛出
+        }
 
-            totalDataBytes += pixelBytes.length;
-            return true;
+        long encodeEnd = System.nanoTime();
+        StreamStats.recordFrame(captureNanos, encodeEnd - encodeStart, frameBytes);
+
+        // 帧序号即已发送的帧头数，查看器按同样的顺序计数
+        long flow = TraceRing.frameFlow(frameCount);
+        TraceRing.slice(TraceRing.AGENT_CAPTURE, encodeStart - captureNanos, captureNanos, flow);
+        TraceRing.slice(TraceRing.AGENT_ENCODE, encodeStart, encodeEnd - encodeStart, flow);
+        totalDataBytes += frameBytes;
+        frameCount++;
+        printStatistics();
+        return buffer.toByteBuffer();
+    }
 
-        } catch (IOException e) {
-            System.err.println("❌ 发送帧数据失败: " + e.getMessage());
-            throw e;
+    /**
+     * 记录上一帧从进入写队列到完全写出的耗时
+     * <p>
+     * 由帧线程在编码下一帧之前调用，发送缓冲区写满时这段时间会变长，质量控制器据此调整有损编码质量
+     *
+     * @param sendNanos 发送耗时（纳秒）
+     */
+    void onFrameSent(long sendNanos) {
+        if (tileEncoder != null) {
+            qualityController.onFrameSent(sendNanos);
         }
     }
 
     /**
-     * 精确控制传输帧率
+     * 已编码的帧数，即下一帧的帧序号
+     *
+     * @return 帧数
+     */
+    long getFrameCount() {
+        return frameCount;
+    }
+
+    /**
+     * 启用分块缓存编码
      * <p>
-     * 根据目标帧率计算每帧的理想处理时间，通过睡眠补偿确保稳定的帧率输出
-     * 防止因处理速度过快导致的CPU资源浪费和网络拥塞
+     * 由同一连接的ClientEventTask在收到HELLO时调用，从下一帧开始改为发送{@link TileFrameEncoder#FORMAT}分块帧。
+     * 第一帧分块帧包含所有块，查看器此前收到的整帧不影响结果
      *
-     * @param frameStartTime 当前帧开始处理的时间戳
+     * @param cacheBytes 查看器的缓存预算（字节），0表示只做变化检测不缓存
+     * @param jpeg 查看器是否能解码JPEG分块，为true时照片类内容改为有损压缩
+     * @param deflate 跨帧deflate压缩等级，-1表示不压缩，见{@link FrameDeflater}
      */
-    private void controlFrameRate(long frameStartTime) {
-        long frameTime = System.currentTimeMillis() - frameStartTime;
-        long targetFrameTime = 1000 / frameRate;
-
-        if (frameTime < targetFrameTime) {
-            try {
-                Thread.sleep(targetFrameTime - frameTime);
-            } catch (InterruptedException e) {
-                Thread.currentThread().interrupt();
-                running.set(false);
-            }
+    void enableTileCache(long cacheBytes, boolean jpeg, int deflate) {
+        photoCodec = jpeg;
+        deflateLevel = deflate;
+        tileCacheBytes = Math.max(0, cacheBytes);
+    }
+
+    /**
+     * 由新连接接管暂存的编码任务
+     * <p>
+     * 由新连接的ClientEventTask在收到带会话令牌的HELLO时调用，此时任务已从{@link SessionRegistry}取出，不会被其他线程使用。
+     * 查看器已应用的帧数与已编码的帧数一致时，查看器的画面和缓存槽位与分块编码器的状态相同，之后只发送变化的块；
+     * 不一致（断开时还有帧未送达）或能力变化时丢弃分块编码器，下一帧重新发送所有块。
+     * 新连接的查看器从新的Inflater开始解压，因此deflate流总是重新开始
+     *
+     * @param cacheBytes 查看器的缓存预算（字节）
+     * @param jpeg 查看器是否能解码JPEG分块
+     * @param deflate 跨帧deflate压缩等级，-1表示不压缩
+     * @param viewerFrames 查看器已应用的帧数
+     */
+    void resume(long cacheBytes, boolean jpeg, int deflate, long viewerFrames) {
+        boolean intact = tileEncoder != null && viewerFrames == frameCount
+                && Math.max(0, cacheBytes) == tileCacheBytes && jpeg == photoCodec;
+        if (!intact) {
+            tileEncoder = null;
+        }
+        if (frameDeflater != null) {
+            frameDeflater.end();
+            frameDeflater = null;
+        }
+        enableTileCache(cacheBytes, jpeg, deflate);
+        System.out.println("♻️  客户端 " + clientInfo + " 恢复会话，帧序号: " + frameCount +
+                (intact ? "，只发送变化的块" : "，查看器画面不一致（已应用" + viewerFrames + "帧），重新发送所有块"));
+    }
+
+    /** 获取分块编码器，查看器尚未声明能力时返回null */
+    private TileFrameEncoder tileEncoder() {
+        long cacheBytes = tileCacheBytes;
+        if (cacheBytes < 0) return null;
+        if (tileEncoder == null) {
+            JpegTileEncoder jpegEncoder = photoCodec ? JpegTileEncoder.create() : null;
+            tileEncoder = new TileFrameEncoder(screenWrapper.getScreenWidth(), screenWrapper.getScreenHeight(),
+                    cacheBytes, jpegEncoder, qualityController);
+            System.out.println("🧩 启用分块缓存编码，缓存槽位: " + TileFrameEncoder.slotCount(cacheBytes) +
+                    ", 照片压缩: " + (jpegEncoder != null ? "JPEG" : "关闭"));
         }
+        return tileEncoder;
+    }
+
+    /** 获取deflate压缩器，查看器未请求压缩时返回null */
+    private FrameDeflater frameDeflater() {
+        int level = deflateLevel;
+        if (level < 0) return null;
+        if (frameDeflater == null) {
+            frameDeflater = new FrameDeflater(level);
+            System.out.println("🗜️  启用跨帧deflate压缩，等级: " + level);
+        }
+        return frameDeflater;
     }
 
     /**
@@ -196,10 +267,8 @@ public class ScreenCaptureTask implements Runnable {
      * <p>
      * 每60帧输出一次实时性能指标，包括帧率、数据速率等关键参数
      * 帮助监控传输质量和诊断性能问题
-     *
-     * @param clientInfo 客户端标识信息，用于日志输出
      */
-    private void printStatistics(String clientInfo) {
+    private void printStatistics() {
         if (frameCount % 60 == 0) {
             long currentTime = System.currentTimeMillis();
             long elapsedSeconds = (currentTime - startTime) / 1000;
@@ -216,14 +285,17 @@ public class ScreenCaptureTask implements Runnable {
     }
 
     /**
-     * 打印最终传输统计信息
+     * 结束编码任务
      * <p>
-     * 在传输任务结束时输出完整的性能摘要，包括总帧数、平均帧率、总数据量等
-     * 用于性能分析和传输质量评估
-     *
-     * @param clientInfo 客户端标识信息，用于日志输出
+     * 连接关闭后由选择器线程调用，释放deflate的本地状态并输出完整的性能摘要，
+     * 包括总帧数、平均帧率、总数据量等
      */
-    private void printFinalStatistics(String clientInfo) {
+    void close() {
+        if (frameDeflater != null) {
+            System.out.printf("🗜️  客户端 %s deflate压缩率: %.1f%%%n", clientInfo, frameDeflater.getRatio() * 100);
+            frameDeflater.end();
+        }
+
         long endTime = System.currentTimeMillis();
         long totalTimeSeconds = (endTime - startTime) / 1000;
 
@@ -241,30 +313,15 @@ public class ScreenCaptureTask implements Runnable {
         }
     }
 
-    /**
-     * 停止屏幕捕获和传输任务
-     * <p>
-     * 设置运行标志为false并关闭客户端连接，确保资源的正确释放
-     * 支持优雅停止，避免数据传输中断导致的客户端异常
-     */
-    public void stop() {
-        running.set(false);
-        try {
-            if (!clientSocket.isClosed()) {
-                clientSocket.close();
-            }
-        } catch (IOException e) {
-            System.err.println("❌ 关闭客户端socket时出错: " + e.getMessage());
+    /** 可以直接包装内部数组的字节流，避免编码完成后再复制一次帧数据 */
+    private static final class MessageBuffer extends ByteArrayOutputStream {
+        MessageBuffer(int size) {
+            super(size);
         }
-    }
 
-    /**
-     * 检查任务是否正在运行
-     *
-     * @return true表示任务正在运行，false表示任务已停止
-     */
-    public boolean isRunning() {
-        return running.get();
+        ByteBuffer toByteBuffer() {
+            return ByteBuffer.wrap(buf, 0, count);
+        }
     }
 
     /**
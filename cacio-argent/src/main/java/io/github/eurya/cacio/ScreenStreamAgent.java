@@ -1,7 +1,8 @@
 package io.github.eurya.cacio;
 
 import java.lang.instrument.Instrumentation;
-import java.lang.reflect.Method;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
 import java.util.concurrent.atomic.AtomicBoolean;
 
 /**
@@ -10,15 +11,24 @@ import java.util.concurrent.atomic.AtomicBoolean;
  * 通过Java Agent机制在AWT/Swing应用程序启动时自动注入屏幕流服务器功能
  * 支持静态加载（premain）和动态附加（agentmain）两种部署方式，提供零代码侵入式的远程桌面服务
  * 自动解析配置参数、启动流媒体服务器并管理完整的服务生命周期
+ * <p>
+ * premain只安排服务器在后台线程启动，不等待其完成，应用程序的main不会因Agent而推迟。
+ * 服务器就绪（或启动失败）时释放{@link #awaitServerReady}的等待，并输出日志和追踪事件
  */
 public class ScreenStreamAgent {
 
     /** 服务器启动状态原子标记，确保线程安全的启动控制 */
     private static final AtomicBoolean started = new AtomicBoolean(false);
 
-    /** 服务器线程引用，用于生命周期管理 */
+    /** 启动服务器的后台线程 */
     private static Thread serverThread;
 
+    /** 已启动的服务器，启动完成前为null */
+    private static volatile ScreenStreamServer server;
+
+    /** 服务器启动结束（成功或失败）时释放 */
+    private static final CountDownLatch ready = new CountDownLatch(1);
+
     /**
      * JVM启动时Agent预加载方法
      * <p>
@@ -34,6 +44,12 @@ public class ScreenStreamAgent {
 
         AgentConfig config = parseAgentArgs(agentArgs);
 
+        TraceRing.open(config.traceFd);
+
+        if (config.classLoadProbe) {
+            BootClassLoadProbe.install(inst);
+        }
+
         startScreenStreamServer(config);
 
         addShutdownHook();
@@ -61,7 +77,7 @@ public class ScreenStreamAgent {
      * 将逗号分隔的键值对字符串转换为结构化的配置对象
      * 支持端口、帧率、屏幕尺寸和自动启动等核心参数的配置
      *
-     * @param agentArgs 代理参数字符串，格式："port=8888,fps=60,width=1280,height=720,autostart=true"
+     * @param agentArgs 代理参数字符串，格式："port=8888,fps=60,width=1280,height=720,autostart=true,trace=42,classprobe=false"
      * @return 解析后的AgentConfig配置对象，包含所有有效参数
      */
     private static AgentConfig parseAgentArgs(String agentArgs) {
@@ -91,6 +107,12 @@ public class ScreenStreamAgent {
                         case "autostart":
                             config.autoStart = Boolean.parseBoolean(value);
                             break;
+                        case "trace":
+                            config.traceFd = Integer.parseInt(value);
+                            break;
+                        case "classprobe":
+                            config.classLoadProbe = Boolean.parseBoolean(value);
+                            break;
                     }
                 }
             }
@@ -102,14 +124,16 @@ public class ScreenStreamAgent {
     /**
      * 启动屏幕流媒体服务器
      * <p>
-     * 使用反射机制动态加载和初始化屏幕流服务器组件，避免编译时依赖
-     * 支持配置验证、重复启动保护和异步服务启动
+     * 在后台线程中创建屏幕包装器和服务器并开始监听，调用方立即返回，不等待监听完成
+     * 服务器与Agent在同一个jar中，直接构造即可；Cacio本身仍由CTCScreenWrapper通过反射访问
+     * 支持配置验证和重复启动保护
      *
      * @param config 屏幕流服务器配置参数
      */
     private static void startScreenStreamServer(AgentConfig config) {
         if (!config.autoStart) {
             System.out.println("⏸️  自动启动已禁用，屏幕流服务器未启动");
+            ready.countDown();
             return;
         }
 
@@ -118,6 +142,7 @@ public class ScreenStreamAgent {
             return;
         }
 
+        long scheduledAt = System.nanoTime();
         serverThread = new Thread(() -> {
             try {
                 System.out.println("🖥️  启动屏幕流服务器...");
@@ -125,40 +150,35 @@ public class ScreenStreamAgent {
                         ", 帧率=" + config.frameRate + "FPS" +
                         ", 屏幕尺寸=" + config.screenWidth + "x" + config.screenHeight);
 
-                ClassLoader classLoader = ScreenStreamAgent.class.getClassLoader();
-                Class<?> serverClass = classLoader.loadClass("io.github.eurya.cacio.ScreenStreamServer");
-                Class<?> wrapperClass = classLoader.loadClass("io.github.eurya.cacio.CTCScreenWrapper");
-
-                Object screenWrapper = wrapperClass.newInstance();
-
+                CTCScreenWrapper screenWrapper = new CTCScreenWrapper();
                 if (config.screenWidth > 0 && config.screenHeight > 0) {
-                    Method setSizeMethod = wrapperClass.getMethod("setScreenSize", int.class, int.class);
-                    setSizeMethod.invoke(screenWrapper, config.screenWidth, config.screenHeight);
+                    screenWrapper.setScreenSize(config.screenWidth, config.screenHeight);
                 }
 
-                Object server = serverClass.getConstructor(wrapperClass, int.class, int.class)
-                        .newInstance(screenWrapper, config.port, config.frameRate);
+                ScreenStreamServer instance = new ScreenStreamServer(screenWrapper, config.port, config.frameRate);
+                instance.start();
+                if (!instance.isRunning()) {
+                    throw new IllegalStateException("监听端口 " + config.port + " 失败");
+                }
+                server = instance;
 
-                Method startMethod = serverClass.getMethod("start");
-                startMethod.invoke(server);
+                long elapsed = System.nanoTime() - scheduledAt;
+                TraceRing.slice(TraceRing.AGENT_SERVER_START, scheduledAt, elapsed, 0);
+                System.out.println("✅ 屏幕流服务器就绪，可通过端口 " + config.port + " 连接，耗时 " +
+                        (elapsed / 1_000_000) + " ms");
 
             } catch (Exception e) {
                 System.err.println("❌ 启动屏幕流服务器失败: " + e.getMessage());
                 e.printStackTrace();
                 started.set(false);
+            } finally {
+                ready.countDown();
             }
         });
 
         serverThread.setName("Cacio-Screen-Stream-Server");
         serverThread.setDaemon(true); // 设置为守护线程，随JVM退出自动终止
         serverThread.start();
-
-        try {
-            Thread.sleep(1000);
-            System.out.println("✅ 屏幕流服务器启动完成，可通过端口 " + config.port + " 连接");
-        } catch (InterruptedException e) {
-            Thread.currentThread().interrupt();
-        }
     }
 
     /**
@@ -170,8 +190,9 @@ public class ScreenStreamAgent {
     private static void addShutdownHook() {
         Runtime.getRuntime().addShutdownHook(new Thread(() -> {
             System.out.println("🛑 正在关闭屏幕流服务器...");
-            if (serverThread != null && serverThread.isAlive()) {
-                serverThread.interrupt();
+            ScreenStreamServer current = server;
+            if (current != null) {
+                current.stop();
             }
             System.out.println("✅ Cacio Screen Stream Agent 已关闭");
         }));
@@ -183,10 +204,25 @@ public class ScreenStreamAgent {
      * 提供外部状态查询接口，用于监控Agent运行状态
      * 可在应用程序中调用此方法验证服务是否正常启动
      *
-     * @return true表示服务器正在运行，false表示服务器未运行或已停止
+     * @return true表示服务器正在运行，false表示服务器未运行、尚未就绪或已停止
      */
     public static boolean isServerRunning() {
-        return started.get() && serverThread != null && serverThread.isAlive();
+        ScreenStreamServer current = server;
+        return current != null && current.isRunning();
+    }
+
+    /**
+     * 等待服务器启动结束
+     * <p>
+     * 替代固定时长的等待：服务器开始监听或启动失败时立即返回
+     *
+     * @param timeout 最长等待时间
+     * @param unit 时间单位
+     * @return true表示服务器已就绪，false表示超时、启动失败或未启用自动启动
+     * @throws InterruptedException 等待期间线程被中断
+     */
+    public static boolean awaitServerReady(long timeout, TimeUnit unit) throws InterruptedException {
+        return ready.await(timeout, unit) && isServerRunning();
     }
 
     /**
@@ -196,8 +232,10 @@ public class ScreenStreamAgent {
      * 适用于需要临时禁用远程桌面功能的场景
      */
     public static void stopServer() {
-        if (serverThread != null) {
-            serverThread.interrupt();
+        ScreenStreamServer current = server;
+        if (current != null) {
+            server = null;
+            current.stop();
             started.set(false);
         }
     }
@@ -1,23 +1,31 @@
 package io.github.eurya.cacio;
 
 import java.io.IOException;
-import java.net.ServerSocket;
+import java.net.InetSocketAddress;
 import java.net.Socket;
-import java.util.concurrent.CopyOnWriteArrayList;
-import java.util.concurrent.ExecutorService;
-import java.util.concurrent.Executors;
+import java.nio.channels.ClosedSelectorException;
+import java.nio.channels.SelectionKey;
+import java.nio.channels.Selector;
+import java.nio.channels.ServerSocketChannel;
+import java.nio.channels.SocketChannel;
+import java.util.Iterator;
+import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentLinkedQueue;
 
 /**
  * Cacio屏幕流服务器主控制器
  * <p>
  * 负责管理远程桌面服务的完整生命周期，包括客户端连接管理、屏幕数据传输和输入事件处理
- * 采用多线程架构支持多客户端并发访问，提供高效的资源管理和优雅的服务启停机制
+ * 无论连接多少个查看器都只使用两个线程：
+ * - 选择器线程：非阻塞地接受连接、读取输入事件、写出各连接写队列中的消息
+ * - 帧线程：按帧率捕获一次屏幕，依次为写队列已清空的连接编码并入队，写队列未清空的连接本帧跳过（背压）
  * <p>
  * 核心功能：
- * - 多客户端并发连接管理
- * - 屏幕数据实时捕获和流式传输
+ * - 多客户端并发连接管理，线程数和上下文切换不随查看器数量增长
+ * - 屏幕数据实时捕获和流式传输，多个查看器共享同一次捕获
  * - 客户端输入事件接收和处理
- * - 动态资源分配和清理
+ * - 连接断开后立即清理，请求了会话恢复的连接暂存编码状态，查看器重连后只发送变化的块
  * - 服务状态监控和统计
  */
 public class ScreenStreamServer {
@@ -27,20 +35,26 @@ public class ScreenStreamServer {
     /** 屏幕数据传输帧率（帧/秒） */
     private final int frameRate;
 
-    /** 线程池执行器，管理所有客户端任务的并发执行 */
-    private final ExecutorService executor;
+    /** 当前连接，选择器线程添加，帧线程在连接关闭后移除 */
+    private final Set<StreamConnection> connections = ConcurrentHashMap.newKeySet();
 
-    /** 线程安全的屏幕捕获任务列表，支持并发访问 */
-    private final CopyOnWriteArrayList<ScreenCaptureTask> clientTasks;
+    /** 帧线程刚放入消息、需要选择器线程关注可写事件的连接 */
+    private final ConcurrentLinkedQueue<StreamConnection> pendingWrites = new ConcurrentLinkedQueue<>();
 
-    /** 线程安全的客户端事件处理任务列表 */
-    private final CopyOnWriteArrayList<ClientEventTask> eventTasks;
+    /** 断开后暂存的编码会话，查看器凭令牌恢复 */
+    private final SessionRegistry sessions = new SessionRegistry();
 
     /** 服务器运行状态标志，volatile确保多线程可见性 */
     private volatile boolean running;
 
-    /** 服务器Socket监听器 */
-    private ServerSocket serverSocket;
+    /** 服务器监听通道 */
+    private ServerSocketChannel serverChannel;
+
+    /** 所有通道共用的选择器 */
+    private Selector selector;
+
+    /** 帧线程，停止时等待其退出后再释放编码资源 */
+    private Thread frameThread;
 
     /** 屏幕数据包装器，提供屏幕捕获功能 */
     private final CTCScreenWrapper screenWrapper;
@@ -48,8 +62,7 @@ public class ScreenStreamServer {
     /**
      * 屏幕流服务器构造函数
      * <p>
-     * 初始化服务器配置参数和资源管理器，准备服务启动环境
-     * 使用缓存线程池动态管理客户端连接，优化资源利用率
+     * 初始化服务器配置参数，准备服务启动环境
      *
      * @param screenWrapper 屏幕数据包装器实例，负责屏幕数据捕获
      * @param port 服务器监听端口，客户端通过此端口连接
@@ -59,16 +72,13 @@ public class ScreenStreamServer {
         this.screenWrapper = screenWrapper;
         this.port = port;
         this.frameRate = frameRate;
-        this.executor = Executors.newCachedThreadPool();
-        this.clientTasks = new CopyOnWriteArrayList<>();
-        this.eventTasks = new CopyOnWriteArrayList<>();
         this.running = false;
     }
 
     /**
      * 启动屏幕流服务器
      * <p>
-     * 初始化服务器Socket监听器，启动客户端接受循环，开始服务
+     * 打开非阻塞的监听通道和选择器，启动选择器线程和帧线程
      * 输出详细的启动信息和配置参数，便于监控和故障诊断
      * 支持重复启动保护，避免资源冲突
      */
@@ -81,125 +91,270 @@ public class ScreenStreamServer {
         running = true;
 
         try {
-            serverSocket = new ServerSocket(port);
+            selector = Selector.open();
+            serverChannel = ServerSocketChannel.open();
+            serverChannel.bind(new InetSocketAddress(port));
+            serverChannel.configureBlocking(false);
+            serverChannel.register(selector, SelectionKey.OP_ACCEPT);
+
             System.out.println("🎯 Cacio屏幕流服务器启动在端口 " + port);
             System.out.println("📏 屏幕尺寸: " + screenWrapper.getScreenWidth() + "x" + screenWrapper.getScreenHeight());
             System.out.println("🎞️  目标帧率: " + frameRate + " FPS");
             System.out.println("📊 数据源: " + (screenWrapper.isCacioAvailable() ? "真实CTCScreen" : "模拟数据"));
             System.out.println("🖱️⌨️  已启用客户端事件处理");
 
-            startClientAcceptLoop();
+            startThread(this::selectLoop, "Stream-Selector-Thread");
+            frameThread = startThread(this::frameLoop, "Stream-Frame-Thread");
 
         } catch (IOException e) {
             System.err.println("❌ 启动服务器时出错: " + e.getMessage());
             running = false;
+            closeQuietly();
         }
     }
 
+    /** 启动守护线程，JVM退出时自动终止 */
+    private static Thread startThread(Runnable body, String name) {
+        Thread thread = new Thread(body);
+        thread.setName(name);
+        thread.setDaemon(true);
+        thread.start();
+        return thread;
+    }
+
     /**
-     * 启动客户端连接接受循环
+     * 选择器循环
      * <p>
-     * 在独立线程中持续监听客户端连接请求，为每个连接创建专用的数据传输和事件处理任务
-     * 使用守护线程确保JVM退出时自动终止，避免资源泄漏
+     * 处理连接接受、输入读取和写队列写出；帧线程放入消息后通过{@link #pendingWrites}和wakeup通知，
+     * 可写事件的注册只在本线程修改，避免跨线程修改interestOps
      */
-    private void startClientAcceptLoop() {
-        Thread acceptThread = new Thread(() -> {
+    private void selectLoop() {
+        try {
             while (running) {
-                try {
-                    Socket clientSocket = serverSocket.accept();
-                    String clientAddress = clientSocket.getInetAddress().getHostAddress();
-                    System.out.println("🔗 新的客户端连接: " + clientAddress);
+                selector.select();
 
-                    ScreenCaptureTask screenTask = new ScreenCaptureTask(clientSocket, screenWrapper, frameRate);
-                    clientTasks.add(screenTask);
-                    executor.execute(screenTask);
+                StreamConnection pending;
+                while ((pending = pendingWrites.poll()) != null) {
+                    flush(pending);
+                }
 
-                    ClientEventTask eventTask = new ClientEventTask(clientSocket);
-                    eventTasks.add(eventTask);
-                    executor.execute(eventTask);
+                Iterator<SelectionKey> keys = selector.selectedKeys().iterator();
+                while (keys.hasNext()) {
+                    SelectionKey key = keys.next();
+                    keys.remove();
+                    if (!key.isValid()) continue;
 
-                    cleanupFinishedTasks();
+                    if (key.isAcceptable()) {
+                        acceptClient();
+                        continue;
+                    }
 
-                } catch (IOException e) {
-                    if (running) {
-                        System.err.println("❌ 接受客户端连接时出错: " + e.getMessage());
+                    StreamConnection connection = (StreamConnection) key.attachment();
+                    try {
+                        if (key.isReadable() && !connection.read()) {
+                            closeConnection(connection);
+                            continue;
+                        }
+                        // 可写时继续写出，读取后也尝试写出刚产生的输入确认
+                        flush(connection);
+                    } catch (IOException e) {
+                        System.err.println("❌ 客户端 " + connection.getClientInfo() + " 连接错误: " + e.getMessage());
+                        closeConnection(connection);
                     }
                 }
             }
-        });
+        } catch (IOException | ClosedSelectorException e) {
+            if (running) {
+                System.err.println("❌ 选择器循环出错: " + e.getMessage());
+            }
+        }
+    }
+
+    /** 接受新的客户端连接并注册读取事件，握手信息已在连接的写队列中 */
+    private void acceptClient() {
+        try {
+            SocketChannel channel = serverChannel.accept();
+            if (channel == null) return;
+            channel.configureBlocking(false);
+
+            Socket socket = channel.socket();
+            String clientInfo = socket.getInetAddress().getHostAddress() + ":" + socket.getPort();
+            System.out.println("🔗 新的客户端连接: " + clientInfo);
+
+            StreamConnection connection = new StreamConnection(channel, clientInfo, screenWrapper, frameRate, sessions);
+            channel.register(selector, SelectionKey.OP_READ, connection);
+            connections.add(connection);
+            flush(connection);
 
-        acceptThread.setName("Client-Accept-Thread");
-        acceptThread.setDaemon(true);
-        acceptThread.start();
+            System.out.println("📊 当前连接客户端数: " + connections.size());
+        } catch (IOException e) {
+            if (running) {
+                System.err.println("❌ 接受客户端连接时出错: " + e.getMessage());
+            }
+        }
+    }
+
+    /** 写出连接的写队列，未写完时关注可写事件，写完后取消关注 */
+    private void flush(StreamConnection connection) {
+        SelectionKey key = connection.isClosed() ? null : connection.keyFor(selector);
+        if (key == null || !key.isValid()) return;
+        try {
+            boolean drained = connection.flush();
+            int ops = drained ? SelectionKey.OP_READ : SelectionKey.OP_READ | SelectionKey.OP_WRITE;
+            if (key.interestOps() != ops) key.interestOps(ops);
+        } catch (IOException e) {
+            System.err.println("❌ 客户端 " + connection.getClientInfo() + " 发送失败: " + e.getMessage());
+            closeConnection(connection);
+        }
+    }
+
+    /** 关闭连接，编码资源由帧线程在下一帧移除连接时释放或暂存 */
+    private void closeConnection(StreamConnection connection) {
+        if (connection.isClosed()) return;
+        connection.close();
+        System.out.println("🔌 客户端断开: " + connection.getClientInfo());
     }
 
     /**
-     * 清理已完成的任务
+     * 帧循环
      * <p>
-     * 定期移除已停止的客户端任务，释放相关资源
-     * 维护活动连接统计，提供运行状态监控
+     * 每帧只捕获一次屏幕，为所有写队列已清空的连接编码；先移除已关闭的连接并清理过期的暂存会话，没有连接时不捕获
      */
-    private void cleanupFinishedTasks() {
-        clientTasks.removeIf(task -> !task.isRunning());
+    private void frameLoop() {
+        long frameInterval = 1000 / frameRate;
+        while (running) {
+            long frameStartTime = System.currentTimeMillis();
+
+            for (StreamConnection connection : connections) {
+                if (connection.isClosed() && connections.remove(connection)) {
+                    connection.release();
+                }
+            }
+            sessions.expire();
 
-        eventTasks.removeIf(task -> !task.isRunning());
+            if (!connections.isEmpty()) {
+                captureAndDispatchFrame();
+            }
 
-        System.out.println("📊 当前连接客户端数: " + clientTasks.size() +
-                ", 事件处理任务数: " + eventTasks.size());
+            long frameTime = System.currentTimeMillis() - frameStartTime;
+            if (frameTime < frameInterval) {
+                try {
+                    Thread.sleep(frameInterval - frameTime);
+                } catch (InterruptedException e) {
+                    Thread.currentThread().interrupt();
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * 捕获一帧并分发给就绪的连接
+     * <p>
+     * 验证数据完整性，尺寸不匹配时补齐或截断，保证各连接的编码器收到完整的一帧
+     */
+    private void captureAndDispatchFrame() {
+        long captureStart = System.nanoTime();
+        int[] rgbData = screenWrapper.getScreenRGBData();
+
+        if (rgbData == null || rgbData.length == 0) {
+            System.err.println("⚠️  获取到空的屏幕数据");
+            return;
+        }
+
+        int expectedSize = screenWrapper.getScreenWidth() * screenWrapper.getScreenHeight();
+        if (rgbData.length != expectedSize) {
+            System.err.println("⚠️  屏幕数据尺寸不匹配: 期望=" + expectedSize + ", 实际=" + rgbData.length);
+            int[] correctedData = new int[expectedSize];
+            System.arraycopy(rgbData, 0, correctedData, 0, Math.min(rgbData.length, expectedSize));
+            rgbData = correctedData;
+        }
+        long captureNanos = System.nanoTime() - captureStart;
+
+        boolean queued = false;
+        for (StreamConnection connection : connections) {
+            if (!connection.isReady()) continue;
+            connection.sendFrame(rgbData, captureNanos);
+            pendingWrites.add(connection);
+            queued = true;
+        }
+        if (queued) {
+            selector.wakeup();
+        }
     }
 
     /**
      * 停止服务器并释放所有资源
      * <p>
-     * 执行优雅关闭流程：停止接受新连接、终止所有客户端任务、关闭线程池和服务器Socket
-     * 确保所有网络连接和系统资源得到正确释放
+     * 执行优雅关闭流程：停止帧循环和选择器循环、关闭所有客户端连接和监听通道
+     * 等待帧线程退出后再释放各连接的编码任务，避免与正在进行的编码并发；服务器停止后会话无法恢复，暂存的任务一并释放
      */
     public void stop() {
         running = false;
 
-        for (ScreenCaptureTask task : clientTasks) {
-            task.stop();
+        for (StreamConnection connection : connections) {
+            connection.close();
         }
-        clientTasks.clear();
 
-        for (ClientEventTask task : eventTasks) {
-            task.stop();
+        Thread thread = frameThread;
+        if (thread != null && thread != Thread.currentThread()) {
+            thread.interrupt();
+            try {
+                thread.join(1000);
+            } catch (InterruptedException e) {
+                Thread.currentThread().interrupt();
+            }
         }
-        eventTasks.clear();
-
-        executor.shutdown();
+        frameThread = null;
 
-        if (serverSocket != null && !serverSocket.isClosed()) {
-            try {
-                serverSocket.close();
-            } catch (IOException e) {
-                System.err.println("❌ 关闭服务器socket时出错: " + e.getMessage());
+        for (StreamConnection connection : connections) {
+            if (connections.remove(connection)) {
+                connection.release();
             }
         }
+        sessions.clear();
+
+        closeQuietly();
 
         System.out.println("🛑 服务器已停止");
     }
 
+    /** 关闭选择器和监听通道，启动失败和停止时调用，任一关闭失败不影响另一个 */
+    private void closeQuietly() {
+        try {
+            if (selector != null) {
+                selector.close();
+            }
+        } catch (IOException e) {
+            System.err.println("❌ 关闭选择器时出错: " + e.getMessage());
+        }
+        try {
+            if (serverChannel != null) {
+                serverChannel.close();
+            }
+        } catch (IOException e) {
+            System.err.println("❌ 关闭服务器socket时出错: " + e.getMessage());
+        }
+    }
+
     /**
      * 获取当前连接的客户端数量
-     * <p>
-     * 统计当前活跃的屏幕捕获任务数量，反映实际连接的客户端数
      *
      * @return 当前活跃的客户端连接数量
      */
     public int getConnectedClientCount() {
-        return (int) clientTasks.stream().filter(ScreenCaptureTask::isRunning).count();
+        return (int) connections.stream().filter(connection -> !connection.isClosed()).count();
     }
 
     /**
      * 获取活跃的事件处理任务数量
      * <p>
-     * 统计当前正在处理客户端输入事件的任务数量
+     * 每个连接有一个事件处理任务，与连接数相同
      *
      * @return 当前活跃的事件处理任务数量
      */
     public int getEventTaskCount() {
-        return (int) eventTasks.stream().filter(ClientEventTask::isRunning).count();
+        return getConnectedClientCount();
     }
 
     /**
@@ -212,4 +367,4 @@ public class ScreenStreamServer {
     public boolean isRunning() {
         return running;
     }
-}
\ No newline at end of file
+}
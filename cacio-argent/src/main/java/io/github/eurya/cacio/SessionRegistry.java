@@ -0,0 +1,98 @@
+package io.github.eurya.cacio;
+
+import java.security.SecureRandom;
+import java.util.Iterator;
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
+
+/**
+ * 断开连接后暂存的编码会话
+ * <p>
+ * 查看器在HELLO中请求resume时，连接会分配一个会话令牌并通过SESSION消息告知查看器。
+ * 连接断开后编码任务（分块哈希、缓存槽位分配、质量控制状态）不立即释放，而是按令牌暂存{@link #GRACE_MILLIS}毫秒：
+ * Activity重建等原因导致查看器重连时，凭令牌接管原来的编码任务，只需发送断开之后变化的块，而不是整屏内容
+ * <p>
+ * 暂存和过期清理在帧线程进行，接管在选择器线程进行，两者通过ConcurrentHashMap的原子删除保证同一个任务只被取走一次
+ */
+final class SessionRegistry {
+
+    /** 会话暂存时长（毫秒），超时后释放编码任务 */
+    static final long GRACE_MILLIS = 30_000L;
+
+    private final SecureRandom random = new SecureRandom();
+
+    private final ConcurrentHashMap<Long, Parked> parked = new ConcurrentHashMap<>();
+
+    /**
+     * 分配新的会话令牌
+     *
+     * @return 非0的随机令牌，0表示没有会话
+     */
+    long newToken() {
+        long token;
+        do {
+            token = random.nextLong();
+        } while (token == 0);
+        return token;
+    }
+
+    /**
+     * 暂存已断开连接的编码任务，只在帧线程调用
+     *
+     * @param token 会话令牌
+     * @param task 编码任务，此后不再被任何连接使用
+     */
+    void park(long token, ScreenCaptureTask task) {
+        Parked previous = parked.put(token, new Parked(task));
+        if (previous != null) {
+            previous.task.close();
+        }
+        System.out.println("💤 会话已暂存，" + (GRACE_MILLIS / 1000) + "秒内可恢复，暂存会话数: " + parked.size());
+    }
+
+    /**
+     * 取走暂存的编码任务，只在选择器线程调用
+     *
+     * @param token 查看器带回的会话令牌
+     * @return 编码任务，令牌未知或已过期时返回null
+     */
+    ScreenCaptureTask take(long token) {
+        Parked entry = parked.remove(token);
+        return entry == null ? null : entry.task;
+    }
+
+    /**
+     * 释放超过暂存时长的编码任务，只在帧线程调用
+     */
+    void expire() {
+        if (parked.isEmpty()) return;
+        long now = System.currentTimeMillis();
+        Iterator<Map.Entry<Long, Parked>> entries = parked.entrySet().iterator();
+        while (entries.hasNext()) {
+            Map.Entry<Long, Parked> entry = entries.next();
+            if (now - entry.getValue().parkedAt >= GRACE_MILLIS && parked.remove(entry.getKey(), entry.getValue())) {
+                entry.getValue().task.close();
+            }
+        }
+    }
+
+    /** 释放所有暂存的编码任务，服务器停止时调用 */
+    void clear() {
+        for (Long token : parked.keySet()) {
+            ScreenCaptureTask task = take(token);
+            if (task != null) task.close();
+        }
+    }
+
+    /** 一个暂存的编码任务 */
+    private static final class Parked {
+        final ScreenCaptureTask task;
+
+        /** 暂存时间（毫秒） */
+        final long parkedAt = System.currentTimeMillis();
+
+        Parked(ScreenCaptureTask task) {
+            this.task = task;
+        }
+    }
+}
@@ -0,0 +1,387 @@
+package io.github.eurya.cacio;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.SelectionKey;
+import java.nio.channels.Selector;
+import java.nio.channels.SocketChannel;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayDeque;
+
+/**
+ * 选择器模型下的单个查看器连接
+ * <p>
+ * 持有非阻塞的SocketChannel、该连接的帧编码任务和输入事件任务，以及待写出的消息队列。
+ * 帧线程编码后调用{@link #sendFrame}，选择器线程在可写时调用{@link #flush}；读取同样只发生在选择器线程
+ * <p>
+ * 背压：帧队列中还有未写完的消息时{@link #isReady()}返回false，帧线程跳过这个连接，
+ * 慢速查看器只会少收帧而不会让队列无限增长，也不会拖慢其他查看器。分块编码按上一次编码的内容求差，跳过的帧不影响正确性
+ * <p>
+ * 通道复用：查看器在HELLO中声明mux后，先以原有格式发送一条{@link #MUX_MARKER}消息，之后所有数据都按
+ * 通道号byte、长度int、数据分块发送，每块最多{@link #CHUNK_SIZE}字节。每写完一块都重新按优先级选择通道，
+ * 输入确认因此最多只需等待一块帧数据，而不是整个数MB的关键帧。未声明mux时输入确认以{@link #ACK_MESSAGE}消息排在帧之间
+ * <p>
+ * 会话恢复：查看器在HELLO中声明resume后，连接分配会话令牌，在下一帧之前发送{@link #SESSION_MESSAGE}消息（令牌和下一帧序号）。
+ * 连接断开后编码任务按令牌暂存在{@link SessionRegistry}中；新连接凭令牌接管后，由帧线程在下一帧之前换上暂存的任务，
+ * 握手后为新连接创建的任务随即释放
+ */
+final class StreamConnection {
+
+    /** 每次读取的缓冲区大小，输入消息都是短文本行 */
+    private static final int READ_BUFFER_SIZE = 8 * 1024;
+
+    /** 通道复用时每块的最大数据量 */
+    static final int CHUNK_SIZE = 64 * 1024;
+
+    /** 输入确认通道，优先级最高 */
+    static final byte CHANNEL_INPUT = 0;
+
+    /** 帧通道，包括握手和帧消息 */
+    static final byte CHANNEL_FRAME = 1;
+
+    /** 切换到通道复用的消息格式名，长度固定为0 */
+    static final String MUX_MARKER = "MUX";
+
+    /** 未复用时输入确认的消息格式名，数据为8字节的输入序号 */
+    static final String ACK_MESSAGE = "ACK";
+
+    /** 会话消息的格式名，数据为会话令牌long和下一帧序号long */
+    static final String SESSION_MESSAGE = "SESSION";
+
+    private final SocketChannel channel;
+    private final String clientInfo;
+    private final ClientEventTask eventTask;
+    private final SessionRegistry sessions;
+
+    /** 当前的帧编码任务，接管会话时由帧线程替换 */
+    private volatile ScreenCaptureTask screenTask;
+
+    /** 选择器线程取出、等待帧线程换上的暂存任务 */
+    private volatile ScreenCaptureTask resumedTask;
+
+    /** 会话令牌，0表示查看器没有请求会话恢复 */
+    private volatile long sessionToken;
+
+    /** 是否需要在下一帧之前发送会话消息 */
+    private volatile boolean sessionPending;
+
+    private final ByteBuffer readBuffer = ByteBuffer.allocate(READ_BUFFER_SIZE);
+
+    /** 两个队列共用的锁，帧线程写入帧队列，选择器线程写入确认队列并取出 */
+    private final Object queueLock = new Object();
+
+    /** 帧通道的待写消息 */
+    private final ArrayDeque<Outbound> frameQueue = new ArrayDeque<>();
+
+    /** 输入通道的待写消息，复用后优先于帧通道写出 */
+    private final ArrayDeque<Outbound> inputQueue = new ArrayDeque<>();
+
+    /** 当前分块的头部（通道号和长度），未复用时为空 */
+    private final ByteBuffer chunkHeader = ByteBuffer.allocate(5);
+
+    /** 当前正在写出的头部和数据 */
+    private final ByteBuffer[] chunk = new ByteBuffer[2];
+
+    /** 当前分块所属的消息和队列，没有正在写出的分块时为null */
+    private Outbound chunkOwner;
+    private ArrayDeque<Outbound> chunkQueue;
+
+    /** 切换消息，写完之后进入复用模式；只在选择器线程访问 */
+    private Outbound muxMarker;
+
+    /** 是否已写出切换消息；只在选择器线程访问 */
+    private boolean multiplexed;
+
+    /** 查看器是否请求输入确认；只在选择器线程访问 */
+    private boolean ackInput;
+
+    /** 上一帧的发送耗时（纳秒），-1表示已被帧线程取走 */
+    private volatile long lastSendNanos = -1;
+
+    private volatile boolean closed;
+
+    /**
+     * @param channel 已接受的客户端通道，调用方负责设置为非阻塞并注册到选择器
+     * @param clientInfo 客户端标识，用于日志输出
+     * @param screenWrapper 屏幕数据包装器
+     * @param frameRate 目标帧率
+     * @param sessions 断开后暂存编码任务的会话表
+     */
+    StreamConnection(SocketChannel channel, String clientInfo, CTCScreenWrapper screenWrapper, int frameRate,
+                     SessionRegistry sessions) {
+        this.channel = channel;
+        this.clientInfo = clientInfo;
+        this.sessions = sessions;
+        this.screenTask = new ScreenCaptureTask(clientInfo, screenWrapper, frameRate);
+        this.eventTask = new ClientEventTask(clientInfo, this);
+        enqueue(frameQueue, new Outbound(screenTask.encodeScreenInfo(), -1));
+    }
+
+    /**
+     * 是否可以接收下一帧
+     *
+     * @return 连接未关闭且帧队列已清空时返回true
+     */
+    boolean isReady() {
+        if (closed) return false;
+        synchronized (queueLock) {
+            return frameQueue.isEmpty();
+        }
+    }
+
+    /**
+     * 为该连接编码一帧并放入帧队列，只在帧线程调用
+     *
+     * @param rgbData 本帧共享的屏幕像素
+     * @param captureNanos 本帧的捕获耗时（纳秒）
+     */
+    void sendFrame(int[] rgbData, long captureNanos) {
+        ScreenCaptureTask resumed = resumedTask;
+        if (resumed != null) {
+            resumedTask = null;
+            screenTask.close();
+            screenTask = resumed;
+            sessionPending = true;
+        }
+        ScreenCaptureTask task = screenTask;
+
+        long sent = lastSendNanos;
+        if (sent >= 0) {
+            lastSendNanos = -1;
+            task.onFrameSent(sent);
+        }
+        long frameId = task.getFrameCount();
+        if (sessionPending) {
+            sessionPending = false;
+            ByteBuffer session = ByteBuffer.allocate(16);
+            session.putLong(0, sessionToken).putLong(8, frameId);
+            enqueue(frameQueue, new Outbound(legacyMessage(SESSION_MESSAGE, session.array()), -1));
+        }
+        enqueue(frameQueue, new Outbound(task.encodeFrame(rgbData, captureNanos), frameId));
+    }
+
+    /**
+     * 应用查看器在HELLO中声明的编码能力，并按需开始或恢复会话，只在选择器线程调用
+     *
+     * @param cacheBytes 分块缓存预算（字节）
+     * @param jpeg 是否能解码JPEG分块
+     * @param deflate 跨帧deflate压缩等级，-1表示不压缩
+     * @param resume 是否请求会话令牌
+     * @param resumeToken 查看器带回的会话令牌，0表示没有
+     * @param viewerFrames 查看器在该会话中已应用的帧数
+     * @return 是否接管了暂存的会话
+     */
+    boolean startSession(long cacheBytes, boolean jpeg, int deflate, boolean resume, long resumeToken, long viewerFrames) {
+        ScreenCaptureTask parked = resumeToken != 0 && sessionToken == 0 ? sessions.take(resumeToken) : null;
+        if (parked != null) {
+            parked.resume(cacheBytes, jpeg, deflate, viewerFrames);
+            sessionToken = resumeToken;
+            resumedTask = parked; // 帧线程在下一帧之前换上并发送会话消息
+            return true;
+        }
+
+        screenTask.enableTileCache(cacheBytes, jpeg, deflate);
+        if ((resume || resumeToken != 0) && sessionToken == 0) {
+            sessionToken = sessions.newToken();
+            sessionPending = true;
+        }
+        return false;
+    }
+
+    /**
+     * 应用查看器在HELLO中声明的传输能力，只在选择器线程调用
+     *
+     * @param ack 是否为每条输入消息回复确认
+     * @param mux 是否切换到通道复用
+     */
+    void configureTransport(boolean ack, boolean mux) {
+        ackInput = ack;
+        if (mux && muxMarker == null) {
+            muxMarker = new Outbound(legacyMessage(MUX_MARKER, new byte[0]), -1);
+            enqueue(frameQueue, muxMarker);
+        }
+    }
+
+    /**
+     * 确认一条输入消息已经分发，查看器据此测量输入往返时间，只在选择器线程调用
+     *
+     * @param inputSeq 输入序号，按连接上收到的行计数
+     */
+    void acknowledgeInput(long inputSeq) {
+        if (!ackInput) return;
+        ByteBuffer seq = ByteBuffer.allocate(8);
+        seq.putLong(0, inputSeq);
+        if (muxMarker != null) {
+            enqueue(inputQueue, new Outbound(seq, -1));
+        } else {
+            enqueue(frameQueue, new Outbound(legacyMessage(ACK_MESSAGE, seq.array()), -1));
+        }
+    }
+
+    /** 按未复用时的帧格式编码一条消息：格式名UTF、长度int、数据 */
+    private static ByteBuffer legacyMessage(String name, byte[] payload) {
+        byte[] nameBytes = name.getBytes(StandardCharsets.UTF_8);
+        ByteBuffer message = ByteBuffer.allocate(2 + nameBytes.length + 4 + payload.length);
+        message.putShort((short) nameBytes.length).put(nameBytes).putInt(payload.length).put(payload);
+        message.flip();
+        return message;
+    }
+
+    private void enqueue(ArrayDeque<Outbound> queue, Outbound message) {
+        synchronized (queueLock) {
+            queue.addLast(message);
+        }
+    }
+
+    /**
+     * 尽量写出队列中的消息，只在选择器线程调用
+     *
+     * @return 队列已全部写出时返回true，否则需要继续关注可写事件
+     * @throws IOException 当写入失败时抛出
+     */
+    boolean flush() throws IOException {
+        while (true) {
+            if (chunkOwner == null && !nextChunk()) return true;
+
+            channel.write(chunk);
+            if (chunk[0].hasRemaining() || chunk[1].hasRemaining()) return false; // 发送缓冲区已满
+
+            Outbound message = chunkOwner;
+            ArrayDeque<Outbound> queue = chunkQueue;
+            chunkOwner = null;
+            chunkQueue = null;
+            if (message.data.hasRemaining()) continue; // 复用模式下消息还有后续分块
+
+            synchronized (queueLock) {
+                queue.pollFirst();
+            }
+            if (message == muxMarker) {
+                multiplexed = true;
+            }
+            if (message.frameId >= 0) {
+                long sendNanos = System.nanoTime() - message.queuedAt;
+                lastSendNanos = sendNanos;
+                StreamStats.recordSend(sendNanos);
+                TraceRing.slice(TraceRing.AGENT_SEND, message.queuedAt, sendNanos, TraceRing.frameFlow(message.frameId));
+            }
+        }
+    }
+
+    /**
+     * 选出下一块要写的数据
+     * <p>
+     * 复用模式下输入通道优先，每块最多{@link #CHUNK_SIZE}字节；切换消息写出之前只写帧队列，且整条消息作为一块
+     *
+     * @return 没有待写数据时返回false
+     */
+    private boolean nextChunk() {
+        synchronized (queueLock) {
+            chunkQueue = multiplexed && !inputQueue.isEmpty() ? inputQueue : frameQueue;
+            chunkOwner = chunkQueue.peekFirst();
+        }
+        if (chunkOwner == null) {
+            chunkQueue = null;
+            return false;
+        }
+
+        // 分块与消息共享底层数组，消息的position直接前移到分块之后
+        ByteBuffer data = chunkOwner.data;
+        int length = multiplexed ? Math.min(CHUNK_SIZE, data.remaining()) : data.remaining();
+        ByteBuffer payload = data.duplicate();
+        payload.limit(payload.position() + length);
+        data.position(data.position() + length);
+
+        chunkHeader.clear();
+        if (multiplexed) {
+            chunkHeader.put(chunkQueue == inputQueue ? CHANNEL_INPUT : CHANNEL_FRAME).putInt(length);
+        }
+        chunkHeader.flip();
+        chunk[0] = chunkHeader;
+        chunk[1] = payload;
+        return true;
+    }
+
+    /**
+     * 读取并处理输入事件，只在选择器线程调用
+     *
+     * @return 对端已关闭时返回false
+     * @throws IOException 当读取失败时抛出
+     */
+    boolean read() throws IOException {
+        readBuffer.clear();
+        int count = channel.read(readBuffer);
+        if (count < 0) return false;
+        readBuffer.flip();
+        eventTask.onInput(readBuffer);
+        return true;
+    }
+
+    /**
+     * 关闭连接，只在选择器线程调用
+     * <p>
+     * 帧线程可能正在为该连接编码，这里只关闭通道并清空写队列，编码任务的资源由帧线程移除连接时通过{@link #release()}释放
+     */
+    void close() {
+        if (closed) return;
+        closed = true;
+        try {
+            channel.close();
+        } catch (IOException e) {
+            System.err.println("❌ 关闭客户端socket时出错: " + e.getMessage());
+        }
+        synchronized (queueLock) {
+            frameQueue.clear();
+            inputQueue.clear();
+        }
+        eventTask.close();
+    }
+
+    /**
+     * 释放编码任务的资源并输出统计，只在帧线程调用，此后不会再为该连接编码
+     * <p>
+     * 有会话令牌时编码任务暂存到{@link SessionRegistry}，等待查看器重连后接管
+     */
+    void release() {
+        ScreenCaptureTask resumed = resumedTask;
+        if (resumed != null) {
+            resumedTask = null;
+            screenTask.close();
+            screenTask = resumed;
+        }
+        long token = sessionToken;
+        if (token != 0) {
+            sessions.park(token, screenTask);
+        } else {
+            screenTask.close();
+        }
+    }
+
+    /** 通道在选择器上的注册键，尚未注册时返回null */
+    SelectionKey keyFor(Selector selector) {
+        return channel.keyFor(selector);
+    }
+
+    boolean isClosed() {
+        return closed;
+    }
+
+    String getClientInfo() {
+        return clientInfo;
+    }
+
+    /** 写队列中的一条消息 */
+    private static final class Outbound {
+        final ByteBuffer data;
+
+        /** 帧序号，握手、确认等非帧消息为-1 */
+        final long frameId;
+
+        /** 进入队列的时间（纳秒） */
+        final long queuedAt = System.nanoTime();
+
+        Outbound(ByteBuffer data, long frameId) {
+            this.data = data;
+            this.frameId = frameId;
+        }
+    }
+}
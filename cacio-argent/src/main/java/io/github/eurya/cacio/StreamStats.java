@@ -0,0 +1,141 @@
+package io.github.eurya.cacio;
+
+import java.util.LinkedHashMap;
+import java.util.Map;
+import java.util.concurrent.atomic.LongAdder;
+
+/**
+ * 屏幕流全局统计
+ * <p>
+ * 汇总所有客户端传输任务在捕获、编码和发送各阶段的累计耗时与数据量
+ * 计数器使用LongAdder，多个传输线程并发累加时不会相互竞争
+ * <p>
+ * 主要供主机端回环基准测试读取：基准测试的负载程序通过系统类加载器反射调用{@link #snapshot()}，
+ * 在测量区间前后各取一次快照并计算差值
+ */
+public final class StreamStats {
+
+    /** 成功发送的帧数 */
+    private static final LongAdder frames = new LongAdder();
+
+    /** 从CTCScreen获取像素的累计耗时（纳秒） */
+    private static final LongAdder captureNanos = new LongAdder();
+
+    /** 像素格式转换的累计耗时（纳秒） */
+    private static final LongAdder encodeNanos = new LongAdder();
+
+    /** 写入并刷新Socket的累计耗时（纳秒） */
+    private static final LongAdder sendNanos = new LongAdder();
+
+    /** 累计发送的帧数据量（字节，不含帧头） */
+    private static final LongAdder bytes = new LongAdder();
+
+    /** 分块模式下以像素发送的块数 */
+    private static final LongAdder tilesSent = new LongAdder();
+
+    /** 分块模式下命中查看器缓存、只发送槽位号的块数 */
+    private static final LongAdder cacheHits = new LongAdder();
+
+    /** 分块模式下以纯色或渐变命令发送的块数 */
+    private static final LongAdder tilesFilled = new LongAdder();
+
+    /** 分块模式下判定为照片内容、以JPEG发送的块数 */
+    private static final LongAdder tilesPhoto = new LongAdder();
+
+    /** 分块模式下以块内调色板发送的块数 */
+    private static final LongAdder tilesPalette = new LongAdder();
+
+    /** 分块模式下因负载降级为RGB565发送的块数 */
+    private static final LongAdder tilesDegraded = new LongAdder();
+
+    /** 分块模式下稳定后补发完整内容的降级块数 */
+    private static final LongAdder tilesRefined = new LongAdder();
+
+    /** deflate压缩前的累计字节数 */
+    private static final LongAdder deflateIn = new LongAdder();
+
+    /** deflate压缩后的累计字节数 */
+    private static final LongAdder deflateOut = new LongAdder();
+
+    /** deflate压缩的累计耗时（纳秒），同时计入encode_ns */
+    private static final LongAdder deflateNanos = new LongAdder();
+
+    private StreamStats() {
+    }
+
+    /**
+     * 记录一帧的捕获和编码耗时
+     *
+     * @param capture 捕获耗时（纳秒）
+     * @param encode 编码耗时（纳秒）
+     * @param frameBytes 帧数据字节数
+     */
+    static void recordFrame(long capture, long encode, long frameBytes) {
+        frames.increment();
+        captureNanos.add(capture);
+        encodeNanos.add(encode);
+        bytes.add(frameBytes);
+    }
+
+    /**
+     * 记录一帧的发送耗时，即帧消息从进入写队列到完全写入Socket的时间
+     *
+     * @param send 发送耗时（纳秒）
+     */
+    static void recordSend(long send) {
+        sendNanos.add(send);
+    }
+
+    /**
+     * 记录一帧分块编码的结果
+     *
+     * @param encoder 刚完成编码的分块编码器，各项计数为最近一帧的值
+     */
+    static void recordTiles(TileFrameEncoder encoder) {
+        tilesSent.add(encoder.getPixelTiles());
+        cacheHits.add(encoder.getCacheHits());
+        tilesFilled.add(encoder.getFillTiles());
+        tilesPhoto.add(encoder.getPhotoTiles());
+        tilesPalette.add(encoder.getPaletteTiles());
+        tilesDegraded.add(encoder.getDegradedTiles());
+        tilesRefined.add(encoder.getRefinedTiles());
+    }
+
+    /**
+     * 记录一帧的deflate压缩结果
+     *
+     * @param input 压缩前字节数
+     * @param output 压缩后字节数
+     * @param nanos 压缩耗时（纳秒）
+     */
+    static void recordDeflate(long input, long output, long nanos) {
+        deflateIn.add(input);
+        deflateOut.add(output);
+        deflateNanos.add(nanos);
+    }
+
+    /**
+     * 获取当前累计值的快照
+     *
+     * @return 按固定顺序排列的统计项，键为frames、capture_ns、encode_ns、send_ns、bytes、tiles_sent、cache_hits、tiles_filled、tiles_photo、tiles_palette、tiles_degraded、tiles_refined、deflate_in、deflate_out、deflate_ns
+     */
+    public static Map<String, Long> snapshot() {
+        Map<String, Long> result = new LinkedHashMap<>();
+        result.put("frames", frames.sum());
+        result.put("capture_ns", captureNanos.sum());
+        result.put("encode_ns", encodeNanos.sum());
+        result.put("send_ns", sendNanos.sum());
+        result.put("bytes", bytes.sum());
+        result.put("tiles_sent", tilesSent.sum());
+        result.put("cache_hits", cacheHits.sum());
+        result.put("tiles_filled", tilesFilled.sum());
+        result.put("tiles_photo", tilesPhoto.sum());
+        result.put("tiles_palette", tilesPalette.sum());
+        result.put("tiles_degraded", tilesDegraded.sum());
+        result.put("tiles_refined", tilesRefined.sum());
+        result.put("deflate_in", deflateIn.sum());
+        result.put("deflate_out", deflateOut.sum());
+        result.put("deflate_ns", deflateNanos.sum());
+        return result;
+    }
+}
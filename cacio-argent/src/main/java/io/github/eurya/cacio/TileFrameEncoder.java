@@ -0,0 +1,633 @@
+package io.github.eurya.cacio;
+
+import java.io.IOException;
+import java.util.Arrays;
+import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.Map;
+
+/**
+ * 基于内容哈希的分块帧编码器
+ * <p>
+ * 把屏幕按64x64分块，每帧只发送与上一帧相比内容发生变化的块。变化的块先按内容哈希查找缓存：
+ * 查看器已经持有相同内容时只发送CACHE_HIT（块位置和缓存槽位），否则发送像素并指定存入的槽位。
+ * 工具栏图标、标签页头、重新打开的对话框、滚回视野的列表行等重复内容因此只需传输一次
+ * <p>
+ * 变化的块在查缓存之前先做分类：纯色块发送{@link #OP_FILL}，每行同色或每列同色的块（Metal/Nimbus的渐变装饰）
+ * 发送{@link #OP_GRADIENT_VERTICAL}或{@link #OP_GRADIENT_HORIZONTAL}，只携带一行或一列颜色，
+ * 不占用缓存槽位。面板背景、表格单元格背景和窗口重绘时的clearRect大多落在这一类
+ * <p>
+ * 未命中缓存的块再按颜色数和边缘统计区分界面与照片：颜色多且很少有硬边缘的不透明块视为图片、地图或图表中的照片内容，
+ * 查看器支持时用{@link JpegTileEncoder}有损压缩（{@link #OP_JPEG}），质量由{@link QualityController}调节；
+ * 文本和界面元素颜色少、边缘锐利，始终无损发送：不超过256色的块建立块内调色板（{@link #OP_PALETTE}），
+ * 按颜色数以1/2/4/8位索引发送，典型的Swing块只有几种到几十种颜色，数据量降为原始像素的1/4到1/16；
+ * 调色板放不下时才发送完整像素
+ * <p>
+ * 渐进模式：拖动、滚动等大面积变化或链路拥塞时，本应以完整像素发送的块改为RGB565（{@link #OP_RGB565}），
+ * 数据量减半；按块记录哪些位置是降级内容，画面稳定一段时间后再补发完整内容，细化只覆盖降级过的块。
+ * 质量低于{@link QualityController#MAX_QUALITY}的JPEG块同样记为降级内容，细化时以最高质量重新编码；
+ * 降级内容都不写入缓存，缓存中只有无损或最高质量的块，之后的缓存命中不会把低质量画面带回屏幕
+ * <p>
+ * 缓存槽位由服务端统一分配：槽位数由查看器在HELLO中声明的内存预算决定，缓存满时复用最久未使用的槽位，
+ * 查看器按槽位号覆盖即可，两端的淘汰顺序天然一致，不需要额外的淘汰消息
+ * <p>
+ * 帧格式名为{@link #FORMAT}，数据（大端）：
+ * 块大小int、操作数int，随后每个操作为类型byte、块序号int、槽位int，
+ * {@link #OP_PIXELS}之后紧跟该块的ARGB像素（边缘块按实际宽高），槽位为-1表示不缓存；
+ * {@link #OP_FILL}之后为一个ARGB颜色int，{@link #OP_GRADIENT_VERTICAL}之后为每行的颜色（h个int），
+ * {@link #OP_GRADIENT_HORIZONTAL}之后为每列的颜色（w个int），这三种操作的槽位固定为-1；
+ * {@link #OP_JPEG}之后为JPEG长度int和JPEG数据，槽位含义与{@link #OP_PIXELS}相同，缓存的是解码后的像素；
+ * {@link #OP_RGB565}之后为w*h个大端RGB565值，槽位固定为-1；
+ * {@link #OP_PALETTE}之后为颜色数减1（无符号byte）、调色板颜色（int）和逐行打包的索引，索引位宽由颜色数决定
+ * （2色1位、4色2位、16色4位，其余8位），高位在前，每行补齐到整字节，槽位含义与{@link #OP_PIXELS}相同。
+ * 块序号按行优先排列，没有任何块变化时整帧以长度-1发送
+ * <p>
+ * 对应查看器端的io.github.eurya.awt.codec.TileFrameDecoder
+ */
+final class TileFrameEncoder {
+
+    /** 分块帧的格式名 */
+    static final String FORMAT = "TILES";
+
+    /** 块边长（设备像素） */
+    static final int TILE_SIZE = 64;
+
+    /** 操作：块像素 */
+    static final byte OP_PIXELS = 0;
+
+    /** 操作：从缓存槽位复制 */
+    static final byte OP_CACHE_HIT = 1;
+
+    /** 操作：纯色填充 */
+    static final byte OP_FILL = 2;
+
+    /** 操作：每行一种颜色（竖直方向渐变） */
+    static final byte OP_GRADIENT_VERTICAL = 3;
+
+    /** 操作：每列一种颜色，所有行相同（水平方向渐变） */
+    static final byte OP_GRADIENT_HORIZONTAL = 4;
+
+    /** 操作：JPEG压缩的照片类块 */
+    static final byte OP_JPEG = 5;
+
+    /** 操作：RGB565降级的块，稳定后细化 */
+    static final byte OP_RGB565 = 6;
+
+    /** 操作：块内调色板加索引 */
+    static final byte OP_PALETTE = 7;
+
+    /** 块内调色板的最大颜色数 */
+    private static final int PALETTE_MAX_COLORS = 256;
+
+    /** 照片类块至少需要的不同颜色数 */
+    private static final int PHOTO_MIN_COLORS = 96;
+
+    /** 照片类块中硬边缘（相邻像素亮度差超过{@link #HARD_EDGE_LUMA}）所占比例的上限 */
+    private static final double PHOTO_MAX_HARD_EDGES = 0.08;
+
+    private static final int HARD_EDGE_LUMA = 64;
+
+    private final int width;
+    private final int height;
+    private final int columns;
+    private final int rows;
+
+    /** 每个块位置上一帧的内容哈希，0表示尚未发送 */
+    private final long[] previousHashes;
+
+    /** 缓存槽位数，0表示查看器不缓存 */
+    private final int cacheSlots;
+
+    /** 内容哈希到槽位的映射，按访问顺序排列，最久未使用的在最前面 */
+    private final LinkedHashMap<Long, Integer> cache = new LinkedHashMap<>(16, 0.75f, true);
+
+    /** 照片类块的编码器，查看器不支持JPEG时为null */
+    private final JpegTileEncoder jpegEncoder;
+
+    /** 决定JPEG质量和是否降级发送 */
+    private final QualityController controller;
+
+    /** 每个块位置当前在查看器上是否为降级后的内容，需要在稳定后细化 */
+    private final boolean[] degraded;
+
+    /** 每个块位置最近一次内容变化的时间（纳秒） */
+    private final long[] changedAt;
+
+    /** 本帧内容变化的块序号 */
+    private final int[] changedTiles;
+
+    /** 估计颜色数的开放寻址表，颜色存入时最低位置1，0表示空位；只用于计数，合并最低位不影响判断 */
+    private final int[] colorTable = new int[256];
+
+    /** 调色板查找表的键，与{@link #paletteSlots}一一对应 */
+    private final int[] paletteKeys = new int[PALETTE_MAX_COLORS * 2];
+
+    /** 调色板查找表的值，即颜色在调色板中的序号，-1表示空位 */
+    private final int[] paletteSlots = new int[PALETTE_MAX_COLORS * 2];
+
+    /** 当前块的调色板 */
+    private final int[] palette = new int[PALETTE_MAX_COLORS];
+
+    private int paletteSize;
+
+    private byte[] buffer = new byte[64 * 1024];
+    private int size;
+    private int operations;
+
+    private int pixelTiles;
+    private int cacheHits;
+    private int fillTiles;
+    private int photoTiles;
+    private int paletteTiles;
+    private int degradedTiles;
+    private int refinedTiles;
+
+    /**
+     * @param width 屏幕宽度（设备像素）
+     * @param height 屏幕高度（设备像素）
+     * @param cacheBytes 查看器声明的缓存预算（字节）
+     * @param jpegEncoder 照片类块的编码器，为null时所有块都无损发送
+     * @param controller 质量控制器，提供JPEG质量和降级判断
+     */
+    TileFrameEncoder(int width, int height, long cacheBytes, JpegTileEncoder jpegEncoder,
+                     QualityController controller) {
+        this.jpegEncoder = jpegEncoder;
+        this.controller = controller;
+        this.width = width;
+        this.height = height;
+        this.columns = (width + TILE_SIZE - 1) / TILE_SIZE;
+        this.rows = (height + TILE_SIZE - 1) / TILE_SIZE;
+        this.previousHashes = new long[columns * rows];
+        this.degraded = new boolean[columns * rows];
+        this.changedAt = new long[columns * rows];
+        this.changedTiles = new int[columns * rows];
+        this.cacheSlots = slotCount(cacheBytes);
+    }
+
+    /**
+     * 按预算计算缓存槽位数，每个槽位可容纳一个完整的块
+     *
+     * @param cacheBytes 缓存预算（字节）
+     * @return 槽位数
+     */
+    static int slotCount(long cacheBytes) {
+        return (int) Math.min(Integer.MAX_VALUE, Math.max(0, cacheBytes) / (TILE_SIZE * TILE_SIZE * 4));
+    }
+
+    /**
+     * 编码一帧
+     * <p>
+     * 先找出内容变化的块，再由{@link QualityController}根据变化面积和链路状况决定本帧是否降级；
+     * 不降级的帧在最后附带细化：把已稳定{@link QualityController#REFINE_DELAY_NANOS}的降级块补发为完整内容
+     *
+     * @param rgbData 整屏ARGB像素，长度为宽x高
+     * @return 帧数据，没有块变化时返回null
+     */
+    byte[] encode(int[] rgbData) {
+        size = 0;
+        operations = 0;
+        pixelTiles = 0;
+        cacheHits = 0;
+        fillTiles = 0;
+        photoTiles = 0;
+        paletteTiles = 0;
+        degradedTiles = 0;
+        refinedTiles = 0;
+        putInt(TILE_SIZE);
+        putInt(0); // 操作数，编码完成后回填
+
+        long now = System.nanoTime();
+        int changed = 0;
+        for (int index = 0; index < previousHashes.length; index++) {
+            int x = index % columns * TILE_SIZE;
+            int y = index / columns * TILE_SIZE;
+            long hash = hashTile(rgbData, x, y, Math.min(TILE_SIZE, width - x), Math.min(TILE_SIZE, height - y));
+            if (hash == previousHashes[index]) continue;
+            previousHashes[index] = hash;
+            changedAt[index] = now;
+            changedTiles[changed++] = index;
+        }
+
+        boolean degrade = controller.onDamage(changed, previousHashes.length);
+        int quality = controller.getQuality();
+        for (int i = 0; i < changed; i++) {
+            putTile(rgbData, changedTiles[i], degrade, quality);
+        }
+
+        if (!degrade) {
+            for (int index = 0; index < degraded.length && refinedTiles < QualityController.REFINE_TILES_PER_FRAME; index++) {
+                if (degraded[index] && now - changedAt[index] >= QualityController.REFINE_DELAY_NANOS) {
+                    putTile(rgbData, index, false, QualityController.MAX_QUALITY);
+                    refinedTiles++;
+                }
+            }
+        }
+
+        if (operations == 0) return null;
+        writeInt(4, operations);
+        return Arrays.copyOf(buffer, size);
+    }
+
+    /**
+     * 写入一个块的操作
+     * <p>
+     * 纯色、渐变和缓存命中本身就是精确的，不需要降级；降级只替换原本要发送的完整像素，
+     * 改为RGB565，且不写入缓存，避免之后的缓存命中取到降级后的内容。
+     * 照片类块按给定质量编码，低于最高质量时同样不写入缓存并等待细化
+     *
+     * @param quality 照片类块的JPEG质量
+     */
+    private void putTile(int[] rgbData, int index, boolean degrade, int quality) {
+        int x = index % columns * TILE_SIZE;
+        int y = index / columns * TILE_SIZE;
+        int w = Math.min(TILE_SIZE, width - x);
+        int h = Math.min(TILE_SIZE, height - y);
+        long hash = previousHashes[index];
+        operations++;
+        degraded[index] = false;
+
+        byte fill = classifyTile(rgbData, x, y, w, h);
+        if (fill != OP_PIXELS) {
+            putFill(fill, index, rgbData, x, y, w, h);
+            fillTiles++;
+            return;
+        }
+
+        Integer cached = cacheSlots > 0 ? cache.get(hash) : null;
+        if (cached != null) {
+            putByte(OP_CACHE_HIT);
+            putInt(index);
+            putInt(cached);
+            cacheHits++;
+            return;
+        }
+
+        boolean photo = isPhotographic(rgbData, x, y, w, h);
+        if (!photo && buildPalette(rgbData, x, y, w, h) && paletteBytes(w, h) < w * h * 4) {
+            // 调色板是无损的，通常也比RGB565小，降级帧同样走这里
+            int slot = cacheSlots > 0 ? allocateSlot(hash) : -1;
+            putByte(OP_PALETTE);
+            putInt(index);
+            putInt(slot);
+            putPalette(rgbData, x, y, w, h);
+            paletteTiles++;
+            return;
+        }
+
+        if (degrade && !photo) {
+            putByte(OP_RGB565);
+            putInt(index);
+            putInt(-1);
+            putPixels565(rgbData, x, y, w, h);
+            degraded[index] = true;
+            degradedTiles++;
+            return;
+        }
+
+        byte[] jpeg = photo ? encodeJpeg(rgbData, x, y, w, h, quality) : null;
+        if (jpeg != null) {
+            boolean lowQuality = quality < QualityController.MAX_QUALITY;
+            putByte(OP_JPEG);
+            putInt(index);
+            putInt(lowQuality || cacheSlots == 0 ? -1 : allocateSlot(hash));
+            putInt(jpeg.length);
+            putBytes(jpeg);
+            degraded[index] = lowQuality;
+            photoTiles++;
+        } else {
+            int slot = cacheSlots > 0 ? allocateSlot(hash) : -1;
+            putByte(OP_PIXELS);
+            putInt(index);
+            putInt(slot);
+            putPixels(rgbData, x, y, w, h);
+            pixelTiles++;
+        }
+    }
+
+    /** 最近一帧以像素发送的块数 */
+    int getPixelTiles() {
+        return pixelTiles;
+    }
+
+    /** 最近一帧命中缓存的块数 */
+    int getCacheHits() {
+        return cacheHits;
+    }
+
+    /** 最近一帧以纯色或渐变命令发送的块数 */
+    int getFillTiles() {
+        return fillTiles;
+    }
+
+    /** 最近一帧以JPEG发送的块数 */
+    int getPhotoTiles() {
+        return photoTiles;
+    }
+
+    /** 最近一帧以调色板发送的块数 */
+    int getPaletteTiles() {
+        return paletteTiles;
+    }
+
+    /** 最近一帧以RGB565降级发送的块数，低质量JPEG块计入{@link #getPhotoTiles()} */
+    int getDegradedTiles() {
+        return degradedTiles;
+    }
+
+    /** 最近一帧补发完整内容的降级块数 */
+    int getRefinedTiles() {
+        return refinedTiles;
+    }
+
+    /**
+     * 判断块是否为照片类内容
+     * <p>
+     * 照片、地图底图和图表中的渐变区域颜色多且过渡平滑；文本即使有抗锯齿，颜色也不多，
+     * 而且字形边缘的亮度差很大。带透明度的块交给无损编码，JPEG无法保留透明通道
+     */
+    private boolean isPhotographic(int[] rgbData, int x, int y, int w, int h) {
+        if (jpegEncoder == null || w < 8 || h < 8) return false;
+
+        Arrays.fill(colorTable, 0);
+        int colors = 0;
+        int hardEdges = 0;
+        for (int row = 0; row < h; row++) {
+            int offset = (y + row) * width + x;
+            int previousLuma = -1;
+            for (int i = 0; i < w; i++) {
+                int pixel = rgbData[offset + i];
+                if ((pixel >>> 24) != 0xFF) return false;
+
+                if (colors < PHOTO_MIN_COLORS && insertColor(pixel)) colors++;
+
+                int luma = (((pixel >> 16) & 0xFF) * 77 + ((pixel >> 8) & 0xFF) * 150 + (pixel & 0xFF) * 29) >> 8;
+                if (previousLuma >= 0 && Math.abs(luma - previousLuma) > HARD_EDGE_LUMA) hardEdges++;
+                previousLuma = luma;
+            }
+        }
+        return colors >= PHOTO_MIN_COLORS && hardEdges <= PHOTO_MAX_HARD_EDGES * (w - 1) * h;
+    }
+
+    /** 把颜色放入颜色表，返回是否为新颜色 */
+    private boolean insertColor(int pixel) {
+        int key = pixel | 1;
+        int mask = colorTable.length - 1;
+        int slot = (key * 0x9E3779B9) >>> 24 & mask;
+        while (colorTable[slot] != 0) {
+            if (colorTable[slot] == key) return false;
+            slot = (slot + 1) & mask;
+        }
+        colorTable[slot] = key;
+        return true;
+    }
+
+    /**
+     * 建立块内调色板
+     * <p>
+     * 界面块中同色像素大多连续出现，与前一个像素相同时跳过查找
+     *
+     * @return 颜色数不超过{@link #PALETTE_MAX_COLORS}时返回true，调色板保存在{@link #palette}中
+     */
+    private boolean buildPalette(int[] rgbData, int x, int y, int w, int h) {
+        Arrays.fill(paletteSlots, -1);
+        paletteSize = 0;
+        for (int row = 0; row < h; row++) {
+            int offset = (y + row) * width + x;
+            int previous = rgbData[offset];
+            if (paletteIndex(previous) < 0 && !addPaletteColor(previous)) return false;
+            for (int i = 1; i < w; i++) {
+                int pixel = rgbData[offset + i];
+                if (pixel == previous) continue;
+                previous = pixel;
+                if (paletteIndex(pixel) < 0 && !addPaletteColor(pixel)) return false;
+            }
+        }
+        return true;
+    }
+
+    /** 查找颜色在调色板中的序号，不存在时返回-1 */
+    private int paletteIndex(int pixel) {
+        int mask = paletteSlots.length - 1;
+        int slot = (pixel * 0x9E3779B9) >>> 23 & mask;
+        while (paletteSlots[slot] >= 0) {
+            if (paletteKeys[slot] == pixel) return paletteSlots[slot];
+            slot = (slot + 1) & mask;
+        }
+        return -1;
+    }
+
+    /** 把新颜色加入调色板，已满时返回false */
+    private boolean addPaletteColor(int pixel) {
+        if (paletteSize == PALETTE_MAX_COLORS) return false;
+        int mask = paletteSlots.length - 1;
+        int slot = (pixel * 0x9E3779B9) >>> 23 & mask;
+        while (paletteSlots[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        paletteKeys[slot] = pixel;
+        paletteSlots[slot] = paletteSize;
+        palette[paletteSize++] = pixel;
+        return true;
+    }
+
+    /** 当前调色板下每个索引的位宽 */
+    private int paletteBits() {
+        if (paletteSize <= 2) return 1;
+        if (paletteSize <= 4) return 2;
+        if (paletteSize <= 16) return 4;
+        return 8;
+    }
+
+    /** 当前调色板编码一个块所需的字节数 */
+    private int paletteBytes(int w, int h) {
+        return 1 + paletteSize * 4 + (w * paletteBits() + 7) / 8 * h;
+    }
+
+    /** 写入颜色数、调色板和逐行打包的索引 */
+    private void putPalette(int[] rgbData, int x, int y, int w, int h) {
+        int bits = paletteBits();
+        putByte((byte) (paletteSize - 1));
+        for (int i = 0; i < paletteSize; i++) {
+            putInt(palette[i]);
+        }
+
+        ensureCapacity((w * bits + 7) / 8 * h);
+        for (int row = 0; row < h; row++) {
+            int offset = (y + row) * width + x;
+            int previous = rgbData[offset];
+            int index = paletteIndex(previous);
+            int packed = 0;
+            int filled = 0;
+            for (int i = 0; i < w; i++) {
+                int pixel = rgbData[offset + i];
+                if (pixel != previous) {
+                    previous = pixel;
+                    index = paletteIndex(pixel);
+                }
+                packed = packed << bits | index;
+                filled += bits;
+                if (filled == 8) {
+                    buffer[size++] = (byte) packed;
+                    packed = 0;
+                    filled = 0;
+                }
+            }
+            if (filled > 0) {
+                buffer[size++] = (byte) (packed << (8 - filled));
+            }
+        }
+    }
+
+    /** JPEG编码一个块，失败或压缩后不比原始像素小时返回null，改为无损发送 */
+    private byte[] encodeJpeg(int[] rgbData, int x, int y, int w, int h, int quality) {
+        try {
+            byte[] jpeg = jpegEncoder.encode(rgbData, width, x, y, w, h, quality);
+            return jpeg.length < w * h * 4 ? jpeg : null;
+        } catch (IOException e) {
+            System.err.println("⚠️  JPEG编码失败，改为无损发送: " + e.getMessage());
+            return null;
+        }
+    }
+
+    /**
+     * 判断块能否用填充命令表示
+     * <p>
+     * 依次检查每一行是否同色（纯色或竖直渐变）以及各行是否与第一行相同（水平渐变），遇到反例立即返回
+     *
+     * @return {@link #OP_FILL}、{@link #OP_GRADIENT_VERTICAL}、{@link #OP_GRADIENT_HORIZONTAL}，
+     *         都不满足时返回{@link #OP_PIXELS}
+     */
+    private byte classifyTile(int[] rgbData, int x, int y, int w, int h) {
+        int first = y * width + x;
+        boolean rowsUniform = true;
+        boolean rowsEqual = true;
+        for (int row = 0; row < h && (rowsUniform || rowsEqual); row++) {
+            int offset = (y + row) * width + x;
+            int color = rgbData[offset];
+            for (int i = 0; i < w; i++) {
+                int pixel = rgbData[offset + i];
+                if (rowsUniform && pixel != color) rowsUniform = false;
+                if (rowsEqual && pixel != rgbData[first + i]) rowsEqual = false;
+                if (!rowsUniform && !rowsEqual) return OP_PIXELS;
+            }
+        }
+        if (rowsUniform && rowsEqual) return OP_FILL;
+        if (rowsUniform) return OP_GRADIENT_VERTICAL;
+        if (rowsEqual) return OP_GRADIENT_HORIZONTAL;
+        return OP_PIXELS;
+    }
+
+    /** 写入填充命令，颜色取自块的第一列或第一行 */
+    private void putFill(byte op, int index, int[] rgbData, int x, int y, int w, int h) {
+        putByte(op);
+        putInt(index);
+        putInt(-1);
+        int first = y * width + x;
+        switch (op) {
+            case OP_FILL:
+                putInt(rgbData[first]);
+                break;
+            case OP_GRADIENT_VERTICAL:
+                for (int row = 0; row < h; row++) {
+                    putInt(rgbData[first + row * width]);
+                }
+                break;
+            default:
+                for (int i = 0; i < w; i++) {
+                    putInt(rgbData[first + i]);
+                }
+                break;
+        }
+    }
+
+    /** 为新内容分配槽位，缓存已满时复用最久未使用的槽位 */
+    private int allocateSlot(long hash) {
+        int slot;
+        if (cache.size() < cacheSlots) {
+            slot = cache.size();
+        } else {
+            Iterator<Map.Entry<Long, Integer>> eldest = cache.entrySet().iterator();
+            slot = eldest.next().getValue();
+            eldest.remove();
+        }
+        cache.put(hash, slot);
+        return slot;
+    }
+
+    /**
+     * 64位内容哈希，宽高参与计算，边缘块不会与同内容的完整块混淆
+     * <p>
+     * 0保留为"尚未发送"
+     */
+    private long hashTile(int[] rgbData, int x, int y, int w, int h) {
+        long hash = 0x9E3779B97F4A7C15L ^ ((long) w << 32 | h);
+        for (int row = 0; row < h; row++) {
+            int offset = (y + row) * width + x;
+            for (int i = 0; i < w; i++) {
+                hash = (hash ^ rgbData[offset + i]) * 0x100000001B3L;
+            }
+            hash ^= hash >>> 29;
+        }
+        hash ^= hash >>> 32;
+        return hash == 0 ? 1 : hash;
+    }
+
+    private void putPixels(int[] rgbData, int x, int y, int w, int h) {
+        ensureCapacity(w * h * 4);
+        for (int row = 0; row < h; row++) {
+            int offset = (y + row) * width + x;
+            for (int i = 0; i < w; i++) {
+                int pixel = rgbData[offset + i];
+                buffer[size]     = (byte) (pixel >>> 24); // Alpha通道
+                buffer[size + 1] = (byte) (pixel >>> 16); // Red通道
+                buffer[size + 2] = (byte) (pixel >>> 8);  // Green通道
+                buffer[size + 3] = (byte) pixel;          // Blue通道
+                size += 4;
+            }
+        }
+    }
+
+    private void putBytes(byte[] value) {
+        ensureCapacity(value.length);
+        System.arraycopy(value, 0, buffer, size, value.length);
+        size += value.length;
+    }
+
+    private void putPixels565(int[] rgbData, int x, int y, int w, int h) {
+        ensureCapacity(w * h * 2);
+        for (int row = 0; row < h; row++) {
+            int offset = (y + row) * width + x;
+            for (int i = 0; i < w; i++) {
+                int pixel = rgbData[offset + i];
+                int rgb565 = ((pixel >> 8) & 0xF800) | ((pixel >> 5) & 0x07E0) | ((pixel >> 3) & 0x001F);
+                buffer[size]     = (byte) (rgb565 >>> 8); // 高字节
+                buffer[size + 1] = (byte) rgb565;         // 低字节
+                size += 2;
+            }
+        }
+    }
+
+    private void putByte(byte value) {
+        ensureCapacity(1);
+        buffer[size++] = value;
+    }
+
+    private void putInt(int value) {
+        ensureCapacity(4);
+        writeInt(size, value);
+        size += 4;
+    }
+
+    private void writeInt(int position, int value) {
+        buffer[position]     = (byte) (value >>> 24);
+        buffer[position + 1] = (byte) (value >>> 16);
+        buffer[position + 2] = (byte) (value >>> 8);
+        buffer[position + 3] = (byte) value;
+    }
+
+    private void ensureCapacity(int extra) {
+        if (size + extra > buffer.length) {
+            buffer = Arrays.copyOf(buffer, Math.max(buffer.length * 2, size + extra));
+        }
+    }
+}
@@ -0,0 +1,189 @@
+package io.github.eurya.cacio;
+
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.lang.reflect.Field;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.MappedByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.charset.StandardCharsets;
+import java.util.concurrent.atomic.AtomicLong;
+
+import sun.misc.Unsafe;
+
+/**
+ * 跨进程追踪缓冲区的Agent端写入器
+ * <p>
+ * 应用进程创建的memfd在fork/exec后被JVM继承，启动器通过Agent参数trace=fd传入编号，
+ * 这里经/proc/self/fd映射其中的JVM区域，把捕获、编码、发送和输入分发的耗时写入共享内存，
+ * 应用进程导出时与启动器和查看器的事件合并到同一份追踪文件
+ * <p>
+ * 布局与app/src/main/cpp/trace_ring.hpp一致：槽位40字节，seq在写入期间为0，写完后为序号+1。
+ * ByteBuffer的写入没有顺序保证，JIT和ARM64都可能重排，seq置0之后和发布seq之前各插入一次
+ * {@link Unsafe#storeFence()}，保证读取端看到新seq时载荷已经写完、看到旧seq时写入尚未开始。
+ * 本模块以Java 8为目标，没有VarHandle；无法取得Unsafe时不启用追踪
+ * <p>
+ * 未启用时所有记录方法只做一次空判断
+ */
+public final class TraceRing {
+
+    /** 事件名称编号，与trace::Name一致 */
+    public static final int AGENT_CAPTURE = 10;
+    public static final int AGENT_ENCODE = 11;
+    public static final int AGENT_SEND = 12;
+    public static final int AGENT_DISPATCH = 13;
+    public static final int AGENT_SERVER_START = 14;
+
+    private static final int NAME_THREAD = 0;
+
+    private static final byte PHASE_COMPLETE = 'X';
+    private static final byte PHASE_THREAD_NAME = 'M';
+
+    private static final long FLOW_FRAME = 1L << 56;
+    private static final long FLOW_INPUT = 2L << 56;
+
+    private static final int MAGIC = 0x5254414d;
+    private static final int VERSION = 1;
+    private static final int REGION_JVM = 1;
+    private static final int HEADER_SIZE = 64;
+    private static final int REGION_HEADER_SIZE = 64;
+    private static final int SLOT_SIZE = 40;
+    private static final int THREAD_NAME_BYTES = 24;
+
+    /** 每个线程每写入这么多事件重新写一次线程名，避免线程名记录被环形缓冲区覆盖 */
+    private static final int THREAD_NAME_INTERVAL = 4096;
+
+    /** JVM区域的映射，null表示未启用 */
+    private static volatile ByteBuffer region;
+
+    private static int slots;
+
+    private static final AtomicLong next = new AtomicLong();
+
+    private static final ThreadLocal<int[]> threadEvents = ThreadLocal.withInitial(() -> new int[1]);
+
+    /** 提供写屏障，null时不启用追踪 */
+    private static final Unsafe UNSAFE = loadUnsafe();
+
+    private TraceRing() {
+    }
+
+    /**
+     * 映射追踪缓冲区
+     *
+     * @param fd 从应用进程继承的memfd编号，小于0时不启用
+     */
+    static void open(int fd) {
+        if (fd < 0) return;
+        if (UNSAFE == null) {
+            System.err.println("⚠️  无法获取写屏障，已禁用追踪");
+            return;
+        }
+
+        try (RandomAccessFile file = new RandomAccessFile("/proc/self/fd/" + fd, "rw")) {
+            FileChannel channel = file.getChannel();
+            ByteBuffer header = channel.map(FileChannel.MapMode.READ_ONLY, 0, HEADER_SIZE)
+                    .order(ByteOrder.nativeOrder());
+            if (header.getInt(0) != MAGIC || header.getInt(4) != VERSION) {
+                System.err.println("⚠️  追踪缓冲区格式不匹配，已禁用追踪");
+                return;
+            }
+            slots = header.getInt(8);
+
+            long regionSize = REGION_HEADER_SIZE + (long) slots * SLOT_SIZE;
+            MappedByteBuffer mapped = channel.map(FileChannel.MapMode.READ_WRITE,
+                    HEADER_SIZE + REGION_JVM * regionSize, regionSize);
+            // 映射在通道关闭后仍然有效
+            region = mapped.order(ByteOrder.nativeOrder());
+            System.out.println("📈 追踪已启用，缓冲区槽位: " + slots);
+        } catch (IOException | RuntimeException e) {
+            System.err.println("❌ 映射追踪缓冲区失败: " + e.getMessage());
+        }
+    }
+
+    /** 帧序号对应的流ID */
+    public static long frameFlow(long frameId) {
+        return FLOW_FRAME | frameId;
+    }
+
+    /** 输入序号对应的流ID */
+    public static long inputFlow(long inputId) {
+        return FLOW_INPUT | inputId;
+    }
+
+    /**
+     * 记录一段已完成的耗时
+     *
+     * @param name 事件名称编号
+     * @param startNs System.nanoTime得到的开始时间
+     * @param durationNs 持续时间
+     * @param flow 流ID，0表示不关联
+     */
+    public static void slice(int name, long startNs, long durationNs, long flow) {
+        ByteBuffer buffer = region;
+        if (buffer == null) return;
+
+        Thread thread = Thread.currentThread();
+        int tid = (int) thread.getId();
+        int[] count = threadEvents.get();
+        if (count[0]++ % THREAD_NAME_INTERVAL == 0) {
+            writeThreadName(buffer, tid, thread.getName());
+        }
+
+        long index = next.getAndIncrement();
+        int base = beginSlot(buffer, index);
+        buffer.putShort(base + 4, (short) name);
+        buffer.put(base + 6, PHASE_COMPLETE);
+        buffer.putInt(base + 8, tid);
+        buffer.putLong(base + 16, startNs);
+        buffer.putLong(base + 24, durationNs);
+        buffer.putLong(base + 32, flow);
+        commitSlot(buffer, base, index);
+    }
+
+    /** 线程名以UTF-8存放在ts/dur/flow的24字节中，按字符边界截断 */
+    private static void writeThreadName(ByteBuffer buffer, int tid, String name) {
+        byte[] bytes = name.getBytes(StandardCharsets.UTF_8);
+        for (int length = name.length(); bytes.length > THREAD_NAME_BYTES; length--) {
+            bytes = name.substring(0, length).getBytes(StandardCharsets.UTF_8);
+        }
+
+        long index = next.getAndIncrement();
+        int base = beginSlot(buffer, index);
+        buffer.putShort(base + 4, (short) NAME_THREAD);
+        buffer.put(base + 6, PHASE_THREAD_NAME);
+        buffer.putInt(base + 8, tid);
+        for (int i = 0; i < THREAD_NAME_BYTES; i++) {
+            buffer.put(base + 16 + i, i < bytes.length ? bytes[i] : 0);
+        }
+        commitSlot(buffer, base, index);
+    }
+
+    /** 把槽位的seq置0并清空保留字段，返回槽位偏移；屏障保证载荷的写入不会早于seq置0 */
+    private static int beginSlot(ByteBuffer buffer, long index) {
+        int base = REGION_HEADER_SIZE + (int) (index % slots) * SLOT_SIZE;
+        buffer.putInt(base, 0);
+        UNSAFE.storeFence();
+        buffer.put(base + 7, (byte) 0);
+        buffer.putInt(base + 12, 0);
+        return base;
+    }
+
+    /** 写入完成后以release语义发布seq，0保留给写入中的状态 */
+    private static void commitSlot(ByteBuffer buffer, int base, long index) {
+        int seq = (int) (index + 1);
+        UNSAFE.storeFence();
+        buffer.putInt(base, seq == 0 ? 1 : seq);
+    }
+
+    private static Unsafe loadUnsafe() {
+        try {
+            Field field = Unsafe.class.getDeclaredField("theUnsafe");
+            field.setAccessible(true);
+            return (Unsafe) field.get(null);
+        } catch (ReflectiveOperationException | RuntimeException e) {
+            return null;
+        }
+    }
+}
@@ -33,4 +33,17 @@ tasks.compileJava {
             "--add-opens=java.base/java.lang.reflect=ALL-UNNAMED"
         )
     )
-}
\ No newline at end of file
+}
+dependencies {
+    testImplementation(libs.junit)
+}
+
+/**
+ * Microbenchmark of the child window index with 100 toplevel windows,
+ * run with ./gradlew :cacio-shared:windowIndexBenchmark
+ */
+tasks.register<JavaExec>("windowIndexBenchmark") {
+    group = "verification"
+    classpath = sourceSets["test"].runtimeClasspath
+    mainClass.set("com.github.caciocavallosilano.cacio.peer.managed.ManagedWindowIndexBenchmark")
+}
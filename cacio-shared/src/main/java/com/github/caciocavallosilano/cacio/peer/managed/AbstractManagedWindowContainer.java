@@ -35,6 +35,7 @@ import java.awt.event.KeyEvent;
 import java.awt.geom.Rectangle2D;
 import java.util.LinkedList;
 import java.util.Iterator;
+import java.util.List;
 import com.github.caciocavallosilano.cacio.peer.CacioComponent;
 
 /**
@@ -51,12 +52,19 @@ abstract class AbstractManagedWindowContainer
      */
     private LinkedList<ManagedWindow> children;
 
+    /**
+     * Spatial index over the children, used for hit-testing and overlap
+     * queries. Kept in sync with {@link #children}.
+     */
+    private ManagedWindowIndex<ManagedWindow> childIndex;
+
     /**
      * Constructs a new instance of AbstractManagedWindowContainer that
      * uses the specified parent container.
      */
     protected AbstractManagedWindowContainer() {
         children = new LinkedList<ManagedWindow>();
+        childIndex = new ManagedWindowIndex<ManagedWindow>();
     }
 
     /**
@@ -68,6 +76,7 @@ abstract class AbstractManagedWindowContainer
     @Override
     public final void add(ManagedWindow child) {
         children.add(child);
+        childIndex.add(child);
 
         Iterator<ManagedWindow> i = children.descendingIterator();
         while (i.hasNext()) {
@@ -87,6 +96,7 @@ abstract class AbstractManagedWindowContainer
     @Override
     public final void remove(ManagedWindow child) {
         children.remove(child);
+        childIndex.remove(child);
 
         Iterator<ManagedWindow> i = children.descendingIterator();
         while (i.hasNext()) {
@@ -103,6 +113,23 @@ abstract class AbstractManagedWindowContainer
         return children;
     }
 
+    @Override
+    public final void childBoundsChanged(ManagedWindow child) {
+        childIndex.update(child);
+    }
+
+    @Override
+    public final List<ManagedWindow> getChildrenAbove(ManagedWindow child,
+                                                      Rectangle area) {
+        return childIndex.query(area, child);
+    }
+
+    @Override
+    public final boolean hasChildrenAbove(ManagedWindow child,
+                                          int x, int y, int w, int h) {
+        return childIndex.anyAbove(child, x, y, w, h);
+    }
+
     /**
      * Returns the location of the specified child window on screen.
      *
@@ -162,20 +189,9 @@ abstract class AbstractManagedWindowContainer
     }
 
     ManagedWindow findWindowAt(int x, int y) {
-        // Search from topmost to bottommost component and see if one matches.
-        Iterator<ManagedWindow> i = children.descendingIterator();
-        while (i.hasNext()) {
-            ManagedWindow child = i.next();
-            if (child.isVisible()) {
-                Rectangle b = child.getBounds();
-                if (x >= b.x && y >= b.y
-                    && x < (b.x + b.width) && y < (b.y + b.height)) {
-                    return child;
-                }
-            }
-        }
-        // If we reach here, we found no child at those coordinates.
-        return null;
+        // The index returns the topmost visible child at those coordinates,
+        // or null if there is none.
+        return childIndex.findAt(x, y);
     }
 
     @Override
@@ -189,11 +205,9 @@ abstract class AbstractManagedWindowContainer
         }
         // Repaint the correct rectangles for all visible children that
         // are inside this rectangle.
-        Iterator<ManagedWindow> i = children.descendingIterator();
         Rectangle rect = new Rectangle(x, y, w, h);
         Rectangle intersect = new Rectangle();
-        while (i.hasNext()) {
-            ManagedWindow child = i.next();
+        for (ManagedWindow child : childIndex.query(rect, null)) {
             if (child.isVisible()) {
                 Rectangle b = child.getBounds();
                 Rectangle2D.intersect(b, rect, intersect);
@@ -211,12 +225,9 @@ abstract class AbstractManagedWindowContainer
     private void repaintSelf(int x, int y, int w, int h) {
         Rectangle r = new Rectangle(x, y, w, h);
         LinkedList<Rectangle> rects = new LinkedList<Rectangle>();
-        for (ManagedWindow c : children) {
+        for (ManagedWindow c : childIndex.query(r, null)) {
             if (c.isVisible()) {
-                Rectangle b = c.getBounds();
-                if (b.intersects(r)) {
-                    rects.add(b);
-                }
+                rects.add(c.getBounds());
             }
         }
         Graphics2D g = getClippedGraphics(Color.WHITE, Color.WHITE,
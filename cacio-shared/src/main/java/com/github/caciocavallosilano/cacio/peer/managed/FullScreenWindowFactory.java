@@ -43,6 +43,12 @@ import sun.security.action.GetPropertyAction;
 public class FullScreenWindowFactory implements PlatformWindowFactory {
 
     private static final Dimension screenSize;
+
+    /**
+     * The UI scale factor, i.e. the number of device pixels per logical
+     * (user space) pixel. The screen size above is in logical pixels.
+     */
+    private static final double uiScale;
     static {
         String size = AccessController.doPrivileged(
                 new GetPropertyAction("cacio.managed.screensize", "1024x768"));
@@ -50,6 +56,16 @@ public class FullScreenWindowFactory implements PlatformWindowFactory {
         int width = Integer.parseInt(size.substring(0, x));
         int height = Integer.parseInt(size.substring(x + 1));
         screenSize = new Dimension(width, height);
+
+        String scale = AccessController.doPrivileged(
+                new GetPropertyAction("cacio.managed.uiscale", "1"));
+        double s;
+        try {
+            s = Double.parseDouble(scale);
+        } catch (NumberFormatException ex) {
+            s = 1;
+        }
+        uiScale = s > 0 ? s : 1;
     }
 
     /**
@@ -178,6 +194,19 @@ public class FullScreenWindowFactory implements PlatformWindowFactory {
         return screenSize;
     }
 
+    public static double getUIScale() {
+        return uiScale;
+    }
+
+    /**
+     * Returns the size of the screen in device pixels, that is the logical
+     * screen size multiplied by the UI scale.
+     */
+    public static Dimension getDeviceScreenDimension() {
+        return new Dimension((int) Math.ceil(screenSize.width * uiScale),
+                             (int) Math.ceil(screenSize.height * uiScale));
+    }
+
     /**
      * Default implementation for the PlatformScreenSelector. Just return
      * the single screen instance we have.
@@ -46,7 +46,6 @@ import java.awt.event.PaintEvent;
 import java.awt.peer.ContainerPeer;
 import java.awt.image.ColorModel;
 import java.util.Deque;
-import java.util.Iterator;
 import java.util.LinkedList;
 import java.util.List;
 
@@ -60,7 +59,7 @@ import sun.java2d.pipe.Region;
  */
 class ManagedWindow
     extends AbstractManagedWindowContainer
-    implements PlatformToplevelWindow {
+    implements PlatformToplevelWindow, ManagedWindowIndex.Indexable {
 
     /**
      * The parent container.
@@ -185,18 +184,9 @@ class ManagedWindow
             if (clipRects == null) {
                 clipRects = new LinkedList<Rectangle>();
             }
-            Iterator<ManagedWindow> i = siblings.descendingIterator();
-            Rectangle myBounds = getBounds();
-            while (i.hasNext()) {
-                ManagedWindow sibling = i.next();
-                if (sibling == this) {
-                    break;
-                }
+            for (ManagedWindow sibling : parent.getChildrenAbove(this, getBounds())) {
                 if (sibling.isVisible()) {
-                    Rectangle bounds = sibling.getBounds();
-                    if (bounds.intersects(myBounds)) {
-                        clipRects.add(bounds);
-                    }
+                    clipRects.add(sibling.getBounds());
                 }
             }
         }
@@ -232,6 +222,7 @@ class ManagedWindow
         this.y = y;
         this.width = width;
         this.height = height;
+        parent.childBoundsChanged(this);
         // TODO: We brute-force repaint everything that could be damaged.
         // Make this a little more intelligent.
 
@@ -292,20 +283,8 @@ class ManagedWindow
     }
 
     private boolean hasOverlappingSiblings(int x, int y, int w, int h) {
-        Deque<ManagedWindow> siblings = getParent().getChildren();
-        boolean hasOverlappingSiblings = false;
-        Rectangle myBounds = new Rectangle(x, y, w, h);
         // Only windows that are 'over' the target region can be overlapping.
-        Iterator<ManagedWindow> descIter = siblings.descendingIterator();
-        while (descIter.hasNext() && ! hasOverlappingSiblings) {
-            ManagedWindow sibling = descIter.next();
-            if (sibling == this) {
-                break;
-            }
-            Rectangle siblingBounds = sibling.getBounds();
-            hasOverlappingSiblings = myBounds.intersects(siblingBounds);
-        }
-        return hasOverlappingSiblings;
+        return getParent().hasChildrenAbove(this, x, y, w, h);
     }
 
     @Override
@@ -379,7 +358,8 @@ class ManagedWindow
         }
     }
 
-    boolean isVisible() {
+    @Override
+    public boolean isVisible() {
         return visible;
     }
 
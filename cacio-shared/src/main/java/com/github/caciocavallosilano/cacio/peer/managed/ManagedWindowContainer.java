@@ -61,6 +61,43 @@ interface ManagedWindowContainer {
 
     Deque<ManagedWindow> getChildren();
 
+    /**
+     * Notifies this container that the bounds of the specified child
+     * window have changed, so that hit-testing and overlap queries
+     * stay correct.
+     *
+     * @param child the child window that has been moved or resized
+     */
+    void childBoundsChanged(ManagedWindow child);
+
+    /**
+     * Returns the child windows that are stacked above the specified child
+     * and intersect the specified area, topmost first. The visibility of
+     * the returned windows is not checked.
+     *
+     * @param child the reference child, or {@code null} for all children
+     * @param area the area in the coordinate space of this container
+     *
+     * @return the overlapping children above {@code child}
+     */
+    List<ManagedWindow> getChildrenAbove(ManagedWindow child, Rectangle area);
+
+    /**
+     * Returns whether any child window stacked above the specified child
+     * intersects the specified area. Unlike
+     * {@link #getChildrenAbove(ManagedWindow, Rectangle)} this does not
+     * allocate and stops at the first overlapping child.
+     *
+     * @param child the reference child, or {@code null} for all children
+     * @param x the X coordinate of the area in this container
+     * @param y the Y coordinate of the area in this container
+     * @param w the width of the area
+     * @param h the height of the area
+     *
+     * @return {@code true} if a child above {@code child} overlaps the area
+     */
+    boolean hasChildrenAbove(ManagedWindow child, int x, int y, int w, int h);
+
     /**
      * Returns the location of the specified child window relative to
      * the screen (== outermost container).
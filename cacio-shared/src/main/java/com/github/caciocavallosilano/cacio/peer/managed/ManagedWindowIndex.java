@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package com.github.caciocavallosilano.cacio.peer.managed;
+
+import java.awt.Rectangle;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.Comparator;
+import java.util.IdentityHashMap;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * A z-ordered uniform grid over the child windows of a
+ * {@link ManagedWindowContainer}. Each child is registered in all grid
+ * cells its bounds touch, so point and rectangle queries only look at
+ * the few windows near the query location instead of scanning all
+ * children.
+ *
+ * The z-order of a child is the order in which it was added, which
+ * mirrors the order of the container's child list (topmost last).
+ *
+ * The index only needs the bounds and visibility of its windows, so it
+ * does not depend on the toolkit and can be benchmarked on its own.
+ * {@link #findAt} and {@link #anyAbove} run on every mouse event and
+ * obscurity check and do not allocate.
+ *
+ * @param <W> the type of the indexed windows
+ */
+final class ManagedWindowIndex<W extends ManagedWindowIndex.Indexable> {
+
+    /**
+     * What the index needs to know about a window.
+     */
+    interface Indexable {
+
+        /**
+         * Returns the bounds of the window in the coordinate space of its
+         * container.
+         */
+        Rectangle getBounds();
+
+        boolean isVisible();
+    }
+
+    /**
+     * The size of a grid cell is 1 << CELL_SHIFT pixels.
+     */
+    private static final int CELL_SHIFT = 7;
+
+    /**
+     * Windows covering more cells than this are not put into the grid,
+     * but are kept in a separate list that is checked on every query.
+     */
+    private static final int MAX_CELLS = 1024;
+
+    private static final Comparator<Entry<?>> TOPMOST_FIRST =
+        new Comparator<Entry<?>>() {
+            @Override
+            public int compare(Entry<?> e1, Entry<?> e2) {
+                return Long.compare(e2.z, e1.z);
+            }
+        };
+
+    /**
+     * The index data of a single child window.
+     */
+    private static final class Entry<W> {
+        final W window;
+        final long z;
+        int x, y, width, height;
+        int cx0, cy0, cx1, cy1;
+        boolean large;
+
+        Entry(W w, long z) {
+            window = w;
+            this.z = z;
+        }
+
+        boolean contains(int px, int py) {
+            return px >= x && py >= y && px < x + width && py < y + height;
+        }
+
+        boolean intersects(int rx, int ry, int rw, int rh) {
+            return rw > 0 && rh > 0 && width > 0 && height > 0
+                   && rx < x + width && x < rx + rw
+                   && ry < y + height && y < ry + rh;
+        }
+    }
+
+    private final CellMap<W> cells = new CellMap<W>();
+
+    private final List<Entry<W>> largeEntries = new ArrayList<Entry<W>>();
+
+    /**
+     * All entries in z-order, bottommost first.
+     */
+    private final List<Entry<W>> stack = new ArrayList<Entry<W>>();
+
+    private final Map<W, Entry<W>> entries = new IdentityHashMap<W, Entry<W>>();
+
+    private long nextZ;
+
+    /**
+     * Adds a window on top of all other windows.
+     */
+    void add(W w) {
+        Entry<W> e = new Entry<W>(w, nextZ++);
+        entries.put(w, e);
+        stack.add(e);
+        insert(e);
+    }
+
+    void remove(W w) {
+        Entry<W> e = entries.remove(w);
+        if (e != null) {
+            stack.remove(e);
+            erase(e);
+        }
+    }
+
+    /**
+     * Must be called whenever the bounds of an indexed window change.
+     */
+    void update(W w) {
+        Entry<W> e = entries.get(w);
+        if (e != null) {
+            erase(e);
+            insert(e);
+        }
+    }
+
+    /**
+     * Returns the topmost visible window containing the specified point,
+     * or {@code null} if there is none.
+     */
+    W findAt(int x, int y) {
+        Entry<W> best = null;
+        List<Entry<W>> cell = cells.get(key(x >> CELL_SHIFT, y >> CELL_SHIFT));
+        if (cell != null) {
+            for (int i = 0, n = cell.size(); i < n; i++) {
+                Entry<W> e = cell.get(i);
+                if ((best == null || e.z > best.z) && e.contains(x, y)
+                    && e.window.isVisible()) {
+                    best = e;
+                }
+            }
+        }
+        for (int i = 0, n = largeEntries.size(); i < n; i++) {
+            Entry<W> e = largeEntries.get(i);
+            if ((best == null || e.z > best.z) && e.contains(x, y)
+                && e.window.isVisible()) {
+                best = e;
+            }
+        }
+        return best != null ? best.window : null;
+    }
+
+    /**
+     * Returns whether any window stacked above {@code below} intersects the
+     * specified area. This is {@code !query(area, below).isEmpty()} without
+     * collecting and sorting the windows, and stops at the first hit.
+     * Visibility is not checked.
+     */
+    boolean anyAbove(W below, int x, int y, int width, int height) {
+        if (width <= 0 || height <= 0) {
+            return false;
+        }
+        long minZ = minZ(below);
+        int cx0 = x >> CELL_SHIFT;
+        int cy0 = y >> CELL_SHIFT;
+        int cx1 = (x + width - 1) >> CELL_SHIFT;
+        int cy1 = (y + height - 1) >> CELL_SHIFT;
+        if ((long) (cx1 - cx0 + 1) * (cy1 - cy0 + 1) > cells.size()) {
+            // Walk down from the topmost window, nothing below minZ counts.
+            for (int i = stack.size() - 1; i >= 0; i--) {
+                Entry<W> e = stack.get(i);
+                if (e.z <= minZ) {
+                    return false;
+                }
+                if (e.intersects(x, y, width, height)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                List<Entry<W>> cell = cells.get(key(cx, cy));
+                if (cell == null) {
+                    continue;
+                }
+                for (int i = 0, n = cell.size(); i < n; i++) {
+                    Entry<W> e = cell.get(i);
+                    if (e.z > minZ && e.intersects(x, y, width, height)) {
+                        return true;
+                    }
+                }
+            }
+        }
+        for (int i = 0, n = largeEntries.size(); i < n; i++) {
+            Entry<W> e = largeEntries.get(i);
+            if (e.z > minZ && e.intersects(x, y, width, height)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Returns all windows intersecting the specified area that are stacked
+     * above {@code below}, topmost first. If {@code below} is {@code null},
+     * all intersecting windows are returned. Visibility is not checked.
+     */
+    List<W> query(Rectangle area, W below) {
+        if (area.width <= 0 || area.height <= 0) {
+            return Collections.emptyList();
+        }
+        long minZ = minZ(below);
+        List<Entry<W>> found = new ArrayList<Entry<W>>();
+        int cx0 = area.x >> CELL_SHIFT;
+        int cy0 = area.y >> CELL_SHIFT;
+        int cx1 = (area.x + area.width - 1) >> CELL_SHIFT;
+        int cy1 = (area.y + area.height - 1) >> CELL_SHIFT;
+        if ((long) (cx1 - cx0 + 1) * (cy1 - cy0 + 1) > cells.size()) {
+            // Cheaper to look at every entry than at every covered cell.
+            for (int i = stack.size() - 1; i >= 0; i--) {
+                Entry<W> e = stack.get(i);
+                if (e.z <= minZ) {
+                    break;
+                }
+                if (e.intersects(area.x, area.y, area.width, area.height)) {
+                    found.add(e);
+                }
+            }
+        } else {
+            for (int cy = cy0; cy <= cy1; cy++) {
+                for (int cx = cx0; cx <= cx1; cx++) {
+                    List<Entry<W>> cell = cells.get(key(cx, cy));
+                    if (cell == null) {
+                        continue;
+                    }
+                    for (int i = 0, n = cell.size(); i < n; i++) {
+                        Entry<W> e = cell.get(i);
+                        // An entry is in every cell it overlaps, report it
+                        // only from the first of those inside the area.
+                        if (e.z > minZ
+                            && cx == Math.max(e.cx0, cx0)
+                            && cy == Math.max(e.cy0, cy0)
+                            && e.intersects(area.x, area.y, area.width, area.height)) {
+                            found.add(e);
+                        }
+                    }
+                }
+            }
+            for (int i = 0, n = largeEntries.size(); i < n; i++) {
+                Entry<W> e = largeEntries.get(i);
+                if (e.z > minZ && e.intersects(area.x, area.y, area.width, area.height)) {
+                    found.add(e);
+                }
+            }
+            Collections.sort(found, TOPMOST_FIRST);
+        }
+        List<W> windows = new ArrayList<W>(found.size());
+        for (int i = 0, n = found.size(); i < n; i++) {
+            windows.add(found.get(i).window);
+        }
+        return windows;
+    }
+
+    /**
+     * Returns the z stamp above which windows are stacked over
+     * {@code below}, or the lowest possible value if {@code below} is
+     * {@code null} or not indexed.
+     */
+    private long minZ(W below) {
+        if (below != null) {
+            Entry<W> b = entries.get(below);
+            if (b != null) {
+                return b.z;
+            }
+        }
+        return Long.MIN_VALUE;
+    }
+
+    private void insert(Entry<W> e) {
+        Rectangle b = e.window.getBounds();
+        e.x = b.x;
+        e.y = b.y;
+        e.width = b.width;
+        e.height = b.height;
+        e.large = false;
+        if (b.width <= 0 || b.height <= 0) {
+            // Empty windows can never be hit, keep them out of the grid.
+            e.cx0 = e.cy0 = 0;
+            e.cx1 = e.cy1 = -1;
+            return;
+        }
+        e.cx0 = b.x >> CELL_SHIFT;
+        e.cy0 = b.y >> CELL_SHIFT;
+        e.cx1 = (b.x + b.width - 1) >> CELL_SHIFT;
+        e.cy1 = (b.y + b.height - 1) >> CELL_SHIFT;
+        if ((long) (e.cx1 - e.cx0 + 1) * (e.cy1 - e.cy0 + 1) > MAX_CELLS) {
+            e.large = true;
+            largeEntries.add(e);
+            return;
+        }
+        for (int cy = e.cy0; cy <= e.cy1; cy++) {
+            for (int cx = e.cx0; cx <= e.cx1; cx++) {
+                cells.getOrCreate(key(cx, cy)).add(e);
+            }
+        }
+    }
+
+    private void erase(Entry<W> e) {
+        if (e.large) {
+            largeEntries.remove(e);
+            return;
+        }
+        for (int cy = e.cy0; cy <= e.cy1; cy++) {
+            for (int cx = e.cx0; cx <= e.cx1; cx++) {
+                long k = key(cx, cy);
+                List<Entry<W>> cell = cells.get(k);
+                if (cell != null) {
+                    cell.remove(e);
+                    if (cell.isEmpty()) {
+                        cells.remove(k);
+                    }
+                }
+            }
+        }
+    }
+
+    private static long key(int cx, int cy) {
+        return ((long) cx << 32) | (cy & 0xffffffffL);
+    }
+
+    /**
+     * Open addressing hash map from cell keys to the entries in that cell.
+     * Unlike a {@code HashMap<Long, ...>} lookups do not box the key.
+     */
+    private static final class CellMap<W> {
+
+        private long[] keys = new long[64];
+
+        private List<Entry<W>>[] values = newValues(64);
+
+        private int size;
+
+        int size() {
+            return size;
+        }
+
+        List<Entry<W>> get(long key) {
+            int mask = keys.length - 1;
+            for (int i = slot(key, mask); values[i] != null; i = (i + 1) & mask) {
+                if (keys[i] == key) {
+                    return values[i];
+                }
+            }
+            return null;
+        }
+
+        List<Entry<W>> getOrCreate(long key) {
+            List<Entry<W>> cell = get(key);
+            if (cell == null) {
+                if ((size + 1) * 2 > keys.length) {
+                    resize(keys.length * 2);
+                }
+                cell = new ArrayList<Entry<W>>(4);
+                put(key, cell);
+                size++;
+            }
+            return cell;
+        }
+
+        void remove(long key) {
+            int mask = keys.length - 1;
+            int i = slot(key, mask);
+            while (values[i] != null && keys[i] != key) {
+                i = (i + 1) & mask;
+            }
+            if (values[i] == null) {
+                return;
+            }
+            // Backward shift deletion keeps probe sequences intact
+            // without tombstones.
+            values[i] = null;
+            size--;
+            for (int j = (i + 1) & mask; values[j] != null; j = (j + 1) & mask) {
+                int home = slot(keys[j], mask);
+                if (((j - home) & mask) >= ((j - i) & mask)) {
+                    keys[i] = keys[j];
+                    values[i] = values[j];
+                    values[j] = null;
+                    i = j;
+                }
+            }
+        }
+
+        private void put(long key, List<Entry<W>> cell) {
+            int mask = keys.length - 1;
+            int i = slot(key, mask);
+            while (values[i] != null) {
+                i = (i + 1) & mask;
+            }
+            keys[i] = key;
+            values[i] = cell;
+        }
+
+        private void resize(int capacity) {
+            long[] oldKeys = keys;
+            List<Entry<W>>[] oldValues = values;
+            keys = new long[capacity];
+            values = newValues(capacity);
+            for (int i = 0; i < oldKeys.length; i++) {
+                if (oldValues[i] != null) {
+                    put(oldKeys[i], oldValues[i]);
+                }
+            }
+        }
+
+        private static int slot(long key, int mask) {
+            long h = key * 0x9E3779B97F4A7C15L;
+            return (int) (h >>> 32) & mask;
+        }
+
+        @SuppressWarnings("unchecked")
+        private static <W> List<Entry<W>>[] newValues(int capacity) {
+            return (List<Entry<W>>[]) new List[capacity];
+        }
+    }
+}
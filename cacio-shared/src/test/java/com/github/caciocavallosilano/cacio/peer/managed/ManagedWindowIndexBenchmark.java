@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package com.github.caciocavallosilano.cacio.peer.managed;
+
+import java.awt.Rectangle;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Random;
+
+import com.github.caciocavallosilano.cacio.peer.managed.ManagedWindowIndexTest.TestWindow;
+
+/**
+ * Microbenchmark of the obscurity check and hit-testing with 100
+ * toplevel windows, compared to the linear scan over the child list
+ * that {@link ManagedWindowIndex} replaced.
+ *
+ * Run with {@code ./gradlew :cacio-shared:windowIndexBenchmark}.
+ */
+public class ManagedWindowIndexBenchmark {
+
+    private static final int WINDOWS = 100;
+
+    private static final int SCREEN_WIDTH = 1920;
+
+    private static final int SCREEN_HEIGHT = 1080;
+
+    private static final int QUERIES = 1 << 12;
+
+    private static final int ROUNDS = 2000;
+
+    private static volatile long sink;
+
+    public static void main(String[] args) {
+        Random random = new Random(1);
+        ManagedWindowIndex<TestWindow> index =
+            new ManagedWindowIndex<TestWindow>();
+        List<TestWindow> stack = new ArrayList<TestWindow>();
+        for (int i = 0; i < WINDOWS; i++) {
+            int w = 200 + random.nextInt(400);
+            int h = 150 + random.nextInt(300);
+            TestWindow window = new TestWindow(random.nextInt(SCREEN_WIDTH - w),
+                                               random.nextInt(SCREEN_HEIGHT - h),
+                                               w, h);
+            stack.add(window);
+            index.add(window);
+        }
+
+        // Repaint areas of the size of a typical damaged component.
+        final TestWindow[] below = new TestWindow[QUERIES];
+        final int[] xs = new int[QUERIES];
+        final int[] ys = new int[QUERIES];
+        final int[] ws = new int[QUERIES];
+        final int[] hs = new int[QUERIES];
+        for (int i = 0; i < QUERIES; i++) {
+            below[i] = stack.get(random.nextInt(WINDOWS));
+            Rectangle b = below[i].bounds;
+            ws[i] = 1 + random.nextInt(Math.min(b.width, 120));
+            hs[i] = 1 + random.nextInt(Math.min(b.height, 40));
+            xs[i] = b.x + random.nextInt(b.width - ws[i] + 1);
+            ys[i] = b.y + random.nextInt(b.height - hs[i] + 1);
+        }
+
+        System.out.println("ManagedWindowIndex, " + WINDOWS + " toplevel windows, "
+                           + QUERIES + " queries per round");
+        for (int pass = 0; pass < 2; pass++) {
+            // The first pass is JIT warm-up.
+            boolean report = pass == 1;
+            run("anyAbove", report, () -> {
+                long hits = 0;
+                for (int i = 0; i < QUERIES; i++) {
+                    if (index.anyAbove(below[i], xs[i], ys[i], ws[i], hs[i])) {
+                        hits++;
+                    }
+                }
+                return hits;
+            });
+            run("query().isEmpty()", report, () -> {
+                long hits = 0;
+                for (int i = 0; i < QUERIES; i++) {
+                    Rectangle area = new Rectangle(xs[i], ys[i], ws[i], hs[i]);
+                    if (!index.query(area, below[i]).isEmpty()) {
+                        hits++;
+                    }
+                }
+                return hits;
+            });
+            run("linear scan", report, () -> {
+                long hits = 0;
+                for (int i = 0; i < QUERIES; i++) {
+                    Rectangle area = new Rectangle(xs[i], ys[i], ws[i], hs[i]);
+                    for (int j = stack.size() - 1; j >= 0; j--) {
+                        TestWindow w = stack.get(j);
+                        if (w == below[i]) {
+                            break;
+                        }
+                        if (w.getBounds().intersects(area)) {
+                            hits++;
+                            break;
+                        }
+                    }
+                }
+                return hits;
+            });
+            run("findAt", report, () -> {
+                long hits = 0;
+                for (int i = 0; i < QUERIES; i++) {
+                    if (index.findAt(xs[i], ys[i]) != null) {
+                        hits++;
+                    }
+                }
+                return hits;
+            });
+        }
+    }
+
+    interface Body {
+        long run();
+    }
+
+    private static void run(String name, boolean report, Body body) {
+        long start = System.nanoTime();
+        for (int round = 0; round < ROUNDS; round++) {
+            sink += body.run();
+        }
+        long elapsed = System.nanoTime() - start;
+        if (report) {
+            System.out.printf("%-20s %8.1f ns/query%n", name,
+                              (double) elapsed / ROUNDS / QUERIES);
+        }
+    }
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.  Oracle designates this
+ * particular file as subject to the "Classpath" exception as provided
+ * by Oracle in the LICENSE file that accompanied this code.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+package com.github.caciocavallosilano.cacio.peer.managed;
+
+import java.awt.Rectangle;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Random;
+
+import org.junit.Test;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertSame;
+
+/**
+ * Checks {@link ManagedWindowIndex} against a linear scan over the
+ * windows in stacking order, which is what the index replaced.
+ */
+public class ManagedWindowIndexTest {
+
+    /**
+     * A window that only has bounds and visibility.
+     */
+    static final class TestWindow implements ManagedWindowIndex.Indexable {
+        final Rectangle bounds;
+        boolean visible = true;
+
+        TestWindow(int x, int y, int w, int h) {
+            bounds = new Rectangle(x, y, w, h);
+        }
+
+        @Override
+        public Rectangle getBounds() {
+            return new Rectangle(bounds);
+        }
+
+        @Override
+        public boolean isVisible() {
+            return visible;
+        }
+    }
+
+    @Test
+    public void matchesLinearScan() {
+        Random random = new Random(42);
+        ManagedWindowIndex<TestWindow> index =
+            new ManagedWindowIndex<TestWindow>();
+        List<TestWindow> stack = new ArrayList<TestWindow>();
+        for (int round = 0; round < 2000; round++) {
+            int op = random.nextInt(10);
+            if (op < 3 || stack.isEmpty()) {
+                TestWindow w = randomWindow(random);
+                stack.add(w);
+                index.add(w);
+            } else if (op < 4) {
+                TestWindow w = stack.remove(random.nextInt(stack.size()));
+                index.remove(w);
+            } else if (op < 6) {
+                TestWindow w = stack.get(random.nextInt(stack.size()));
+                w.bounds.setBounds(randomWindow(random).bounds);
+                index.update(w);
+            } else if (op < 7) {
+                stack.get(random.nextInt(stack.size())).visible ^= true;
+            }
+            check(index, stack, random);
+        }
+    }
+
+    @Test
+    public void largeAndEmptyWindows() {
+        ManagedWindowIndex<TestWindow> index =
+            new ManagedWindowIndex<TestWindow>();
+        List<TestWindow> stack = new ArrayList<TestWindow>();
+        TestWindow[] windows = {
+            new TestWindow(-50, -50, 8000, 8000),
+            new TestWindow(100, 100, 0, 50),
+            new TestWindow(-300, 200, 260, 90),
+            new TestWindow(0, 0, 5000, 5000),
+            new TestWindow(120, 130, 10, 10)
+        };
+        for (TestWindow w : windows) {
+            stack.add(w);
+            index.add(w);
+        }
+        check(index, stack, new Random(7));
+        assertSame(windows[4], index.findAt(125, 135));
+        assertSame(windows[3], index.findAt(100, 100));
+        assertSame(windows[0], index.findAt(-10, -10));
+    }
+
+    private static void check(ManagedWindowIndex<TestWindow> index,
+                              List<TestWindow> stack, Random random) {
+        for (int i = 0; i < 20; i++) {
+            int x = random.nextInt(2400) - 200;
+            int y = random.nextInt(1600) - 200;
+            assertSame(findAt(stack, x, y), index.findAt(x, y));
+
+            // Mostly small areas, sometimes one larger than the grid.
+            int w = random.nextInt(4) == 0 ? random.nextInt(4000) : random.nextInt(300);
+            int h = random.nextInt(4) == 0 ? random.nextInt(4000) : random.nextInt(300);
+            Rectangle area = new Rectangle(x, y, w, h);
+            TestWindow below = stack.isEmpty() || random.nextInt(5) == 0
+                ? null : stack.get(random.nextInt(stack.size()));
+            List<TestWindow> expected = above(stack, below, area);
+            assertEquals(expected, index.query(area, below));
+            assertEquals(!expected.isEmpty(), index.anyAbove(below, x, y, w, h));
+        }
+    }
+
+    private static TestWindow randomWindow(Random random) {
+        return new TestWindow(random.nextInt(2200) - 200,
+                              random.nextInt(1400) - 200,
+                              random.nextInt(10) == 0 ? 0 : 1 + random.nextInt(900),
+                              1 + random.nextInt(700));
+    }
+
+    private static TestWindow findAt(List<TestWindow> stack, int x, int y) {
+        for (int i = stack.size() - 1; i >= 0; i--) {
+            TestWindow w = stack.get(i);
+            if (w.visible && w.bounds.contains(x, y)) {
+                return w;
+            }
+        }
+        return null;
+    }
+
+    private static List<TestWindow> above(List<TestWindow> stack,
+                                          TestWindow below, Rectangle area) {
+        List<TestWindow> result = new ArrayList<TestWindow>();
+        for (int i = stack.size() - 1; i >= 0; i--) {
+            TestWindow w = stack.get(i);
+            if (w == below) {
+                break;
+            }
+            if (!w.bounds.isEmpty() && w.bounds.intersects(area)) {
+                result.add(w);
+            }
+        }
+        return result;
+    }
+}
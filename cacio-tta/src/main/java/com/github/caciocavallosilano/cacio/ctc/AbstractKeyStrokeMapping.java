@@ -31,6 +31,9 @@ import static java.awt.event.KeyEvent.VK_ESCAPE;
 import static java.awt.event.KeyEvent.VK_TAB;
 
 import java.awt.AWTKeyStroke;
+import java.awt.event.InputEvent;
+import java.awt.event.KeyEvent;
+import java.util.Arrays;
 import java.util.HashMap;
 import java.util.Map;
 
@@ -38,6 +41,21 @@ abstract class AbstractKeyStrokeMapping implements KeyStrokeMapping {
 
     static final int NO_MASK = 0;
 
+    private static final int STATE_SHIFT = 1;
+    private static final int STATE_CTRL = 2;
+    private static final int STATE_META = 4;
+    private static final int STATE_ALT = 8;
+    private static final int STATE_ALT_GRAPH = 16;
+    private static final int STATE_COUNT = 32;
+
+    /**
+     * Dense lookup table, indexed by modifier state and then by key code.
+     * Rows for modifier states without any mapping are null. Filled once
+     * by {@link #compile(Map)}, so that {@link #getKeyChar(int, int)} needs
+     * neither an AWTKeyStroke lookup nor boxing.
+     */
+    private char[][] table = new char[STATE_COUNT][];
+
     Map<AWTKeyStroke,Character> getDefaultMap() {
         Map<AWTKeyStroke,Character> map = new HashMap<AWTKeyStroke,Character>();
         map.put(keyStroke(VK_BACK_SPACE, NO_MASK), '\b');
@@ -49,6 +67,63 @@ abstract class AbstractKeyStrokeMapping implements KeyStrokeMapping {
         return map;
     }
 
+    /**
+     * Compiles the keystroke definitions of a layout into the dense
+     * lookup table. Subclasses call this at the end of their constructor.
+     */
+    @SuppressWarnings("deprecation")
+    void compile(Map<AWTKeyStroke,Character> map) {
+        int maxKeyCode = 0;
+        for (AWTKeyStroke stroke : map.keySet()) {
+            maxKeyCode = Math.max(maxKeyCode, stroke.getKeyCode());
+        }
+        char[][] t = new char[STATE_COUNT][];
+        for (Map.Entry<AWTKeyStroke,Character> e : map.entrySet()) {
+            AWTKeyStroke stroke = e.getKey();
+            int state = modifierState(stroke.getModifiers());
+            if (t[state] == null) {
+                t[state] = new char[maxKeyCode + 1];
+                Arrays.fill(t[state], KeyEvent.CHAR_UNDEFINED);
+            }
+            t[state][stroke.getKeyCode()] = e.getValue().charValue();
+        }
+        table = t;
+    }
+
+    @Override
+    public char getKeyChar(int keyCode, int modifiers) {
+        char[] row = table[modifierState(modifiers)];
+        if (row == null || keyCode < 0 || keyCode >= row.length) {
+            return KeyEvent.CHAR_UNDEFINED;
+        }
+        return row[keyCode];
+    }
+
+    /**
+     * Folds old-style and extended modifier masks into a table row index,
+     * the same way AWTKeyStroke normalizes them.
+     */
+    @SuppressWarnings("deprecation")
+    static int modifierState(int modifiers) {
+        int state = 0;
+        if ((modifiers & (InputEvent.SHIFT_MASK | InputEvent.SHIFT_DOWN_MASK)) != 0) {
+            state |= STATE_SHIFT;
+        }
+        if ((modifiers & (InputEvent.CTRL_MASK | InputEvent.CTRL_DOWN_MASK)) != 0) {
+            state |= STATE_CTRL;
+        }
+        if ((modifiers & (InputEvent.META_MASK | InputEvent.META_DOWN_MASK)) != 0) {
+            state |= STATE_META;
+        }
+        if ((modifiers & (InputEvent.ALT_MASK | InputEvent.ALT_DOWN_MASK)) != 0) {
+            state |= STATE_ALT;
+        }
+        if ((modifiers & (InputEvent.ALT_GRAPH_MASK | InputEvent.ALT_GRAPH_DOWN_MASK)) != 0) {
+            state |= STATE_ALT_GRAPH;
+        }
+        return state;
+    }
+
     AWTKeyStroke keyStroke(int keyCode, int modifiers) {
         return AWTKeyStroke.getAWTKeyStroke(keyCode, modifiers);
     }
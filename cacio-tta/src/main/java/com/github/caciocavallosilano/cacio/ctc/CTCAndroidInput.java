@@ -1,5 +1,15 @@
 package com.github.caciocavallosilano.cacio.ctc;
 
+import com.github.caciocavallosilano.cacio.peer.managed.FullScreenWindowFactory;
+
+import java.awt.Component;
+import java.awt.KeyboardFocusManager;
+import java.awt.Toolkit;
+import java.awt.event.InputMethodEvent;
+import java.awt.font.TextHitInfo;
+import java.text.AttributedString;
+import java.util.Locale;
+
 public class CTCAndroidInput {
     public static final int EVENT_TYPE_CHAR = 1000;
     // public static final int EVENT_TYPE_CHAR_MODS = 1001;
@@ -16,7 +26,9 @@ public class CTCAndroidInput {
     public static void receiveData(int type, int i1, int i2, int i3, int i4) {
         switch (type) {
             case EVENT_TYPE_CURSOR_POS:
-                mRobotPeer.mouseMove(i1, i2);
+                // The viewer sends device pixels, Cacio works in logical ones.
+                double scale = FullScreenWindowFactory.getUIScale();
+                mRobotPeer.mouseMove((int) (i1 / scale), (int) (i2 / scale));
                 break;
 
             case EVENT_TYPE_KEY:
@@ -39,4 +51,45 @@ public class CTCAndroidInput {
                 break;
         }
     }
+
+    /**
+     * Injects a whole string of committed text (paste, IME commit) at once.
+     * <p>
+     * Components that accept input method text get a single committed
+     * {@link InputMethodEvent}. Everything else gets the KEY_TYPED events
+     * posted back to back, without a round trip per character.
+     *
+     * @param text the committed text
+     */
+    public static void receiveText(String text) {
+        if (text == null || text.isEmpty()) {
+            return;
+        }
+        Component focusOwner = KeyboardFocusManager
+                .getCurrentKeyboardFocusManager().getFocusOwner();
+        if (focusOwner != null && focusOwner.getInputMethodRequests() != null) {
+            InputMethodEvent ev = new InputMethodEvent(focusOwner,
+                    InputMethodEvent.INPUT_METHOD_TEXT_CHANGED,
+                    new AttributedString(text).getIterator(), text.length(),
+                    TextHitInfo.leading(text.length()), null);
+            Toolkit.getDefaultToolkit().getSystemEventQueue().postEvent(ev);
+        } else {
+            mRobotPeer.typeText(text);
+        }
+    }
+
+    /**
+     * Switches the keyboard layout used for key strokes to the one of the
+     * viewer's input method.
+     *
+     * @param languageTag the IETF language tag of the viewer's keyboard,
+     *        e.g. {@code de-DE}
+     */
+    public static void keyboardLocaleChanged(String languageTag) {
+        if (languageTag == null || languageTag.isEmpty()) {
+            return;
+        }
+        KeyStrokeMappingFactory.getInstance()
+                .localeChanged(Locale.forLanguageTag(languageTag));
+    }
 }
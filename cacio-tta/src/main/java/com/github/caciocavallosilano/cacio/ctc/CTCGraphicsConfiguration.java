@@ -73,9 +73,14 @@ public class CTCGraphicsConfiguration extends GraphicsConfiguration {
         return new BufferedImage(model, wr, model.isAlphaPremultiplied(), null);
     }
 
+    /**
+     * Reports the configured UI scale, so that Java2D renders text and
+     * shapes at device resolution while layout stays in logical pixels.
+     */
     @Override
     public AffineTransform getDefaultTransform() {
-        return AffineTransform.getScaleInstance(1, 1);
+        double scale = FullScreenWindowFactory.getUIScale();
+        return AffineTransform.getScaleInstance(scale, scale);
     }
 
     @Override
@@ -185,6 +185,25 @@ public class CTCRobotPeer implements RobotPeer {
         }
     }
 
+    /**
+     * Posts a KEY_TYPED event for every character of the specified text,
+     * sharing one timestamp and modifier state.
+     */
+    void typeText(CharSequence text) {
+        long time = System.currentTimeMillis();
+        int modifiers = currentModifiers;
+        CTCEventSource source = CTCEventSource.getInstance();
+        for (int i = 0; i < text.length(); i++) {
+            EventData ev = new EventData();
+            ev.setSource(CTCScreen.getInstance());
+            ev.setId(KeyEvent.KEY_TYPED);
+            ev.setTime(time);
+            ev.setModifiers(modifiers);
+            ev.setKeyChar(text.charAt(i));
+            source.postEvent(ev);
+        }
+    }
+
     private char getKeyCharFromCodeAndMods(int keyCode, int modifiers) {
         return KeyStrokeMappingFactory.getInstance().getKeyStrokeMapping().getKeyChar(keyCode, modifiers);
     }
@@ -205,8 +224,7 @@ public class CTCRobotPeer implements RobotPeer {
  
     @Override
     public int getRGBPixel(int x, int y) {
-        // TODO Auto-generated method stub
-        return 0;
+        return CTCScreen.getInstance().getRGBPixel(x, y);
     }
 
     @Override
@@ -56,7 +56,9 @@ public class CTCScreen implements PlatformScreen {
     }
 
     private CTCScreen() {
-        Dimension d = FullScreenWindowFactory.getScreenDimension();
+        // The backing buffer holds device pixels, rendering is scaled into
+        // it by the UI scale (see getClippedGraphics()).
+        Dimension d = FullScreenWindowFactory.getDeviceScreenDimension();
         screenBuffer = new BufferedImage(d.width, d.height, BufferedImage.TYPE_INT_ARGB);
     }
 
@@ -80,6 +82,10 @@ public class CTCScreen implements PlatformScreen {
     public Graphics2D getClippedGraphics(Color fg, Color bg, Font f,
             List<Rectangle> clipRects) {
         Graphics2D g2d = (Graphics2D) screenBuffer.getGraphics();
+        double scale = FullScreenWindowFactory.getUIScale();
+        if (scale != 1) {
+            g2d.scale(scale, scale);
+        }
         if (clipRects != null && clipRects.size() > 0) {
             Area a = new Area(getBounds());
             for (Rectangle clip : clipRects) {
@@ -90,21 +96,56 @@ public class CTCScreen implements PlatformScreen {
         return g2d;
     }
 
+    /**
+     * Reads a rectangle of the screen buffer. The bounds are in device
+     * pixels: java.awt.Robot converts logical coordinates through
+     * {@link CTCGraphicsConfiguration#getDefaultTransform()} before calling
+     * the robot peer, and downsamples the result itself for
+     * createScreenCapture(). Pixels outside the buffer, which rounding of
+     * scaled bounds can produce at the right and bottom edges, are returned
+     * as 0.
+     */
     int[] getRGBPixels(Rectangle bounds) {
-        return screenBuffer.getRGB(bounds.x, bounds.y, bounds.width, bounds.height, null, 0, bounds.width);
+        int[] pixels = new int[bounds.width * bounds.height];
+        Rectangle visible = bounds.intersection(
+                new Rectangle(0, 0, screenBuffer.getWidth(), screenBuffer.getHeight()));
+        if (!visible.isEmpty()) {
+            int offset = (visible.y - bounds.y) * bounds.width + (visible.x - bounds.x);
+            screenBuffer.getRGB(visible.x, visible.y, visible.width, visible.height,
+                    pixels, offset, bounds.width);
+        }
+        return pixels;
+    }
+
+    /**
+     * Reads one pixel of the screen buffer at device coordinates, see
+     * {@link #getRGBPixels(Rectangle)}.
+     */
+    int getRGBPixel(int x, int y) {
+        if (x < 0 || y < 0 || x >= screenBuffer.getWidth() || y >= screenBuffer.getHeight()) {
+            return 0;
+        }
+        return screenBuffer.getRGB(x, y);
     }
 
     private static int[] dataBufAux;
+
+    /**
+     * Returns the current screen content in device pixels, that is
+     * {@code FullScreenWindowFactory.getDeviceScreenDimension()} sized.
+     */
     public static int[] getCurrentScreenRGB() {
         if (instance.screenBuffer == null) {
             return null;
         } else {
+            int width = instance.screenBuffer.getWidth();
+            int height = instance.screenBuffer.getHeight();
             if(dataBufAux == null) {
-		dataBufAux=new int[((int) FullScreenWindowFactory.getScreenDimension().getWidth()) * (int) FullScreenWindowFactory.getScreenDimension().getHeight()];
+		dataBufAux=new int[width * height];
 	    }
             instance.screenBuffer.getRaster().getDataElements(0,0,
-                (int) FullScreenWindowFactory.getScreenDimension().getWidth(),
-                (int) FullScreenWindowFactory.getScreenDimension().getHeight(),
+                width,
+                height,
                 dataBufAux);
 
 	    return dataBufAux;
@@ -75,15 +75,12 @@ import static java.awt.event.KeyEvent.VK_Y;
 import static java.awt.event.KeyEvent.VK_Z;
 
 import java.awt.AWTKeyStroke;
-import java.awt.event.KeyEvent;
 import java.util.Map;
 
 class KeyStrokeMappingEN extends AbstractKeyStrokeMapping implements KeyStrokeMapping {
 
-    private Map<AWTKeyStroke, Character> map;
-
     KeyStrokeMappingEN() {
-        map = getDefaultMap();
+        Map<AWTKeyStroke, Character> map = getDefaultMap();
 
         map.put(keyStroke(VK_0, NO_MASK), '0');
         map.put(keyStroke(VK_0, SHIFT_MASK), ')');
@@ -181,17 +178,7 @@ class KeyStrokeMappingEN extends AbstractKeyStrokeMapping implements KeyStrokeMa
         map.put(keyStroke(VK_Z, NO_MASK), 'z');
         map.put(keyStroke(VK_Z, SHIFT_MASK), 'Z');
 
-    }
-
-    @Override
-    public char getKeyChar(int keyCode, int modifiers) {
-        AWTKeyStroke stroke = keyStroke(keyCode, modifiers);
-        Character ch = map.get(stroke);
-        if (ch == null) {
-            return KeyEvent.CHAR_UNDEFINED;
-        } else {
-            return ch.charValue();
-        }
+        compile(map);
     }
 
     
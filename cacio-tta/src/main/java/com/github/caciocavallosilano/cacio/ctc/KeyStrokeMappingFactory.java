@@ -34,12 +34,39 @@ class KeyStrokeMappingFactory {
 
     private Map<String,KeyStrokeMapping> maps = new HashMap<String,KeyStrokeMapping>();
 
+    /**
+     * The mapping of the current keyboard locale. Resolved once and then
+     * only replaced by {@link #localeChanged(Locale)}, so the per-key path
+     * does not query the default locale.
+     */
+    private volatile KeyStrokeMapping activeMapping;
+
     static KeyStrokeMappingFactory getInstance() {
         return instance;
     }
 
     KeyStrokeMapping getKeyStrokeMapping() {
-        String lang = Locale.getDefault().getCountry().toLowerCase();
+        KeyStrokeMapping mapping = activeMapping;
+        if (mapping == null) {
+            mapping = localeChanged(Locale.getDefault());
+        }
+        return mapping;
+    }
+
+    /**
+     * Switches the active keyboard layout. Must be called when the
+     * keyboard locale changes, as there is no notification for
+     * {@link Locale#setDefault(Locale)}.
+     *
+     * @param locale the new keyboard locale
+     *
+     * @return the mapping that is now active
+     */
+    synchronized KeyStrokeMapping localeChanged(Locale locale) {
+        // Keyboard layouts are per country; a bare language tag such as
+        // "de" (common for IME subtypes) falls back to the language.
+        String lang = (locale.getCountry().isEmpty()
+                ? locale.getLanguage() : locale.getCountry()).toLowerCase();
         KeyStrokeMapping mapping = maps.get(lang);
         if (mapping == null) {
             if (lang.equals("de")) {
@@ -49,6 +76,7 @@ class KeyStrokeMappingFactory {
             }
             maps.put(lang, mapping);
         }
+        activeMapping = mapping;
         return mapping;
     }
 }
@@ -24,3 +24,5 @@ include(":app")
 include(":cacio-argent")
 include(":cacio-tta")
 include(":cacio-shared")
+include(":awt-codec")
+include(":awt-bench")